@@ -198,9 +198,8 @@ void IntermediatePolyMesh3DSMax::GetIndexedNormalsFromSmoothingGroups(
     }
   }
 
-  createIndexedArray<Abc::N3f, SortableV3f>(faceIndices, expandedNormals,
-                                            indexedNormals.values,
-                                            indexedNormals.indices);
+  createIndexedArray<Abc::N3f>(faceIndices, expandedNormals,
+                               indexedNormals.values, indexedNormals.indices);
 }
 
 void IntermediatePolyMesh3DSMax::GetIndexedNormalsFromSmoothingGroups(
@@ -227,9 +226,8 @@ void IntermediatePolyMesh3DSMax::GetIndexedNormalsFromSmoothingGroups(
     }
   }
 
-  createIndexedArray<Abc::N3f, SortableV3f>(faceIndices, expandedNormals,
-                                            indexedNormals.values,
-                                            indexedNormals.indices);
+  createIndexedArray<Abc::N3f>(faceIndices, expandedNormals,
+                               indexedNormals.values, indexedNormals.indices);
 }
 
 void IntermediatePolyMesh3DSMax::GetIndexedUVsFromChannel(
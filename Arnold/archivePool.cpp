@@ -0,0 +1,284 @@
+#include "stdafx.h"
+
+#include "archivePool.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/thread/thread.hpp>
+
+sharedArchive::sharedArchive(const std::string &path)
+    : m_path(path),
+      m_opened(false),
+      m_pooled(true),
+      m_ogawa(false),
+      m_refCount(0)
+{
+}
+
+// array samples shared by all the archives, the motion keys of neighbouring
+// nodes and the procedurals instancing the same file read the same samples.
+// Its budget is EXOCORTEX_ALEMBIC_SAMPLE_CACHE_MB megabytes, 512 by default,
+// 0 disables it. It is made by the first archive opened.
+static AbcA::ReadArraySampleCachePtr gSampleCache;
+static bool gSampleCacheCreated = false;
+static boost::mutex gSampleCacheLock;
+
+static AbcA::ReadArraySampleCachePtr getSampleCache()
+{
+  boost::mutex::scoped_lock lock(gSampleCacheLock);
+  if (!gSampleCacheCreated) {
+    gSampleCacheCreated = true;
+
+    size_t megabytes = 512;
+    const char *value = getenv("EXOCORTEX_ALEMBIC_SAMPLE_CACHE_MB");
+    if (value != NULL) {
+      megabytes = (size_t)std::max(0, atoi(value));
+    }
+    if (megabytes > 0) {
+      gSampleCache =
+          Alembic::AbcCoreOgawa::CreateCache(megabytes * 1024 * 1024);
+    }
+  }
+  return gSampleCache;
+}
+
+// one stream per core, so the motion keys of a node and the nodes expanded
+// by different render threads don't wait on each other
+static size_t ogawaNumStreams()
+{
+  const size_t cores = boost::thread::hardware_concurrency();
+  return std::max<size_t>(1, std::min<size_t>(cores, 16));
+}
+
+bool sharedArchive::open()
+{
+  boost::mutex::scoped_lock lock(m_openLock);
+  if (!m_opened) {
+    m_opened = true;
+
+    AbcF::IFactory iFactory;
+    AbcF::IFactory::CoreType oType;
+    iFactory.setOgawaNumStreams(ogawaNumStreams());
+    iFactory.setSampleCache(getSampleCache());
+    m_archive = iFactory.getArchive(m_path, oType);
+
+    // the HDF5 core does not support concurrent readers on the same handle,
+    // such an archive stays private to the procedural that opened it
+    m_ogawa = oType == AbcF::IFactory::kOgawa;
+    if (!m_ogawa) {
+      m_pooled = false;
+    }
+  }
+  return m_archive.valid() && m_archive.getTop().valid();
+}
+
+Abc::IObject sharedArchive::findObject(const std::string &identifier)
+{
+  {
+    boost::shared_lock<boost::shared_mutex> lock(m_indexLock);
+    objectIndex::const_iterator it = m_index.find(identifier);
+    if (it != m_index.end()) {
+      return it->second;
+    }
+  }
+
+  std::vector<std::string> parts;
+  boost::split(parts, identifier, boost::is_any_of("/\\"));
+
+  // walk down from the deepest parent already in the index
+  Abc::IObject object = m_archive.getTop();
+  size_t start = 1;
+  {
+    boost::shared_lock<boost::shared_mutex> lock(m_indexLock);
+    std::string prefix;
+    for (size_t i = 1; i + 1 < parts.size(); i++) {
+      prefix += "/" + parts[i];
+      objectIndex::const_iterator it = m_index.find(prefix);
+      if (it == m_index.end()) {
+        break;
+      }
+      object = it->second;
+      start = i + 1;
+    }
+  }
+
+  // remember the parents as well, siblings are usually looked up next
+  std::vector<std::pair<std::string, Abc::IObject> > found;
+  std::string prefix;
+  for (size_t i = 1; i < start; i++) {
+    prefix += "/" + parts[i];
+  }
+  for (size_t i = start; i < parts.size() && object.valid(); i++) {
+    if (parts[i].empty()) {
+      continue;
+    }
+    object = object.getChild(parts[i]);
+    prefix += "/" + parts[i];
+    if (object.valid()) {
+      found.push_back(std::make_pair(prefix, object));
+    }
+  }
+
+  if (object.valid()) {
+    boost::unique_lock<boost::shared_mutex> lock(m_indexLock);
+    m_index.insert(found.begin(), found.end());
+    m_index[identifier] = object;
+  }
+  return object;
+}
+
+/**
+ * The pool itself, all members are only touched with m_lock held. The lock is
+ * never held while opening or reading a file.
+ */
+class archivePool {
+ public:
+  archivePool() : m_maxIdle(16)
+  {
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.evictions = 0;
+    m_stats.open = 0;
+    m_stats.idle = 0;
+    m_stats.sampleHits = 0;
+    m_stats.sampleMisses = 0;
+    m_stats.sampleBytes = 0;
+  }
+
+  sharedArchivePtr acquire(const std::string &path)
+  {
+    std::string key = path;
+    try {
+      key = boost::filesystem::system_complete(path).string();
+    }
+    catch (boost::filesystem::filesystem_error &) {
+    }
+
+    sharedArchivePtr archive;
+    bool created = false;
+    {
+      boost::mutex::scoped_lock lock(m_lock);
+      archiveMap::iterator it = m_archives.find(key);
+      if (it != m_archives.end()) {
+        archive = it->second;
+        if (archive->m_refCount == 0) {
+          m_idle.remove(archive);
+        }
+        m_stats.hits++;
+      }
+      else {
+        archive.reset(new sharedArchive(key));
+        m_archives[key] = archive;
+        m_stats.misses++;
+        created = true;
+      }
+      archive->m_refCount++;
+    }
+
+    const bool valid = archive->open();
+    if (!valid || !archive->m_pooled) {
+      boost::mutex::scoped_lock lock(m_lock);
+      archiveMap::iterator it = m_archives.find(key);
+      if (it != m_archives.end() && it->second == archive) {
+        m_archives.erase(it);
+      }
+      if (!valid) {
+        archive->m_refCount--;
+        return sharedArchivePtr();
+      }
+      // somebody else opened this non shareable archive first, so open
+      // a private copy
+      if (!created) {
+        archive->m_refCount--;
+        archive.reset(new sharedArchive(key));
+        archive->m_pooled = false;
+        archive->m_refCount = 1;
+        lock.unlock();
+        if (!archive->open()) {
+          return sharedArchivePtr();
+        }
+      }
+    }
+    return archive;
+  }
+
+  void release(sharedArchivePtr &archive)
+  {
+    if (!archive) {
+      return;
+    }
+
+    std::vector<sharedArchivePtr> evicted;
+    {
+      boost::mutex::scoped_lock lock(m_lock);
+      if (--archive->m_refCount == 0 && archive->m_pooled) {
+        m_idle.push_back(archive);
+        trimIdle(evicted);
+      }
+    }
+    archive.reset();
+    // evicted archives are closed here, outside of the pool lock
+  }
+
+  archivePoolStats stats()
+  {
+    boost::mutex::scoped_lock lock(m_lock);
+    archivePoolStats result = m_stats;
+    result.open = m_archives.size();
+    result.idle = m_idle.size();
+
+    Alembic::AbcCoreOgawa::CacheStats cacheStats;
+    AbcA::ReadArraySampleCachePtr cache = getSampleCache();
+    if (cache && Alembic::AbcCoreOgawa::GetCacheStats(cache, cacheStats)) {
+      result.sampleHits = (size_t)cacheStats.hits;
+      result.sampleMisses = (size_t)cacheStats.misses;
+      result.sampleBytes = (size_t)cacheStats.numBytes;
+    }
+    return result;
+  }
+
+  void setMaxIdle(size_t maxIdle)
+  {
+    std::vector<sharedArchivePtr> evicted;
+    boost::mutex::scoped_lock lock(m_lock);
+    m_maxIdle = maxIdle;
+    trimIdle(evicted);
+  }
+
+ private:
+  void trimIdle(std::vector<sharedArchivePtr> &evicted)
+  {
+    while (m_idle.size() > m_maxIdle) {
+      sharedArchivePtr oldest = m_idle.front();
+      m_idle.pop_front();
+      m_archives.erase(oldest->getPath());
+      evicted.push_back(oldest);
+      m_stats.evictions++;
+    }
+  }
+
+  typedef std::map<std::string, sharedArchivePtr> archiveMap;
+
+  boost::mutex m_lock;
+  archiveMap m_archives;
+  std::list<sharedArchivePtr> m_idle;
+  size_t m_maxIdle;
+  archivePoolStats m_stats;
+};
+
+static archivePool gArchivePool;
+
+sharedArchivePtr acquireArchive(const std::string &path)
+{
+  return gArchivePool.acquire(path);
+}
+
+void releaseArchive(sharedArchivePtr &archive)
+{
+  gArchivePool.release(archive);
+}
+
+archivePoolStats getArchivePoolStats() { return gArchivePool.stats(); }
+void setArchivePoolMaxIdle(size_t maxIdle)
+{
+  gArchivePool.setMaxIdle(maxIdle);
+}
@@ -0,0 +1,79 @@
+#ifndef _ARNOLD_ALEMBIC_ARCHIVE_POOL_H_
+#define _ARNOLD_ALEMBIC_ARCHIVE_POOL_H_
+
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "utility.h"
+
+/**
+ * Process-wide pool of read-only archives, shared by all the procedurals
+ * pointing at the same file. Each archive also keeps a full name to IObject
+ * index so the hierarchy is only walked once per file.
+ *
+ * Archives are ref counted by acquireArchive / releaseArchive. Unreferenced
+ * archives stay open in an idle list so sequentially expanded procedurals
+ * don't reopen the file, the least recently released ones get evicted.
+ */
+class sharedArchive {
+ public:
+  sharedArchive(const std::string &path);
+
+  const std::string &getPath() const { return m_path; }
+  Abc::IArchive getArchive() const { return m_archive; }
+
+  // Ogawa archives are opened with several streams and can be read from
+  // multiple threads, HDF5 ones can't
+  bool isOgawa() const { return m_ogawa; }
+
+  // returns the object for a full name like "/xfo/shape", or an invalid
+  // object if it is not part of the archive
+  Abc::IObject findObject(const std::string &identifier);
+
+ private:
+  friend class archivePool;
+
+  bool open();
+
+  typedef boost::unordered_map<std::string, Abc::IObject> objectIndex;
+
+  std::string m_path;
+  Abc::IArchive m_archive;
+
+  boost::mutex m_openLock;
+  bool m_opened;
+  bool m_pooled;
+  bool m_ogawa;
+  int m_refCount;
+
+  boost::shared_mutex m_indexLock;
+  objectIndex m_index;
+};
+
+typedef boost::shared_ptr<sharedArchive> sharedArchivePtr;
+
+// returns NULL if the file is not a valid alembic archive
+sharedArchivePtr acquireArchive(const std::string &path);
+
+// resets the pointer
+void releaseArchive(sharedArchivePtr &archive);
+
+struct archivePoolStats {
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+  size_t open;
+  size_t idle;
+
+  // the array sample cache shared by the pooled archives
+  size_t sampleHits;
+  size_t sampleMisses;
+  size_t sampleBytes;
+};
+
+archivePoolStats getArchivePoolStats();
+
+// maximum number of unreferenced archives kept open, 16 by default
+void setArchivePoolMaxIdle(size_t maxIdle);
+
+#endif
@@ -14,7 +14,9 @@ objectInfo::objectInfo(float in_centroidTime)
       instanceID(-1),
       instanceGroupID(-1),
       instanceCloud(NULL),
-      suffix("_DSO")
+      suffix("_DSO"),
+      deferred(false),
+      hasBounds(false)
 {
 }
 
@@ -49,29 +51,59 @@ std::string getNameFromIdentifier(const std::string &identifier, long id,
   return result;
 }
 
-bool shiftedProcessing(nodeData &nodata, userData *ud)
+void pushObjectInfo(userData *ud, const objectInfo &info)
+{
+  ud->gIObjectIndex.insert(
+      std::make_pair(info.abc.getFullName(), ud->gIObjects.size()));
+  ud->gIObjects.push_back(info);
+}
+
+long findObjectInfo(userData *ud, const std::string &fullName)
+{
+  objectIndexMap::const_iterator it = ud->gIObjectIndex.find(fullName);
+  if (it == ud->gIObjectIndex.end()) {
+    return -1;
+  }
+  return (long)it->second;
+}
+
+void indexInstanceCloud(userData *ud, size_t cloud)
 {
-  const int gInsSize = (int)ud->gInstances.size();
-  std::string objFullName = nodata.object.getFullName();
-  for (size_t j = 0; j < gInsSize; ++j) {
-    instanceCloudInfo &gInst = ud->gInstances[j];
-    const int jInstanceInfoSize = (int)gInst.groupInfos.size();
-    for (size_t k = 0; k < jInstanceInfoSize; ++k) {
-      instanceGroupInfo &gInfo = gInst.groupInfos[k];
-      const int kInfIdSize = (int)gInfo.identifiers.size();
-      for (size_t l = 0; l < kInfIdSize; ++l) {
-        if (gInfo.identifiers[l] == objFullName) {
-          std::map<float, AtNode *>::iterator it =
-              gInfo.nodes[l].find(ud->gCentroidTime);
-          if (it != gInfo.nodes[l].end()) {
-            if (it->second != NULL) {
-              nodata.shaders = AiNodeGetArray(it->second, "shader");
-            }
-          }
-          return true;
-        }
+  std::vector<instanceGroupInfo> &groupInfos = ud->gInstances[cloud].groupInfos;
+  for (size_t k = 0; k < groupInfos.size(); ++k) {
+    const std::vector<std::string> &identifiers = groupInfos[k].identifiers;
+    for (size_t l = 0; l < identifiers.size(); ++l) {
+      std::vector<instanceSlot> &slots = ud->gInstanceSlots[identifiers[l]];
+      // only the first slot of a group is used for a given name
+      if (!slots.empty() && slots.back().cloud == cloud &&
+          slots.back().group == k) {
+        continue;
       }
+      instanceSlot slot;
+      slot.cloud = cloud;
+      slot.group = k;
+      slot.slot = l;
+      slots.push_back(slot);
+    }
+  }
+}
+
+bool shiftedProcessing(nodeData &nodata, userData *ud)
+{
+  instanceSlotMap::const_iterator found =
+      ud->gInstanceSlots.find(nodata.object.getFullName());
+  if (found == ud->gInstanceSlots.end() || found->second.empty()) {
+    return false;
+  }
+
+  const instanceSlot &slot = found->second.front();
+  instanceGroupInfo &gInfo = ud->gInstances[slot.cloud].groupInfos[slot.group];
+  std::map<float, AtNode *>::iterator it =
+      gInfo.nodes[slot.slot].find(ud->gCentroidTime);
+  if (it != gInfo.nodes[slot.slot].end()) {
+    if (it->second != NULL) {
+      nodata.shaders = AiNodeGetArray(it->second, "shader");
     }
   }
-  return false;
+  return true;
 }
@@ -9,6 +9,7 @@
 #define FALSE 0
 #endif
 
+#include "archivePool.h"
 #include "dataUniqueness.h"
 #include "utility.h"
 
@@ -39,6 +40,10 @@ struct instanceCloudInfo {
   std::vector<Alembic::Abc::FloatArraySamplePtr> time;
   float timeAlpha;
   std::vector<instanceGroupInfo> groupInfos;
+
+  // per particle matrices, numParticles * motion keys
+  size_t numParticles;
+  std::vector<Alembic::Abc::M44f> particleMatrices;
 };
 
 struct objectInfo {
@@ -52,18 +57,42 @@ struct objectInfo {
   instanceCloudInfo* instanceCloud;
   std::string suffix;
 
+  // lazy mode, expanded by a child procedural
+  bool deferred;
+  bool hasBounds;
+  Alembic::Abc::Box3d bounds;
+
   objectInfo(float in_centroidTime);
 };
 
+// location of a master node inside ud->gInstances
+struct instanceSlot {
+  size_t cloud;
+  size_t group;
+  size_t slot;
+};
+
+typedef boost::unordered_map<std::string, size_t> objectIndexMap;
+typedef boost::unordered_map<std::string, std::vector<instanceSlot> >
+    instanceSlotMap;
+
 struct userData {
   float gCentroidTime;
-  char* gDataString;
+  std::string gDataString;
+  std::string gDataTokens;  // gDataString without the identifier
+  std::string gDsoPath;
+  bool gLazy;
+  sharedArchivePtr gArchive;
+  sharedArchivePtr gInstancesArchive;
+  bool gParallelReads;  // both archives can be read from multiple threads
   std::string gCurvesMode;
   std::string gPointsMode;
   AtArray* gProcShaders;
   AtArray* gProcDispMap;
   std::vector<objectInfo> gIObjects;
-  std::vector<instanceCloudInfo> gInstances;
+  objectIndexMap gIObjectIndex;  // full name -> first entry of gIObjects
+  std::deque<instanceCloudInfo> gInstances;  // stable addresses
+  instanceSlotMap gInstanceSlots;  // full name -> all the slots it is used in
   std::vector<float> gMbKeys;
   float gTime;
   float gCurrTime;
@@ -104,6 +133,15 @@ AtVoid ReadParameterValue(AtNode* curve_node, FILE* fp,
 std::string getNameFromIdentifier(const std::string& identifier, long id = -1,
                                   long group = -1);
 
+// appends to ud->gIObjects and keeps ud->gIObjectIndex up to date
+void pushObjectInfo(userData* ud, const objectInfo& info);
+
+// returns the index of the first ud->gIObjects entry for the full name, or -1
+long findObjectInfo(userData* ud, const std::string& fullName);
+
+// registers all the slots of ud->gInstances[cloud] in ud->gInstanceSlots
+void indexInstanceCloud(userData* ud, size_t cloud);
+
 // executed only if (nodata.shifted), same code in multiple places, in a single
 // unique function!
 // return true if a shader has been assigned!
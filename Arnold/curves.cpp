@@ -1,6 +1,7 @@
 #include "stdafx.h"
 
 #include "curves.h"
+#include "samplePrefetch.h"
 
 AtNode *createCurvesNode(nodeData &nodata, userData *ud,
                          std::vector<float> &samples, int i)
@@ -23,14 +24,27 @@ AtNode *createCurvesNode(nodeData &nodata, userData *ud,
   AtULong posOffset = 0;
   size_t totalNumPoints = 0;
   size_t totalNumPositions = 0;
+  // read the samples of all the motion keys at once
+  std::vector<SampleInfo> sampleInfos(minNumSamples);
+  samplePrefetch<Alembic::AbcGeom::ICurvesSchema> prefetch(
+      typedObject.getSchema(), ud->gParallelReads);
   for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
-    SampleInfo sampleInfo = getSampleInfo(
+    sampleInfos[sampleIndex] = getSampleInfo(
         samples[sampleIndex], typedObject.getSchema().getTimeSampling(),
         typedObject.getSchema().getNumSamples());
+    prefetch.request(sampleInfos[sampleIndex].floorIndex);
+    if (sampleInfos[sampleIndex].alpha > sampleTolerance) {
+      prefetch.request(sampleInfos[sampleIndex].ceilIndex);
+    }
+  }
+  prefetch.fetch();
+
+  for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
+    SampleInfo &sampleInfo = sampleInfos[sampleIndex];
 
     // get the floor sample
-    Alembic::AbcGeom::ICurvesSchema::Sample sample;
-    typedObject.getSchema().get(sample, sampleInfo.floorIndex);
+    const Alembic::AbcGeom::ICurvesSchema::Sample &sample =
+        prefetch.get(sampleInfo.floorIndex);
 
     // access the num points
     Alembic::Abc::Int32ArraySamplePtr abcNumPoints =
@@ -128,9 +142,8 @@ AtNode *createCurvesNode(nodeData &nodata, userData *ud,
     // if we have to interpolate
     bool done = false;
     if (sampleInfo.alpha > sampleTolerance) {
-      Alembic::AbcGeom::ICurvesSchema::Sample sample2;
-      typedObject.getSchema().get(sample2, sampleInfo.ceilIndex);
-      Alembic::Abc::P3fArraySamplePtr abcPos2 = sample2.getPositions();
+      Alembic::Abc::P3fArraySamplePtr abcPos2 =
+          prefetch.get(sampleInfo.ceilIndex).getPositions();
       float alpha = (float)sampleInfo.alpha;
       float ialpha = 1.0f - alpha;
       size_t offset = 0;
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+
+#include "deferred.h"
+
+#include <ImathBoxAlgo.h>
+
+// blends the local matrix of a transform at the given time
+static Alembic::Abc::M44d getXformMatrix(Alembic::AbcGeom::IXform &xform,
+                                         float time)
+{
+  SampleInfo sampleInfo =
+      getSampleInfo(time, xform.getSchema().getTimeSampling(),
+                    xform.getSchema().getNumSamples());
+
+  Alembic::AbcGeom::XformSample sample;
+  xform.getSchema().get(sample, sampleInfo.floorIndex);
+  Alembic::Abc::M44d abcMatrix = sample.getMatrix();
+  if (sampleInfo.alpha >= sampleTolerance) {
+    xform.getSchema().get(sample, sampleInfo.ceilIndex);
+    Alembic::Abc::M44d ceilAbcMatrix = sample.getMatrix();
+    abcMatrix = (1.0 - sampleInfo.alpha) * abcMatrix +
+                sampleInfo.alpha * ceilAbcMatrix;
+  }
+  return abcMatrix;
+}
+
+// returns an empty box if the archive doesn't store the bounds
+static Alembic::Abc::Box3d getBounds(Alembic::Abc::IBox3dProperty prop,
+                                     float time)
+{
+  Alembic::Abc::Box3d bounds;
+  if (!prop.valid() || prop.getNumSamples() == 0) {
+    return bounds;
+  }
+
+  SampleInfo sampleInfo = getSampleInfo(time, prop.getTimeSampling(),
+                                        prop.getNumSamples());
+  bounds = prop.getValue(sampleInfo.floorIndex);
+  if (sampleInfo.alpha >= sampleTolerance) {
+    bounds.extendBy(prop.getValue(sampleInfo.ceilIndex));
+  }
+  return bounds;
+}
+
+// bounds of the child in the space of its parent, over all motion keys. Shapes
+// use their .selfBnds, transforms their .childBnds moved by their own matrix.
+static bool getDeferredBounds(userData *ud, Alembic::Abc::IObject &child,
+                              Alembic::Abc::Box3d &bounds)
+{
+  bounds.makeEmpty();
+  for (size_t j = 0; j < ud->gMbKeys.size(); ++j) {
+    const float time = ud->gMbKeys[j];
+    Alembic::Abc::Box3d keyBounds;
+    if (Alembic::AbcGeom::IXform::matches(child.getMetaData())) {
+      Alembic::AbcGeom::IXform xform(child, Alembic::Abc::kWrapExisting);
+      keyBounds = getBounds(xform.getSchema().getChildBoundsProperty(), time);
+      if (!keyBounds.isEmpty() && xform.getSchema().getNumSamples() > 0) {
+        keyBounds = Imath::transform(keyBounds, getXformMatrix(xform, time));
+      }
+    }
+    else if (Alembic::AbcGeom::IGeomBaseObject::matches(child.getMetaData())) {
+      Alembic::AbcGeom::IGeomBaseObject geom(child,
+                                             Alembic::Abc::kWrapExisting);
+      keyBounds = getBounds(geom.getSchema().getSelfBoundsProperty(), time);
+    }
+
+    if (keyBounds.isEmpty()) {
+      return false;
+    }
+    bounds.extendBy(keyBounds);
+  }
+  return !bounds.isEmpty();
+}
+
+void deferChildren(userData *ud, Alembic::Abc::IObject &object)
+{
+  for (size_t j = 0; j < object.getNumChildren(); j++) {
+    objectInfo info(ud->gCentroidTime);
+    info.abc = object.getChild(j);
+    info.deferred = true;
+    info.hasBounds = getDeferredBounds(ud, info.abc, info.bounds);
+    pushObjectInfo(ud, info);
+  }
+}
+
+// the child procedural gets the same settings as this one
+static void copyProceduralSettings(AtNode *procNode, userData *ud)
+{
+  if (ud->gProcShaders != NULL) {
+    AiNodeSetArray(procNode, "shader", AiArrayCopy(ud->gProcShaders));
+  }
+
+  if (ud->has_subdiv_settings) {
+    AiNodeDeclare(procNode, "subdiv_type", "constant STRING");
+    AiNodeDeclare(procNode, "subdiv_iterations", "constant INT");
+    AiNodeDeclare(procNode, "subdiv_pixel_error", "constant FLOAT");
+    AiNodeDeclare(procNode, "subdiv_dicing_camera", "constant STRING");
+    AiNodeSetStr(procNode, "subdiv_type", ud->subdiv_type.c_str());
+    AiNodeSetInt(procNode, "subdiv_iterations", ud->subdiv_iterations);
+    AiNodeSetFlt(procNode, "subdiv_pixel_error", ud->subdiv_pixel_error);
+    AiNodeSetStr(procNode, "subdiv_dicing_camera",
+                 ud->subdiv_dicing_camera.c_str());
+  }
+
+  if (ud->has_disp_settings) {
+    AiNodeDeclare(procNode, "disp_map", "constant ARRAY NODE");
+    AiNodeDeclare(procNode, "disp_zero_value", "constant FLOAT");
+    AiNodeDeclare(procNode, "disp_height", "constant FLOAT");
+    AiNodeDeclare(procNode, "disp_autobump", "constant BOOL");
+    AiNodeDeclare(procNode, "disp_padding", "constant FLOAT");
+    if (ud->gProcDispMap != NULL) {
+      AiNodeSetArray(procNode, "disp_map", AiArrayCopy(ud->gProcDispMap));
+    }
+    AiNodeSetFlt(procNode, "disp_zero_value", ud->disp_zero_value);
+    AiNodeSetFlt(procNode, "disp_height", ud->disp_height);
+    AiNodeSetBool(procNode, "disp_autobump", ud->disp_autobump);
+    AiNodeSetFlt(procNode, "disp_padding", ud->disp_padding);
+  }
+}
+
+AtNode *createDeferredNode(nodeData &nodata, userData *ud, int i)
+{
+  const objectInfo &info = ud->gIObjects[i];
+  const std::string &identifier = info.abc.getFullName();
+
+  AtNode *procNode = AiNode("procedural");
+  AiNodeSetStr(procNode, "name",
+               (getNameFromIdentifier(identifier) + "_PROC").c_str());
+  AiNodeSetStr(procNode, "dso", ud->gDsoPath.c_str());
+  AiNodeSetStr(procNode, "data",
+               (ud->gDataTokens + "&identifier=" + identifier).c_str());
+
+  if (info.hasBounds) {
+    const Alembic::Abc::Box3d &bounds = info.bounds;
+    AiNodeSetPnt(procNode, "min", (float)bounds.min.x, (float)bounds.min.y,
+                 (float)bounds.min.z);
+    AiNodeSetPnt(procNode, "max", (float)bounds.max.x, (float)bounds.max.y,
+                 (float)bounds.max.z);
+  }
+  else {
+    // without bounds arnold can't defer it
+    AiNodeSetBool(procNode, "load_at_init", TRUE);
+  }
+
+  // the shapes of the child procedural are relative to our object, so its
+  // matrix is our object's transform
+  Alembic::Abc::IObject parent = info.abc.getParent();
+  if (Alembic::AbcGeom::IXform::matches(parent.getMetaData())) {
+    Alembic::AbcGeom::IXform parentXform(parent, Alembic::Abc::kWrapExisting);
+    if (parentXform.getSchema().getNumSamples() > 0) {
+      AtArray *matrices =
+          AiArrayAllocate(1, (AtInt)nodata.samples.size(), AI_TYPE_MATRIX);
+      for (size_t sampleIndex = 0; sampleIndex < nodata.samples.size();
+           ++sampleIndex) {
+        Alembic::Abc::M44d abcMatrix =
+            getXformMatrix(parentXform, nodata.samples[sampleIndex]);
+        AtMatrix matrix;
+        for (size_t row = 0; row < 4; ++row)
+          for (size_t col = 0; col < 4; ++col) {
+            matrix[row][col] = (AtFloat)abcMatrix[row][col];
+          }
+        AiArraySetMtx(matrices, (AtULong)sampleIndex, matrix);
+      }
+      AiNodeSetArray(procNode, "matrix", matrices);
+    }
+  }
+
+  copyProceduralSettings(procNode, ud);
+  return procNode;
+}
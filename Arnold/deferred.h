@@ -0,0 +1,12 @@
+#ifndef _ARNOLD_ALEMBIC_DEFERRED_H_
+#define _ARNOLD_ALEMBIC_DEFERRED_H_
+
+#include "common.h"
+
+// lazy mode: queues one child procedural per child of the object instead of
+// expanding the whole subtree, Arnold only loads them when their box is hit
+void deferChildren(userData *ud, Alembic::Abc::IObject &object);
+
+AtNode *createDeferredNode(nodeData &nodata, userData *ud, int i);
+
+#endif
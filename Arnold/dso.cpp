@@ -3,29 +3,26 @@
 #include "CommonRegex.h"
 #include "common.h"
 #include "curves.h"
+#include "deferred.h"
 #include "instance.h"
 #include "nurbs.h"
 #include "points.h"
 #include "polyMesh.h"
 
-boost::mutex gGlobalLock;
-
-#define GLOBAL_LOCK boost::mutex::scoped_lock writeLock(gGlobalLock);
-
-std::map<std::string, std::string> gUsedArchives;
+// All procedural state lives in its userData, so Arnold is free to run Init and
+// GetNode of different procedurals in parallel. The only shared state is the
+// archive pool (see archivePool.h), its lock is held for the lookup only and
+// never while reading from an archive.
 
 static int Init(AtNode *mynode, void **user_ptr)
 {
-  GLOBAL_LOCK;
-
   userData *ud = new userData();
   *user_ptr = ud;
   ud->gProcShaders = NULL;
   ud->gProcDispMap = NULL;
 
-  const std::string strDataString =
-      EnvVariables::replace(AiNodeGetStr(mynode, "data"));
-  ud->gDataString = (char *)strDataString.c_str();
+  ud->gDataString = EnvVariables::replace(AiNodeGetStr(mynode, "data"));
+  ud->gDsoPath = AiNodeGetStr(mynode, "dso");
   ud->gProcShaders = AiArrayCopy(AiNodeGetArray(mynode, "shader"));
 
   ud->has_subdiv_settings =
@@ -56,9 +53,11 @@ static int Init(AtNode *mynode, void **user_ptr)
   ud->gCurvesMode = "ribbon";
   ud->gPointsMode = "";
   ud->gMbKeys.clear();
+  ud->gLazy = false;
+  ud->gDataTokens.clear();
 
   // check the data string
-  std::string completeStr(ud->gDataString);
+  const std::string &completeStr = ud->gDataString;
   if (completeStr.length() == 0) {
     AiMsgError("[ExocortexAlembicArnold] No data string specified.");
     return NULL;
@@ -92,6 +91,7 @@ static int Init(AtNode *mynode, void **user_ptr)
     }
     else if (token[0] == "identifier") {
       identifier = token[1];
+      continue;
     }
     else if (token[0] == "time") {
       ud->gTime = (float)atof(token[1].c_str());
@@ -113,12 +113,21 @@ static int Init(AtNode *mynode, void **user_ptr)
         ud->gMbKeys[j] = (float)atof(sampleTimes[j].c_str());
       }
     }
+    else if (token[0] == "lazy") {
+      ud->gLazy = atoi(token[1].c_str()) != 0;
+    }
     else {
       AiMsgError(
           "[ExocortexAlembicArnold] Invalid dsodata token name '%s' specified!",
           token[0].c_str());
       return NULL;
     }
+
+    // the child procedurals of the lazy mode get the same tokens
+    if (!ud->gDataTokens.empty()) {
+      ud->gDataTokens += "&";
+    }
+    ud->gDataTokens += nameValuePairs[i];
   }
 
   // compute the central time
@@ -134,23 +143,23 @@ static int Init(AtNode *mynode, void **user_ptr)
   // check if we have all important values
   if (paths[0].length() == 0) {
     AiMsgError("[ExocortexAlembicArnold] path token not specified in '%s'.",
-               ud->gDataString);
+               ud->gDataString.c_str());
     return NULL;
   }
   if (identifier.length() == 0) {
     AiMsgError(
         "[ExocortexAlembicArnold] identifier token not specified in '%s'.",
-        ud->gDataString);
+        ud->gDataString.c_str());
     return NULL;
   }
   if (ud->gTime == FLT_MAX) {
     AiMsgError("[ExocortexAlembicArnold] time token not specified in '%s'.",
-               ud->gDataString);
+               ud->gDataString.c_str());
     return NULL;
   }
   if (ud->gCurrTime == FLT_MAX) {
     AiMsgError("[ExocortexAlembicArnold] currtime token not specified in '%s'.",
-               ud->gDataString);
+               ud->gDataString.c_str());
     return NULL;
   }
   if (ud->gMbKeys.size() == 0) {
@@ -255,7 +264,7 @@ static int Init(AtNode *mynode, void **user_ptr)
   AiMsgDebug("[ExocortexAlembicArnold] path used: %s", paths[0].c_str());
   AiMsgDebug("[ExocortexAlembicArnold] identifier used: %s",
              identifier.c_str());
-  AiMsgDebug("[ExocortexAlembicArnold] time used: %f", time);
+  AiMsgDebug("[ExocortexAlembicArnold] time used: %f", ud->gTime);
 
   // now let's test if the archive exists
   FILE *file = fopen(paths[0].c_str(), "rb");
@@ -279,38 +288,42 @@ static int Init(AtNode *mynode, void **user_ptr)
 
   // open the archive
   // ESS_LOG_INFO(paths[0].c_str());
-  AbcF::IFactory iFactory;
-  AbcF::IFactory::CoreType oType;
-  Abc::IArchive archive(iFactory.getArchive(paths[0], oType));
-  if (!archive.getTop().valid()) {
+  ud->gArchive = acquireArchive(paths[0]);
+  if (!ud->gArchive) {
     AiMsgError(
         "[ExocortexAlembicArnold] Not a valid Alembic data stream.  Path: %s",
         paths[0].c_str());
     return NULL;
   }
   // ESS_LOG_INFO(paths[1].c_str());
-    Abc::IArchive instancesArchive(iFactory.getArchive(paths[1], oType));
-  if (!instancesArchive.getTop().valid()) {
+  ud->gInstancesArchive = acquireArchive(paths[1]);
+  if (!ud->gInstancesArchive) {
     AiMsgError(
         "[ExocortexAlembicArnold] Not a valid Alembic data stream.  Path: %s",
         paths[1].c_str());
     return NULL;
   }
 
+  ud->gParallelReads =
+      ud->gArchive->isOgawa() && ud->gInstancesArchive->isOgawa();
+
   std::vector<std::string> parts;
   boost::split(parts, identifier, boost::is_any_of("/\\"));
   ud->proceduralDepth = (int)(parts.size() - 2);
 
-  // recurse to find the object
-  Alembic::Abc::IObject object = archive.getTop();
-  for (size_t i = 1; i < parts.size(); i++) {
-    Alembic::Abc::IObject child(object, parts[i]);
-    object = child;
-    if (!object) {
-      AiMsgError("[ExocortexAlembicArnold] Cannot find object '%s'.",
-                 identifier.c_str());
-      return NULL;
-    }
+  // find the object through the archive's name index
+  Alembic::Abc::IObject object = ud->gArchive->findObject(identifier);
+  if (!object) {
+    AiMsgError("[ExocortexAlembicArnold] Cannot find object '%s'.",
+               identifier.c_str());
+    return NULL;
+  }
+
+  // in lazy mode a transform only gets a bounding box procedural per child,
+  // each of them expands its own subtree once a ray hits its box
+  if (ud->gLazy && Alembic::AbcGeom::IXform::matches(object.getMetaData())) {
+    deferChildren(ud, object);
+    return TRUE;
   }
 
   // push all objects to process into the static list
@@ -355,12 +368,12 @@ static int Init(AtNode *mynode, void **user_ptr)
 
       objectInfo info(ud->gCentroidTime);
       info.abc = objects[i];
-      ud->gIObjects.push_back(info);
+      pushObjectInfo(ud, info);
     }
     else {
       objectInfo info(ud->gCentroidTime);
       info.abc = objects[i];
-      ud->gIObjects.push_back(info);
+      pushObjectInfo(ud, info);
     }
   }
 
@@ -407,21 +420,19 @@ static int Init(AtNode *mynode, void **user_ptr)
 
             // first, we need to figure out if this is a transform
             bool found = false;
-            for (size_t k = 0; k < ud->gIObjects.size(); k++) {
-              if (ud->gIObjects[k].abc.getFullName() == identifier) {
-                // if we find the object in our export list, it is not a
-                // transform!
-                // we don't push matrices, so that the transform is used without
-                // an offset.
-                // furthermore we push
-                groupInfo.identifiers.push_back(identifier);
-                groupInfo.objects.push_back(ud->gIObjects[k].abc);
-                groupInfo.nodes.push_back(std::map<float, AtNode *>());
-                groupInfo.nodes[groupInfo.nodes.size() - 1].insert(
-                    std::pair<float, AtNode *>(ud->gCentroidTime, NULL));
-                found = true;
-                break;
-              }
+            const long objIndex = findObjectInfo(ud, identifier);
+            if (objIndex >= 0) {
+              // if we find the object in our export list, it is not a
+              // transform!
+              // we don't push matrices, so that the transform is used without
+              // an offset.
+              // furthermore we push
+              groupInfo.identifiers.push_back(identifier);
+              groupInfo.objects.push_back(ud->gIObjects[objIndex].abc);
+              groupInfo.nodes.push_back(std::map<float, AtNode *>());
+              groupInfo.nodes[groupInfo.nodes.size() - 1].insert(
+                  std::pair<float, AtNode *>(ud->gCentroidTime, NULL));
+              found = true;
             }
             // only do this search if we don't require time shifting
             AtNode *masterNode = NULL;
@@ -430,23 +441,11 @@ static int Init(AtNode *mynode, void **user_ptr)
               // it in Arnold
               // as an exported node. so we will search in the alembic file for
               // it
-              std::vector<std::string> parts;
-              boost::split(parts, identifier, boost::is_any_of("/\\"));
-
-              // recurse to find the object
               objectInfo info(ud->gCentroidTime);
               info.hide = true;
-              info.abc = instancesArchive.getTop();
+              info.abc = ud->gInstancesArchive->findObject(identifier);
               info.suffix = "_INSTANCE";
-              found = true;
-              for (size_t k = 1; k < parts.size(); k++) {
-                Alembic::Abc::IObject child(info.abc, parts[k]);
-                info.abc = child;
-                if (!info.abc) {
-                  found = false;
-                  break;
-                }
-              }
+              found = info.abc.valid();
               if (found) {
                 // if this is an alembic transform, then we need to build
                 // exports for every
@@ -467,25 +466,19 @@ static int Init(AtNode *mynode, void **user_ptr)
                     else {
                       // check if we already exported this object
                       // and push it to the export list if we didn't
-                      bool nodeFound = false;
                       masterNode = AiNodeLookUpByName(
                           (getNameFromIdentifier(child.getFullName()) + "_DSO")
                               .c_str());
                       if (!masterNode)
                         masterNode = AiNodeLookUpByName(
                             getNameFromIdentifier(child.getFullName()).c_str());
-                      for (size_t l = 0; l < ud->gIObjects.size(); l++) {
-                        if (ud->gIObjects[l].abc.getFullName() ==
-                            child.getFullName()) {
-                          nodeFound = true;
-                          break;
-                        }
-                      }
+                      const bool nodeFound =
+                          findObjectInfo(ud, child.getFullName()) >= 0;
                       if (!nodeFound && masterNode == NULL) {
                         objectInfo childInfo(ud->gCentroidTime);
                         childInfo.hide = true;
                         childInfo.abc = child;
-                        ud->gIObjects.push_back(childInfo);
+                        pushObjectInfo(ud, childInfo);
                       }
 
                       // push this to our group info
@@ -508,7 +501,7 @@ static int Init(AtNode *mynode, void **user_ptr)
                 else {
                   // just push it for the export
                   if (masterNode == NULL) {
-                    ud->gIObjects.push_back(info);
+                    pushObjectInfo(ud, info);
                   }
 
                   // also update our groupInfo
@@ -739,12 +732,10 @@ static int Init(AtNode *mynode, void **user_ptr)
                   Alembic::Abc::IObject abcMasterObject;
                   objectInfo objInfo(ud->gCentroidTime);
                   objInfo.hide = true;
-                  for (size_t k = 0; k < ud->gIObjects.size(); k++) {
-                    if (ud->gIObjects[k].abc.getFullName() ==
-                        groupInfo->identifiers[g]) {
-                      objInfo.abc = ud->gIObjects[k].abc;
-                      break;
-                    }
+                  const long objIndex =
+                      findObjectInfo(ud, groupInfo->identifiers[g]);
+                  if (objIndex >= 0) {
+                    objInfo.abc = ud->gIObjects[objIndex].abc;
                   }
                   if (!objInfo.abc.valid() && groupInfo->objects[g].valid()) {
                     objInfo.abc = groupInfo->objects[g];
@@ -759,7 +750,7 @@ static int Init(AtNode *mynode, void **user_ptr)
 
                   // push it to the map. This way we can ensure to export it!
                   objInfo.centroidTime = centroidTime;
-                  ud->gIObjects.push_back(objInfo);
+                  pushObjectInfo(ud, objInfo);
 
                   groupInfo->nodes[g].insert(
                       std::pair<float, AtNode *>(centroidTime, NULL));
@@ -769,9 +760,12 @@ static int Init(AtNode *mynode, void **user_ptr)
           }
 
           ud->gInstances.push_back(cloudInfo);
+          indexInstanceCloud(ud, ud->gInstances.size() - 1);
+          computeInstanceMatrices(ud, ud->gInstances.back(), typedObject);
 
           // now let's get the number of position of the first sample
           // and create an instance export for that one
+          const size_t firstParticle = ud->gIObjects.size();
           for (size_t j = 0; j < cloudInfo.pos[0]->size(); j++) {
             objectInfo objInfo(ud->gCentroidTime);
             objInfo.abc = objects[i];
@@ -787,6 +781,11 @@ static int Init(AtNode *mynode, void **user_ptr)
               ud->gIObjects.push_back(objInfo);
             }
           }
+          // all the particles share the cloud's name, index the first one
+          if (ud->gIObjects.size() > firstParticle) {
+            ud->gIObjectIndex.insert(
+                std::make_pair(objects[i].getFullName(), firstParticle));
+          }
         }
       }
     }
@@ -797,13 +796,26 @@ static int Init(AtNode *mynode, void **user_ptr)
 // All done, deallocate stuff
 static int Cleanup(void *user_ptr)
 {
-  GLOBAL_LOCK;
   userData *ud = (userData *)user_ptr;
 
   ud->gIObjects.clear();
+  ud->gIObjectIndex.clear();
   ud->gInstances.clear();
+  ud->gInstanceSlots.clear();
   ud->gMbKeys.clear();
 
+  // the objects hold on to the archive, so release it last
+  releaseArchive(ud->gArchive);
+  releaseArchive(ud->gInstancesArchive);
+
+  archivePoolStats stats = getArchivePoolStats();
+  AiMsgDebug(
+      "[ExocortexAlembicArnold] archive pool: %d hits, %d misses, %d "
+      "evictions, %d open, %d idle, samples: %d hits, %d misses, %d MB",
+      (int)stats.hits, (int)stats.misses, (int)stats.evictions,
+      (int)stats.open, (int)stats.idle, (int)stats.sampleHits,
+      (int)stats.sampleMisses, (int)(stats.sampleBytes >> 20));
+
   delete (ud);
   return TRUE;
 }
@@ -811,8 +823,6 @@ static int Cleanup(void *user_ptr)
 // Get number of nodes
 static int NumNodes(void *user_ptr)
 {
-  GLOBAL_LOCK;
-
   userData *ud = (userData *)user_ptr;
   int size = (int)ud->gIObjects.size();
   return size;
@@ -821,7 +831,6 @@ static int NumNodes(void *user_ptr)
 // Get the i_th node
 static AtNode *GetNode(void *user_ptr, int i)
 {
-  GLOBAL_LOCK;
   userData *ud = (userData *)user_ptr;
   // check if this is a known object
   if (i >= (int)ud->gIObjects.size()) {
@@ -844,6 +853,10 @@ static AtNode *GetNode(void *user_ptr, int i)
   // create the resulting node
   AtNode *shapeNode = NULL;
 
+  if (ud->gIObjects[i].deferred) {
+    return createDeferredNode(nodata, ud, i);
+  }
+
   // now check if this is supposed to be an instance
   if (ud->gIObjects[i].instanceID > -1) {
     return createInstanceNode(nodata, ud, i);
@@ -1010,23 +1023,18 @@ static AtNode *GetNode(void *user_ptr, int i)
   ud->gIObjects[i].node = shapeNode;
 
   // now update the instance maps
-  const size_t gInstSize = ud->gInstances.size();
-  const std::string &objFullName = nodata.object.getFullName();
-  for (size_t j = 0; j < gInstSize; ++j) {
-    std::vector<instanceGroupInfo> &gInstGrpInfo = ud->gInstances[j].groupInfos;
-    const size_t grpInfoSize = gInstGrpInfo.size();
-    for (size_t k = 0; k < grpInfoSize; ++k) {
-      std::vector<std::string> gInstGrpIds = gInstGrpInfo[k].identifiers;
-      const size_t idSize = gInstGrpIds.size();
-      for (size_t l = 0; l < idSize; ++l) {
-        if (gInstGrpIds[l] == objFullName) {
-          std::map<float, AtNode *>::iterator it =
-              gInstGrpInfo[k].nodes[l].find(ud->gIObjects[i].centroidTime);
-          if (it != gInstGrpInfo[k].nodes[l].end()) {
-            it->second = shapeNode;
-          }
-          break;
-        }
+  instanceSlotMap::const_iterator found =
+      ud->gInstanceSlots.find(nodata.object.getFullName());
+  if (found != ud->gInstanceSlots.end()) {
+    const std::vector<instanceSlot> &slots = found->second;
+    for (size_t j = 0; j < slots.size(); ++j) {
+      std::map<float, AtNode *> &nodes =
+          ud->gInstances[slots[j].cloud].groupInfos[slots[j].group]
+              .nodes[slots[j].slot];
+      std::map<float, AtNode *>::iterator it =
+          nodes.find(ud->gIObjects[i].centroidTime);
+      if (it != nodes.end()) {
+        it->second = shapeNode;
       }
     }
   }
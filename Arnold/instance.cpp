@@ -2,11 +2,11 @@
 
 #include "instance.h"
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 AtNode *createInstanceNode(nodeData &nodata, userData *ud, int i)
 {
-  Alembic::AbcGeom::IPoints typedObject(ud->gIObjects[i].abc,
-                                        Alembic::Abc::kWrapExisting);
-
   instanceCloudInfo *info = ud->gIObjects[i].instanceCloud;
 
   // check that we have the masternode
@@ -77,107 +77,15 @@ AtNode *createInstanceNode(nodeData &nodata, userData *ud, int i)
     AiNodeSetRGBA(shapeNode, "Color", color.r, color.g, color.b, color.a);
   }
 
-  // now let's take care of the transform
-  AtArray *matrices =
-      AiArrayAllocate(1, (AtInt)ud->gMbKeys.size(), AI_TYPE_MATRIX);
-  for (size_t j = 0; j < ud->gMbKeys.size(); ++j) {
-    SampleInfo sampleInfo =
-        getSampleInfo(ud->gMbKeys[j], typedObject.getSchema().getTimeSampling(),
-                      typedObject.getSchema().getNumSamples());
-
-    Alembic::Abc::M44f matrixAbc;
-    matrixAbc.makeIdentity();
-    const size_t floorIndex = j << 1;
-    const size_t ceilIndex = floorIndex + 1;
-
-    // apply translation
-    if (info->pos[floorIndex]->size() == info->pos[ceilIndex]->size()) {
-      matrixAbc.setTranslation(
-          float(1.0 - sampleInfo.alpha) *
-              info->pos[floorIndex]
-                  ->get()[id < info->pos[floorIndex]->size()
-                              ? id
-                              : info->pos[floorIndex]->size() - 1] +
-          float(sampleInfo.alpha) *
-              info->pos[ceilIndex]
-                  ->get()[id < info->pos[ceilIndex]->size()
-                              ? id
-                              : info->pos[ceilIndex]->size() - 1]);
-    }
-    else {
-      const float timeAlpha = getTimeOffsetFromObject(typedObject, sampleInfo);
-
-      matrixAbc.setTranslation(
-          info->pos[floorIndex]
-              ->get()[id < info->pos[floorIndex]->size()
-                          ? id
-                          : info->pos[floorIndex]->size() - 1] +
-          info->vel[floorIndex]
-                  ->get()[id < info->vel[floorIndex]->size()
-                              ? id
-                              : info->vel[floorIndex]->size() - 1] *
-              timeAlpha);
-    }
-
-    // now take care of rotation
-    if (info->rot.size() == ud->gMbKeys.size()) {
-      Alembic::Abc::Quatf rotAbc =
-          info->rot[j]
-              ->get()[id < info->rot[j]->size() ? id
-                                                : info->rot[j]->size() - 1];
-      if (info->ang.size() == ud->gMbKeys.size() && sampleInfo.alpha > 0.0) {
-        Alembic::Abc::Quatf angAbc =
-            info->ang[j]
-                ->get()[id < info->ang[j]->size() ? id
-                                                  : info->ang[j]->size() - 1] *
-            (float)sampleInfo.alpha;
-        if (angAbc.axis().length2() != 0.0f && angAbc.r != 0.0f) {
-          rotAbc = angAbc * rotAbc;
-          rotAbc.normalize();
-        }
-      }
-      Alembic::Abc::M44f matrixAbcRot;
-      matrixAbcRot.setAxisAngle(rotAbc.axis(), rotAbc.angle());
-      matrixAbc = matrixAbcRot * matrixAbc;
-    }
-
-    // and finally scaling
-    if (info->scale.size() == ud->gMbKeys.size() * 2) {
-      const Alembic::Abc::V3f scalingAbc =
-          info->scale[floorIndex]
-                  ->get()[id < info->scale[floorIndex]->size()
-                              ? id
-                              : info->scale[floorIndex]->size() - 1] *
-              info->width[floorIndex]
-                  ->get()[id < info->width[floorIndex]->size()
-                              ? id
-                              : info->width[floorIndex]->size() - 1] *
-              float(1.0 - sampleInfo.alpha) +
-          info->scale[ceilIndex]
-                  ->get()[id < info->scale[ceilIndex]->size()
-                              ? id
-                              : info->scale[ceilIndex]->size() - 1] *
-              info->width[ceilIndex]
-                  ->get()[id < info->width[ceilIndex]->size()
-                              ? id
-                              : info->width[ceilIndex]->size() - 1] *
-              float(sampleInfo.alpha);
-      matrixAbc.scale(scalingAbc);
-    }
-    else {
-      const float width =
-          info->width[floorIndex]
-                  ->get()[id < info->width[floorIndex]->size()
-                              ? id
-                              : info->width[floorIndex]->size() - 1] *
-              float(1.0 - sampleInfo.alpha) +
-          info->width[ceilIndex]
-                  ->get()[id < info->width[ceilIndex]->size()
-                              ? id
-                              : info->width[ceilIndex]->size() - 1] *
-              float(sampleInfo.alpha);
-      matrixAbc.scale(Alembic::Abc::V3f(width, width, width));
-    }
+  // now let's take care of the transform, the particle matrices have been
+  // computed by computeInstanceMatrices already
+  const size_t numKeys = ud->gMbKeys.size();
+  const size_t particle = id < info->numParticles ? id : info->numParticles - 1;
+  const Alembic::Abc::M44f *particleMatrices =
+      &info->particleMatrices[particle * numKeys];
+  AtArray *matrices = AiArrayAllocate(1, (AtInt)numKeys, AI_TYPE_MATRIX);
+  for (size_t j = 0; j < numKeys; ++j) {
+    Alembic::Abc::M44f matrixAbc = particleMatrices[j];
 
     // if we have offset matrices
     if (group->parents.size() > groupID && group->matrices.size() > groupID) {
@@ -271,3 +179,247 @@ AtNode *createInstanceNode(nodeData &nodata, userData *ud, int i)
 
   return shapeNode;
 }
+
+// ----------------------------------------------------------------------------------------------------
+// batch computation of the particle matrices
+
+// everything needed to evaluate one motion key, resolved once for all the
+// particles
+struct instanceKeyInputs {
+  const Alembic::Abc::V3f *posFloor, *posCeil, *vel;
+  size_t numPosFloor, numPosCeil, numVel;
+  const Alembic::Abc::V3f *scaleFloor, *scaleCeil;
+  size_t numScaleFloor, numScaleCeil;
+  const float *widthFloor, *widthCeil;
+  size_t numWidthFloor, numWidthCeil;
+  const Alembic::Abc::Quatf *rot, *ang;
+  size_t numRot, numAng;
+  bool blendPos;
+  float floorWeight, ceilWeight, angWeight, timeAlpha;
+};
+
+template <class T>
+static inline T clampedGet(const T *data, size_t size, size_t i,
+                           const T &fallback)
+{
+  if (size == 0) {
+    return fallback;
+  }
+  return data[i < size ? i : size - 1];
+}
+
+// particles are processed in blocks, the per particle inputs are gathered
+// into SoA buffers first so the blending loops don't branch
+static const size_t instanceBlockSize = 256;
+
+static void computeInstanceMatrixRange(const instanceKeyInputs *keys,
+                                       size_t numKeys,
+                                       Alembic::Abc::M44f *matrices,
+                                       size_t begin, size_t end)
+{
+  const Alembic::Abc::V3f zero(0.0f, 0.0f, 0.0f);
+  const Alembic::Abc::V3f one(1.0f, 1.0f, 1.0f);
+
+  float ax[instanceBlockSize], ay[instanceBlockSize], az[instanceBlockSize];
+  float bx[instanceBlockSize], by[instanceBlockSize], bz[instanceBlockSize];
+  float tx[instanceBlockSize], ty[instanceBlockSize], tz[instanceBlockSize];
+  float sx[instanceBlockSize], sy[instanceBlockSize], sz[instanceBlockSize];
+  float wa[instanceBlockSize], wb[instanceBlockSize];
+
+  for (size_t blockBegin = begin; blockBegin < end;
+       blockBegin += instanceBlockSize) {
+    const size_t n = std::min(instanceBlockSize, end - blockBegin);
+
+    for (size_t j = 0; j < numKeys; ++j) {
+      const instanceKeyInputs &key = keys[j];
+      const float wF = key.floorWeight;
+      const float wC = key.ceilWeight;
+
+      // translation
+      for (size_t p = 0; p < n; ++p) {
+        const Alembic::Abc::V3f a =
+            clampedGet(key.posFloor, key.numPosFloor, blockBegin + p, zero);
+        const Alembic::Abc::V3f b =
+            key.blendPos
+                ? clampedGet(key.posCeil, key.numPosCeil, blockBegin + p, zero)
+                : clampedGet(key.vel, key.numVel, blockBegin + p, zero);
+        ax[p] = a.x;
+        ay[p] = a.y;
+        az[p] = a.z;
+        bx[p] = b.x;
+        by[p] = b.y;
+        bz[p] = b.z;
+      }
+      if (key.blendPos) {
+        for (size_t p = 0; p < n; ++p) {
+          tx[p] = wF * ax[p] + wC * bx[p];
+          ty[p] = wF * ay[p] + wC * by[p];
+          tz[p] = wF * az[p] + wC * bz[p];
+        }
+      }
+      else {
+        const float timeAlpha = key.timeAlpha;
+        for (size_t p = 0; p < n; ++p) {
+          tx[p] = ax[p] + bx[p] * timeAlpha;
+          ty[p] = ay[p] + by[p] * timeAlpha;
+          tz[p] = az[p] + bz[p] * timeAlpha;
+        }
+      }
+
+      // scaling, the widths act as a uniform scale
+      for (size_t p = 0; p < n; ++p) {
+        wa[p] =
+            clampedGet(key.widthFloor, key.numWidthFloor, blockBegin + p, 1.0f);
+        wb[p] =
+            clampedGet(key.widthCeil, key.numWidthCeil, blockBegin + p, 1.0f);
+      }
+      if (key.scaleFloor != NULL) {
+        for (size_t p = 0; p < n; ++p) {
+          const Alembic::Abc::V3f a = clampedGet(
+              key.scaleFloor, key.numScaleFloor, blockBegin + p, one);
+          const Alembic::Abc::V3f b =
+              clampedGet(key.scaleCeil, key.numScaleCeil, blockBegin + p, one);
+          ax[p] = a.x;
+          ay[p] = a.y;
+          az[p] = a.z;
+          bx[p] = b.x;
+          by[p] = b.y;
+          bz[p] = b.z;
+        }
+        for (size_t p = 0; p < n; ++p) {
+          sx[p] = ax[p] * wa[p] * wF + bx[p] * wb[p] * wC;
+          sy[p] = ay[p] * wa[p] * wF + by[p] * wb[p] * wC;
+          sz[p] = az[p] * wa[p] * wF + bz[p] * wb[p] * wC;
+        }
+      }
+      else {
+        for (size_t p = 0; p < n; ++p) {
+          sx[p] = sy[p] = sz[p] = wa[p] * wF + wb[p] * wC;
+        }
+      }
+
+      // compose scale * rotation * translation straight into the matrices
+      for (size_t p = 0; p < n; ++p) {
+        Alembic::Abc::M44f &m = matrices[(blockBegin + p) * numKeys + j];
+        m.makeIdentity();
+        if (key.rot != NULL) {
+          Alembic::Abc::Quatf rotAbc = clampedGet(
+              key.rot, key.numRot, blockBegin + p, Alembic::Abc::Quatf());
+          if (key.ang != NULL) {
+            Alembic::Abc::Quatf angAbc =
+                clampedGet(key.ang, key.numAng, blockBegin + p,
+                           Alembic::Abc::Quatf()) *
+                key.angWeight;
+            if (angAbc.axis().length2() != 0.0f && angAbc.r != 0.0f) {
+              rotAbc = angAbc * rotAbc;
+              rotAbc.normalize();
+            }
+          }
+          m.setAxisAngle(rotAbc.axis(), rotAbc.angle());
+        }
+        m[0][0] *= sx[p];
+        m[0][1] *= sx[p];
+        m[0][2] *= sx[p];
+        m[1][0] *= sy[p];
+        m[1][1] *= sy[p];
+        m[1][2] *= sy[p];
+        m[2][0] *= sz[p];
+        m[2][1] *= sz[p];
+        m[2][2] *= sz[p];
+        m[3][0] = tx[p];
+        m[3][1] = ty[p];
+        m[3][2] = tz[p];
+      }
+    }
+  }
+}
+
+// below this many particles it is not worth spawning threads
+static const size_t instanceParallelThreshold = 4096;
+
+void computeInstanceMatrices(userData *ud, instanceCloudInfo &info,
+                             Alembic::AbcGeom::IPoints &cloud)
+{
+  const size_t numKeys = ud->gMbKeys.size();
+  info.numParticles = info.pos.empty() ? 0 : info.pos[0]->size();
+  info.particleMatrices.clear();
+  if (info.numParticles == 0 || numKeys == 0) {
+    return;
+  }
+
+  // the samples are only stored once if the cloud is not animated
+  const size_t numStoredKeys = info.pos.size() / 2;
+
+  std::vector<instanceKeyInputs> keys(numKeys);
+  for (size_t j = 0; j < numKeys; ++j) {
+    SampleInfo sampleInfo =
+        getSampleInfo(ud->gMbKeys[j], cloud.getSchema().getTimeSampling(),
+                      cloud.getSchema().getNumSamples());
+
+    const size_t k = j < numStoredKeys ? j : numStoredKeys - 1;
+    const size_t floorIndex = k << 1;
+    const size_t ceilIndex = floorIndex + 1;
+
+    instanceKeyInputs &key = keys[j];
+    memset(&key, 0, sizeof(key));
+    key.floorWeight = float(1.0 - sampleInfo.alpha);
+    key.ceilWeight = float(sampleInfo.alpha);
+    key.angWeight = (float)sampleInfo.alpha;
+
+    key.posFloor = info.pos[floorIndex]->get();
+    key.numPosFloor = info.pos[floorIndex]->size();
+    key.posCeil = info.pos[ceilIndex]->get();
+    key.numPosCeil = info.pos[ceilIndex]->size();
+    key.blendPos = key.numPosFloor == key.numPosCeil;
+    if (!key.blendPos) {
+      key.timeAlpha = getTimeOffsetFromObject(cloud, sampleInfo);
+      if (info.vel[floorIndex]) {
+        key.vel = info.vel[floorIndex]->get();
+        key.numVel = info.vel[floorIndex]->size();
+      }
+    }
+
+    if (info.width.size() > ceilIndex) {
+      key.widthFloor = info.width[floorIndex]->get();
+      key.numWidthFloor = info.width[floorIndex]->size();
+      key.widthCeil = info.width[ceilIndex]->get();
+      key.numWidthCeil = info.width[ceilIndex]->size();
+    }
+    if (info.scale.size() > ceilIndex) {
+      key.scaleFloor = info.scale[floorIndex]->get();
+      key.numScaleFloor = info.scale[floorIndex]->size();
+      key.scaleCeil = info.scale[ceilIndex]->get();
+      key.numScaleCeil = info.scale[ceilIndex]->size();
+    }
+    if (info.rot.size() > k) {
+      key.rot = info.rot[k]->get();
+      key.numRot = info.rot[k]->size();
+      if (info.ang.size() > k && sampleInfo.alpha > 0.0) {
+        key.ang = info.ang[k]->get();
+        key.numAng = info.ang[k]->size();
+      }
+    }
+  }
+
+  info.particleMatrices.resize(info.numParticles * numKeys);
+
+  size_t numThreads = boost::thread::hardware_concurrency();
+  if (numThreads < 2 || info.numParticles < instanceParallelThreshold) {
+    computeInstanceMatrixRange(&keys[0], numKeys, &info.particleMatrices[0], 0,
+                               info.numParticles);
+    return;
+  }
+
+  // split the particles into contiguous, block aligned ranges
+  size_t chunk = (info.numParticles + numThreads - 1) / numThreads;
+  chunk = (chunk + instanceBlockSize - 1) / instanceBlockSize *
+          instanceBlockSize;
+  boost::thread_group threads;
+  for (size_t begin = 0; begin < info.numParticles; begin += chunk) {
+    threads.create_thread(boost::bind(
+        &computeInstanceMatrixRange, &keys[0], numKeys,
+        &info.particleMatrices[0], begin,
+        std::min(begin + chunk, info.numParticles)));
+  }
+  threads.join_all();
+}
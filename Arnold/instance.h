@@ -5,4 +5,9 @@
 
 AtNode *createInstanceNode(nodeData &nodata, userData *ud, int i);
 
+// computes the matrices of all the particles for all the motion keys, in
+// parallel for large clouds. createInstanceNode only copies them afterwards.
+void computeInstanceMatrices(userData *ud, instanceCloudInfo &info,
+                             Alembic::AbcGeom::IPoints &cloud);
+
 #endif
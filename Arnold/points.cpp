@@ -1,6 +1,7 @@
 #include "stdafx.h"
 
 #include "points.h"
+#include "samplePrefetch.h"
 
 AtNode *createPointsNode(nodeData &nodata, userData *ud,
                          std::vector<float> &samples, int i)
@@ -20,14 +21,24 @@ AtNode *createPointsNode(nodeData &nodata, userData *ud,
 
   // loop over all samples
   AtULong posOffset = 0;
+  // read the samples of all the motion keys at once
+  std::vector<SampleInfo> sampleInfos(minNumSamples);
+  samplePrefetch<Alembic::AbcGeom::IPointsSchema> prefetch(
+      typedObject.getSchema(), ud->gParallelReads);
   for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
-    SampleInfo sampleInfo = getSampleInfo(
+    sampleInfos[sampleIndex] = getSampleInfo(
         samples[sampleIndex], typedObject.getSchema().getTimeSampling(),
         typedObject.getSchema().getNumSamples());
+    prefetch.request(sampleInfos[sampleIndex].floorIndex);
+  }
+  prefetch.fetch();
+
+  for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
+    SampleInfo &sampleInfo = sampleInfos[sampleIndex];
 
     // get the floor sample
-    Alembic::AbcGeom::IPointsSchema::Sample sample;
-    typedObject.getSchema().get(sample, sampleInfo.floorIndex);
+    const Alembic::AbcGeom::IPointsSchema::Sample &sample =
+        prefetch.get(sampleInfo.floorIndex);
 
     // access the points
     Alembic::Abc::P3fArraySamplePtr abcPos = sample.getPositions();
@@ -1,6 +1,8 @@
 #include "stdafx.h"
 
 #include "polyMesh.h"
+#include "CommonMeshUtilities.h"
+#include "samplePrefetch.h"
 
 struct __indices {
   AtArray *faceIndices;
@@ -66,6 +68,51 @@ void point_normal(__indices &indices, const Alembic::Abc::Int32ArraySamplePtr &a
 
 
 
+// ----------------------------------------------------------------------------------------------------
+// bulk copies into the arnold arrays, AtPoint and Imath::V3f share the same
+// layout so the positions are written straight into AtArray::data
+
+// AiArraySetPnt used to reject out of range writes, samples with more points
+// than the array was allocated for are truncated the same way (the offset
+// still moves by the full sample size)
+static size_t writableCount(const AtArray *pos, AtULong posOffset,
+                            size_t count)
+{
+  const size_t size = (size_t)pos->nelements * (size_t)pos->nkeys;
+  if (posOffset >= size) {
+    return 0;
+  }
+  return std::min(count, size - (size_t)posOffset);
+}
+
+static void copyPoints(AtArray *pos, AtULong &posOffset,
+                       const Alembic::Abc::V3f *src, size_t count)
+{
+  memcpy((AtPoint *)pos->data + posOffset, src,
+         writableCount(pos, posOffset, count) * sizeof(AtPoint));
+  posOffset += (AtULong)count;
+}
+
+// the point kernels of CommonMeshUtilities, writing at posOffset
+static void lerpPoints(AtArray *pos, AtULong &posOffset,
+                       const Alembic::Abc::V3f *a, const Alembic::Abc::V3f *b,
+                       size_t count, float alpha)
+{
+  lerpPoints((Alembic::Abc::V3f *)((AtPoint *)pos->data + posOffset), a, b,
+             writableCount(pos, posOffset, count), alpha);
+  posOffset += (AtULong)count;
+}
+
+static void extrapolatePoints(AtArray *pos, AtULong &posOffset,
+                              const Alembic::Abc::V3f *p,
+                              const Alembic::Abc::V3f *v, size_t count,
+                              float alpha)
+{
+  extrapolatePoints((Alembic::Abc::V3f *)((AtPoint *)pos->data + posOffset), p,
+                    v, writableCount(pos, posOffset, count), alpha);
+  posOffset += (AtULong)count;
+}
+
 // common function for PolyMesh and SubD!
 static bool faceCount(AtNode *shapeNode, __indices &ind,
                       Alembic::Abc::Int32ArraySamplePtr &abcFaceCounts,
@@ -75,22 +122,17 @@ static bool faceCount(AtNode *shapeNode, __indices &ind,
     return false;
   }
 
-  AtArray *faceCounts = AiArrayAllocate((AtInt)abcFaceCounts->size(), 1, AI_TYPE_UINT);
-  ind.faceIndices = AiArrayAllocate((AtInt)abcFaceIndices->size(), 1, AI_TYPE_UINT);
-  ind.indices = AiArrayAllocate((AtInt)abcFaceIndices->size(), 1, AI_TYPE_UINT);
-  AtUInt offset = 0;
-
-  for (AtULong i = 0; i < faceCounts->nelements; ++i) {
-    const int _FaceCounts = abcFaceCounts->get()[i];
-    AiArraySetUInt(faceCounts, i, _FaceCounts);
-    for (AtLong j = 0; j < _FaceCounts; ++j) {
-      const int offFaceCounts = offset + _FaceCounts - (j + 1);
-      AiArraySetUInt(ind.faceIndices, offset + j,
-                     abcFaceIndices->get()[offFaceCounts]);
-      AiArraySetUInt(ind.indices, offset + j, offFaceCounts);
-    }
-    offset += _FaceCounts;
-  }
+  const size_t nbFaces = abcFaceCounts->size();
+  const size_t nbIndices = abcFaceIndices->size();
+  AtArray *faceCounts = AiArrayAllocate((AtInt)nbFaces, 1, AI_TYPE_UINT);
+  ind.faceIndices = AiArrayAllocate((AtInt)nbIndices, 1, AI_TYPE_UINT);
+  ind.indices = AiArrayAllocate((AtInt)nbIndices, 1, AI_TYPE_UINT);
+
+  // the counts are copied as is, the winding of every face is reversed
+  memcpy(faceCounts->data, abcFaceCounts->get(), nbFaces * sizeof(AtUInt32));
+  reverseFaceWinding(abcFaceCounts->get(), nbFaces, abcFaceIndices->get(),
+                     (AtUInt32 *)ind.faceIndices->data,
+                     (AtUInt32 *)ind.indices->data);
   AiNodeSetArray(shapeNode, "nsides", faceCounts);
   AiNodeSetArray(shapeNode, "vidxs", ind.faceIndices);
   AiNodeSetBool(shapeNode, "smoothing", true);
@@ -204,22 +246,13 @@ static void plainPositionCopy(AtArray *pos,
                               Alembic::Abc::P3fArraySamplePtr &abcPos,
                               AtULong &posOffset)
 {
-  const int nbPos = (int)abcPos->size();
-  for (size_t i = 0; i < nbPos; ++i) {
-    AtPoint pt;
-    const Alembic::Abc::P3fArraySamplePtr::element_type::value_type &apos =
-        abcPos->get()[i];
-    pt.x = apos.x;
-    pt.y = apos.y;
-    pt.z = apos.z;
-
-    AiArraySetPnt(pos, posOffset++, pt);
-  }
+  copyPoints(pos, posOffset, abcPos->get(), abcPos->size());
 }
 
 // IF pos == NULL, it needs to be done before calling that function
 template <typename SCHEMA, typename SCHEMA_SAMPLE>
-static bool hadToInterpolatePositions(size_t sampleIndex, SCHEMA &schema, SCHEMA_SAMPLE &sample,
+static bool hadToInterpolatePositions(size_t sampleIndex, SCHEMA &schema, const SCHEMA_SAMPLE &sample,
+                                      samplePrefetch<SCHEMA> &prefetch,
                                       AtArray *pos, AtULong &posOffset,
                                       std::vector<float> &samples,
                                       SampleInfo &sampleInfo,
@@ -234,29 +267,13 @@ static bool hadToInterpolatePositions(size_t sampleIndex, SCHEMA &schema, SCHEMA
     return false;
   }
   else {
-    SCHEMA_SAMPLE sample2;
-    schema.get(sample2, sampleInfo.ceilIndex);
-    Alembic::Abc::P3fArraySamplePtr abcPos2 = sample2.getPositions();
     const float alpha = (float)sampleInfo.alpha;
-    const float ialpha = 1.0f - alpha;
 
     if (!dynamicTopology) {
-
-      for (size_t i = 0; i < abcPos->size(); i++) {
-        AtPoint pt;
-        const Alembic::Abc::P3fArraySamplePtr::element_type::value_type &p1 =
-            abcPos->get()[i];
-        const Alembic::Abc::P3fArraySamplePtr::element_type::value_type &p2 =
-            abcPos2->get()[i];
-        pt.x = p1.x * ialpha + p2.x * alpha;
-        pt.y = p1.y * ialpha + p2.y * alpha;
-        pt.z = p1.z * ialpha + p2.z * alpha;
-        /*pt.x = p1.x + (p2.x - p1.x) * alpha;
-        pt.y = p1.y + (p2.y - p1.y) * alpha;
-        pt.z = p1.z + (p2.z - p1.z) * alpha;*/
-
-        AiArraySetPnt(pos, posOffset++, pt);
-      }
+      Alembic::Abc::P3fArraySamplePtr abcPos2 =
+          prefetch.get(sampleInfo.ceilIndex).getPositions();
+      lerpPoints(pos, posOffset, abcPos->get(), abcPos2->get(),
+                 abcPos->size(), alpha);
     }
     else {
       Alembic::Abc::V3fArraySamplePtr abcVel = sample.getVelocities();
@@ -268,19 +285,8 @@ static bool hadToInterpolatePositions(size_t sampleIndex, SCHEMA &schema, SCHEMA
         float interp = samples[0] + ((samples[samples.size()-1] - samples[0]) * ratio);
         float alpha = (interp - timeSampling->getSampleTime(sampleInfo.ceilIndex));
 
-        for (size_t i = 0; i < abcPos->size(); i++) {
-          AtPoint pt;
-          const Alembic::Abc::P3fArraySamplePtr::element_type::value_type &p1 =
-              abcPos->get()[i];
-          const Alembic::Abc::V3fArraySamplePtr::element_type::value_type &v1 =
-              abcVel->get()[i];
-
-          pt.x = p1.x + (v1.x * alpha);
-          pt.y = p1.y + (v1.y * alpha);
-          pt.z = p1.z + (v1.z * alpha);
-
-          AiArraySetPnt(pos, posOffset++, pt);
-        }
+        extrapolatePoints(pos, posOffset, abcPos->get(), abcVel->get(),
+                          abcPos->size(), alpha);
       }
       else {
         plainPositionCopy(pos, abcPos, posOffset);
@@ -330,23 +336,37 @@ AtNode *createPolyMeshNode(nodeData &nodata, userData *ud,
   Alembic::Abc::Int32ArraySamplePtr abcFaceCounts;
   Alembic::Abc::Int32ArraySamplePtr abcFaceIndices;
 
-  __indices ind;
+  // read the samples of all the motion keys at once
+  std::vector<SampleInfo> sampleInfos(minNumSamples);
+  samplePrefetch<Alembic::AbcGeom::IPolyMeshSchema> prefetch(
+      typedObject.getSchema(), ud->gParallelReads);
   for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
-    SampleInfo sampleInfo = getSampleInfo(
+    SampleInfo &sampleInfo = sampleInfos[sampleIndex];
+    sampleInfo = getSampleInfo(
     samples[sampleIndex], typedObject.getSchema().getTimeSampling(),
     typedObject.getSchema().getNumSamples());
 
     if (dynamicTopology) {
-      Alembic::Abc::TimeSamplingPtr timeSampling = typedObject.getSchema().getTimeSampling();
       sampleInfo = getSampleInfo(ud->gCurrTime, typedObject.getSchema().getTimeSampling(), typedObject.getSchema().getNumSamples());
 
       // we don't really care about that as we directly get it
       sampleInfo.alpha = 0;
     }
 
+    prefetch.request(sampleInfo.floorIndex);
+    if (sampleInfo.alpha > sampleTolerance && !dynamicTopology) {
+      prefetch.request(sampleInfo.ceilIndex);
+    }
+  }
+  prefetch.fetch();
+
+  __indices ind;
+  for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
+    SampleInfo &sampleInfo = sampleInfos[sampleIndex];
+
     // get the floor sample
-    Alembic::AbcGeom::IPolyMeshSchema::Sample sample;
-    typedObject.getSchema().get(sample, sampleInfo.floorIndex);
+    const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample =
+        prefetch.get(sampleInfo.floorIndex);
 
     // take care of the topology
     if (sampleIndex == 0) {
@@ -360,9 +380,7 @@ AtNode *createPolyMeshNode(nodeData &nodata, userData *ud,
       {
         const int nbElem = ind.indices->nelements;
         nsIdx = AiArrayAllocate(nbElem, 1, AI_TYPE_UINT);
-        for (int ii = 0; ii < nbElem; ++ii) {
-          AiArraySetUInt(nsIdx, ii, AiArrayGetUInt(ind.indices, ii));
-        }
+        memcpy(nsIdx->data, ind.indices->data, nbElem * sizeof(AtUInt32));
       }
 
       if (typedObject.getSchema().getPropertyHeader(
@@ -395,22 +413,16 @@ AtNode *createPolyMeshNode(nodeData &nodata, userData *ud,
 
           AtArray *bindPose =
               AiArrayAllocate((AtInt)abcBindPose->size(), 1, AI_TYPE_POINT);
-          AtPoint pnt;
-          for (AtULong i = 0; i < abcBindPose->size(); i++) {
-            const Alembic::Abc::V3fArraySamplePtr::element_type::value_type
-                &bind = abcBindPose->get()[i];
-            pnt.x = bind.x;
-            pnt.y = bind.y;
-            pnt.z = bind.z;
-            AiArraySetPnt(bindPose, i, pnt);
-          }
+          AtULong bindPoseOffset = 0;
+          copyPoints(bindPose, bindPoseOffset, abcBindPose->get(),
+                     abcBindPose->size());
           AiNodeSetArray(shapeNode, "Pref", bindPose);
         }
       }
     }
 
     // access the positions
-    Alembic::Abc::N3fArraySamplePtr abcNor = NULL;
+    Alembic::Abc::N3fArraySamplePtr abcNor;
     if(haveNormals)
       abcNor = normalParam.getExpandedValue(sampleInfo.floorIndex).getVals();
 
@@ -422,10 +434,10 @@ AtNode *createPolyMeshNode(nodeData &nodata, userData *ud,
     }
 
     const bool interpolated = hadToInterpolatePositions(
-      sampleIndex, typedObject.getSchema(), sample, pos, posOffset, samples, sampleInfo, ud->gCurrTime, dynamicTopology);
+      sampleIndex, typedObject.getSchema(), sample, prefetch, pos, posOffset, samples, sampleInfo, ud->gCurrTime, dynamicTopology);
 
 
-    if (abcNor != NULL) {
+    if (abcNor) {
       if (nor == NULL)
         nor = AiArrayAllocate((AtInt)abcNor->size(), (AtInt)minNumSamples, AI_TYPE_VECTOR);
 
@@ -489,14 +501,27 @@ AtNode *createSubDNode(nodeData &nodata, userData *ud,
   AtULong posOffset = 0;
   Alembic::Abc::Int32ArraySamplePtr abcFaceCounts;
 
+  // read the samples of all the motion keys at once
+  std::vector<SampleInfo> sampleInfos(minNumSamples);
+  samplePrefetch<Alembic::AbcGeom::ISubDSchema> prefetch(
+      typedObject.getSchema(), ud->gParallelReads);
   for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
-    SampleInfo sampleInfo = getSampleInfo(
+    sampleInfos[sampleIndex] = getSampleInfo(
         samples[sampleIndex], typedObject.getSchema().getTimeSampling(),
         typedObject.getSchema().getNumSamples());
+    prefetch.request(sampleInfos[sampleIndex].floorIndex);
+    if (sampleInfos[sampleIndex].alpha > sampleTolerance && !dynamicTopology) {
+      prefetch.request(sampleInfos[sampleIndex].ceilIndex);
+    }
+  }
+  prefetch.fetch();
+
+  for (size_t sampleIndex = 0; sampleIndex < minNumSamples; ++sampleIndex) {
+    SampleInfo &sampleInfo = sampleInfos[sampleIndex];
 
     // get the floor sample
-    Alembic::AbcGeom::ISubDSchema::Sample sample;
-    typedObject.getSchema().get(sample, sampleInfo.floorIndex);
+    const Alembic::AbcGeom::ISubDSchema::Sample &sample =
+        prefetch.get(sampleInfo.floorIndex);
 
     // take care of the topology
     if (sampleIndex == 0) {
@@ -532,7 +557,7 @@ AtNode *createSubDNode(nodeData &nodata, userData *ud,
                             AI_TYPE_POINT);
       firstSampleCount = sample.getFaceIndices()->size();
     }
-    hadToInterpolatePositions(sampleIndex, typedObject.getSchema(), sample, pos, posOffset,
+    hadToInterpolatePositions(sampleIndex, typedObject.getSchema(), sample, prefetch, pos, posOffset,
                               samples, sampleInfo, ud->gCurrTime, dynamicTopology);
   }
   AiNodeSetArray(shapeNode, "vlist", pos);
@@ -0,0 +1,93 @@
+#ifndef _ARNOLD_ALEMBIC_SAMPLE_PREFETCH_H_
+#define _ARNOLD_ALEMBIC_SAMPLE_PREFETCH_H_
+
+#include "CommonParallel.h"
+#include "utility.h"
+
+/**
+ * Reads all the schema samples a node needs for its motion keys up front.
+ * Every distinct sample index is read once, and when there are several of
+ * them the reads are spread over the threads of parallelFor, each with its
+ * own copy of the schema, on the archive's Ogawa streams. HDF5 archives can't
+ * be read concurrently, parallel must be false for them.
+ *
+ * Usage: request() every index, fetch() once, then get() them.
+ */
+template <typename SCHEMA>
+class samplePrefetch {
+ public:
+  typedef typename SCHEMA::Sample sampleType;
+
+  samplePrefetch(SCHEMA &schema, bool parallel)
+      : m_schema(schema), m_parallel(parallel)
+  {
+  }
+
+  void request(Alembic::Abc::index_t index) { m_entries[index]; }
+
+  void fetch()
+  {
+    if (!m_parallel || m_entries.size() < 2) {
+      return;
+    }
+
+    readRange reads(m_schema);
+    for (typename entryMap::iterator it = m_entries.begin();
+         it != m_entries.end(); ++it) {
+      reads.entries.push_back(&*it);
+    }
+    parallelFor(reads.entries.size(), 1, reads);
+  }
+
+  // samples that were not requested, or failed to read in the background, are
+  // read now so errors surface on the calling thread
+  const sampleType &get(Alembic::Abc::index_t index)
+  {
+    entry &e = m_entries[index];
+    if (!e.valid) {
+      m_schema.get(e.sample, index);
+      e.valid = true;
+    }
+    return e.sample;
+  }
+
+ private:
+  struct entry {
+    entry() : valid(false) {}
+    sampleType sample;
+    bool valid;
+  };
+  typedef std::map<Alembic::Abc::index_t, entry> entryMap;
+
+  class readRange : public ParallelRange {
+   public:
+    readRange(const SCHEMA &schema) : m_schema(schema) {}
+
+    virtual void run(size_t begin, size_t end)
+    {
+      // the schema wrappers are not shared between threads
+      SCHEMA schema(m_schema);
+      for (size_t i = begin; i < end; ++i) {
+        entry &e = entries[i]->second;
+        try {
+          schema.get(e.sample, entries[i]->first);
+          e.valid = true;
+        }
+        catch (std::exception &) {
+          e.valid = false;
+        }
+      }
+    }
+
+    std::vector<typename entryMap::value_type *> entries;
+
+   private:
+    const SCHEMA &m_schema;
+  };
+
+  SCHEMA &m_schema;
+  bool m_parallel;
+  entryMap m_entries;
+};
+
+#endif
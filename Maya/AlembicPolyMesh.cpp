@@ -3,6 +3,8 @@
 #include "AlembicPolyMesh.h"
 #include "AttributesReading.h"
 #include "CommonMeshUtilities.h"
+#include "CommonPointBlend.h"
+#include "CommonSamplePrefetcher.h"
 #include "MetaData.h"
 
 AlembicPolyMesh::AlembicPolyMesh(SceneNodePtr eNode, AlembicWriteJob *in_Job,
@@ -1139,7 +1141,11 @@ MStatus AlembicPolyMeshNode::setDependentsDirty(const MPlug &plugBeingDirtied,
 
 void AlembicPolyMeshDeformNode::PreDestruction()
 {
+  if (cachePosition) {
+    SamplePrefetcher::cancel(cachePosition.get(), mObj.getFullName());
+  }
   mSchema.reset();
+  cachePosition.reset();
   delRefArchive(mFileName);
   mFileName.clear();
 }
@@ -1235,6 +1241,9 @@ MStatus AlembicPolyMeshDeformNode::deform(MDataBlock &dataBlock,
 
   // check if we have the file
   if (fileName != mFileName || identifier != mIdentifier) {
+    if (cachePosition) {
+      SamplePrefetcher::cancel(cachePosition.get(), mObj.getFullName());
+    }
     mSchema.reset();
     if (fileName != mFileName) {
       delRefArchive(mFileName);
@@ -1266,7 +1275,8 @@ MStatus AlembicPolyMeshDeformNode::deform(MDataBlock &dataBlock,
       return MStatus::kFailure;
     }
     mSchema = obj.getSchema();
-    cachePosition.clear();
+    cachePosition = getPositionSampleCache(mFileName.asChar());
+    mPrefetch = archiveSupportsConcurrentReads(mFileName.asChar());
 
     mDynamicTopology = pObjectCache->isMeshTopoDynamic;
   }
@@ -1307,36 +1317,94 @@ MStatus AlembicPolyMeshDeformNode::deform(MDataBlock &dataBlock,
   Abc::P3fArraySamplePtr samplePos;
   Abc::P3fArraySamplePtr samplePos2;
   {
-    // now using the cache to save the most recent queries!
+    // the cache is shared by every node reading the archive
     ESS_PROFILE_SCOPE("AlembicPolyMeshDeformNode::deform get position samples");
-    if (cachePosition.contains(sampleInfo.floorIndex)) {
-      samplePos = cachePosition.get(sampleInfo.floorIndex);
-    }
-    else {
+    const std::string fullName = mObj.getFullName();
+    const SampleCacheKey floorKey(fullName, sampleInfo.floorIndex);
+    if (!cachePosition || !cachePosition->get(floorKey, samplePos)) {
       mSchema.getPositionsProperty().get(samplePos, sampleInfo.floorIndex);
-      cachePosition.insert(sampleInfo.floorIndex, samplePos);
+      if (cachePosition) {
+        cachePosition->insert(floorKey, samplePos);
+      }
     }
     if (sampleInfo.alpha != 0.0) {
-      if (cachePosition.contains(sampleInfo.ceilIndex)) {
-        samplePos2 = cachePosition.get(sampleInfo.ceilIndex);
-      }
-      else {
+      const SampleCacheKey ceilKey(fullName, sampleInfo.ceilIndex);
+      if (!cachePosition || !cachePosition->get(ceilKey, samplePos2)) {
         mSchema.getPositionsProperty().get(samplePos2, sampleInfo.ceilIndex);
-        cachePosition.insert(sampleInfo.ceilIndex, samplePos2);
+        if (cachePosition) {
+          cachePosition->insert(ceilKey, samplePos2);
+        }
       }
     }
+
+    // read the next samples of the playback while this one is blended
+    if (mPrefetch && samplePos) {
+      SamplePrefetcher::prefetchPositions(
+          cachePosition, fullName, mSchema.getPositionsProperty(),
+          sampleInfo.floorIndex, samplePos->size() * sizeof(Abc::V3f));
+    }
   }
 
-  // iteration should not be necessary. the iteration is only
-  // required if the same mesh is attached to the same deformer
-  // several times
   const float blend = (float)sampleInfo.alpha;
+  const bool useBlending = sampleInfo.alpha != 0.0 &&
+                           samplePos2->size() == samplePos->size() &&
+                           !mDynamicTopology;
+
+  // when the iterator covers the whole mesh, its points are in vertex order
+  // and can be read, blended and written in bulk
+  bool wholeMesh = false;
+  {
+    MArrayDataHandle inputArray = dataBlock.outputArrayValue(input);
+    if (inputArray.jumpToElement(geomIndex) == MS::kSuccess) {
+      MObject inputMesh = inputArray.outputValue().child(inputGeom).asMesh();
+      wholeMesh = !inputMesh.isNull() &&
+                  MFnMesh(inputMesh).numVertices() == iter.count();
+    }
+  }
+
+  if (wholeMesh) {
+    ESS_PROFILE_SCOPE("AlembicPolyMeshDeformNode::deform blend points");
+    MPointArray points;
+    iter.allPositions(points);
+    if (points.length() == 0) {
+      return MStatus::kSuccess;
+    }
+    const unsigned int numPoints =
+        std::min(points.length(), (unsigned int)samplePos->size());
+
+    // missing weights are 1, no weights at all means they all are
+    std::vector<float> pointWeights;
+    MArrayDataHandle weightListArray = dataBlock.inputArrayValue(weightList);
+    if (weightListArray.jumpToElement(geomIndex) == MS::kSuccess) {
+      MArrayDataHandle weightArray =
+          weightListArray.inputValue().child(weights);
+      const unsigned int numWeights = weightArray.elementCount();
+      if (numWeights > 0) {
+        pointWeights.resize(numPoints, 1.0f);
+        for (unsigned int i = 0; i < numWeights; i++, weightArray.next()) {
+          const unsigned int index = weightArray.elementIndex();
+          if (index < numPoints) {
+            pointWeights[index] = weightArray.inputValue().asFloat();
+          }
+        }
+      }
+    }
+
+    std::vector<double> buffer(points.length() * 4);
+    double(*pointData)[4] = reinterpret_cast<double(*)[4]>(&buffer[0]);
+    points.get(pointData);
+    blendPoints(pointData, numPoints,
+                pointWeights.empty() ? NULL : &pointWeights[0], env,
+                samplePos->get(), useBlending ? samplePos2->get() : NULL,
+                blend);
+    iter.setAllPositions(MPointArray(pointData, points.length()));
+    return MStatus::kSuccess;
+  }
+
+  // a subset of the mesh, go through the points the iterator gives
   {
     ESS_PROFILE_SCOPE("AlembicPolyMeshDeformNode::deform position iterator");
 
-    const bool useBlending = sampleInfo.alpha != 0.0 &&
-                             samplePos2->size() == samplePos->size() &&
-                             !mDynamicTopology;
     for (iter.reset(); !iter.isDone(); iter.next()) {
       const int iter_index = iter.index();
       const float weight = weightValue(dataBlock, geomIndex, iter_index) * env;
@@ -82,12 +82,8 @@ class AlembicPolyMeshNode : public AlembicObjectNode {
 };
 
 class AlembicPolyMeshDeformNode : public AlembicObjectDeformNode {
- private:
-  typedef MRUCache<Alembic::AbcCoreAbstract::index_t, Abc::P3fArraySamplePtr>
-      mruP3fArraySamplePtr;
-
  public:
-  AlembicPolyMeshDeformNode(void) : cachePosition() {}
+  AlembicPolyMeshDeformNode(void) : mPrefetch(false) {}
   virtual ~AlembicPolyMeshDeformNode();
   // override virtual methods from MPxDeformerNode
   virtual void PreDestruction();
@@ -121,7 +117,10 @@ class AlembicPolyMeshDeformNode : public AlembicObjectDeformNode {
 
   // members
   SampleInfo mLastSampleInfo;
-  mruP3fArraySamplePtr cachePosition;
+  // shared with the other nodes reading the archive
+  boost::shared_ptr<P3fArraySampleCache> cachePosition;
+  // the archive can be read ahead on other threads
+  bool mPrefetch;
 };
 
 class AlembicCreateFaceSetsCommand : public MPxCommand {
@@ -17,8 +17,11 @@
 #include "CommonUtilities.h"
 
 #include <maya/MItDag.h>
+#include <maya/MObjectHandle.h>
 #include "sceneGraph.h"
 
+#include <boost/unordered_map.hpp>
+
 struct PreProcessStackElement {
   SceneNodePtr eNode;
   Abc::OObject oParent;
@@ -29,6 +32,29 @@ struct PreProcessStackElement {
   }
 };
 
+// set of Maya objects, looked up by the hash code of their handle
+class MObjectHashSet {
+ public:
+  // returns false if the object was in the set already
+  bool insert(const MObject &obj)
+  {
+    const unsigned int hash = MObjectHandle(obj).hashCode();
+    std::pair<Entries::iterator, Entries::iterator> range =
+        mEntries.equal_range(hash);
+    for (Entries::iterator it = range.first; it != range.second; ++it) {
+      if (it->second == obj) {
+        return false;
+      }
+    }
+    mEntries.insert(std::make_pair(hash, obj));
+    return true;
+  }
+
+ private:
+  typedef boost::unordered_multimap<unsigned int, MObject> Entries;
+  Entries mEntries;
+};
+
 AlembicWriteJob::AlembicWriteJob(const MString &in_FileName,
                                  const MObjectArray &in_Selection,
                                  const MDoubleArray &in_Frames, bool use_ogawa,
@@ -118,8 +144,10 @@ void AlembicWriteJob::createArchive(const char *sceneFileName)
   const std::string expFileName = getExporterFileName(sceneFileName);
   if (useOgawa) {
     mArchive = CreateArchiveWithInfo(
-        Alembic::AbcCoreOgawa::WriteArchive(), mFileName.asChar(),
-        expName.c_str(), expFileName.c_str(), Abc::ErrorHandler::kThrowPolicy);
+        Alembic::AbcCoreOgawa::WriteArchive(
+            64 * 1024 * 1024, Alembic::AbcCoreAbstract::kChunkedMurmur3Hash),
+        mFileName.asChar(), expName.c_str(), expFileName.c_str(),
+        Abc::ErrorHandler::kThrowPolicy);
   }
   else {
     mArchive = CreateArchiveWithInfo(
@@ -170,7 +198,10 @@ MStatus AlembicWriteJob::PreProcess()
   // MString sceneFileName = "Exported from:
   // "+Application().GetActiveProject().GetActiveScene().GetParameterValue("FileName").GetAsText();
   try {
-    createArchive("Exported from Maya.");
+    {
+      ESS_PROFILE_SCOPE("AlembicWriteJob::PreProcess createArchive");
+      createArchive("Exported from Maya.");
+    }
 
     mTop = mArchive.getTop();
 
@@ -200,11 +231,16 @@ MStatus AlembicWriteJob::PreProcess()
     {
       MItDag().getPath(dagPath);
     }
-    SceneNodePtr exoSceneRoot = buildMayaSceneGraph(dagPath, this->replacer);
+    SceneNodePtr exoSceneRoot;
+    {
+      ESS_PROFILE_SCOPE("AlembicWriteJob::PreProcess buildMayaSceneGraph");
+      exoSceneRoot = buildMayaSceneGraph(dagPath, this->replacer);
+    }
     const bool bFlattenHierarchy = GetOption("flattenHierarchy") == "1";
     const bool bTransformCache = GetOption("transformCache") == "1";
     const bool bSelectChildren = false;
     {
+      ESS_PROFILE_SCOPE("AlembicWriteJob::PreProcess selectNodes");
       std::map<std::string, bool> selectionMap;
       for (int i = 0; i < (int)mSelection.length(); ++i) {
         MFnDagNode dagNode(mSelection[i]);
@@ -216,6 +252,7 @@ MStatus AlembicWriteJob::PreProcess()
     }
 
     // create object for each
+    ESS_PROFILE_SCOPE("AlembicWriteJob::PreProcess create objects");
     MProgressWindow::reserve();
     MProgressWindow::setTitle("Alembic Export: Listing objects");
     MProgressWindow::setInterruptable(true);
@@ -604,73 +641,75 @@ MStatus AlembicExportCommand::doIt(const MArgList &args)
       }
 
       // now check the object strings
-      for (unsigned int k = 0; k < objectStrings.length(); k++) {
-        MSelectionList sl;
-        MString objectString = objectStrings[k];
-        sl.add(objectString);
-        MDagPath dag;
-        for (unsigned int l = 0; l < sl.length(); l++) {
-          sl.getDagPath(l, dag);
-          MObject objRef = dag.node();
-          if (objRef.isNull()) {
-            MGlobal::displayWarning("[ExocortexAlembic] Skipping object '" +
-                                    objectStrings[k] + "', not found.");
-            break;
-          }
-
-          // get all parents
-          MObjectArray parents;
-
-          // check if this is a camera
-          bool isCamera = false;
-          for (unsigned int m = 0; m < dag.childCount(); ++m) {
-            MFnDagNode child(dag.child(m));
-            MFn::Type ctype = child.object().apiType();
-            if (ctype == MFn::kCamera) {
-              isCamera = true;
+      {
+        ESS_PROFILE_SCOPE("AlembicExportCommand::doIt collect objects");
+        // the objects added to the job, and the ones whose parents are all in
+        MObjectHashSet addedObjects;
+        MObjectHashSet addedParents;
+        for (unsigned int k = 0; k < objectStrings.length(); k++) {
+          MSelectionList sl;
+          MString objectString = objectStrings[k];
+          sl.add(objectString);
+          MDagPath dag;
+          for (unsigned int l = 0; l < sl.length(); l++) {
+            sl.getDagPath(l, dag);
+            MObject objRef = dag.node();
+            if (objRef.isNull()) {
+              MGlobal::displayWarning("[ExocortexAlembic] Skipping object '" +
+                                      objectStrings[k] + "', not found.");
               break;
             }
-          }
 
-          if (dag.node().apiType() == MFn::kTransform && !isCamera &&
-              !globalspace && !withouthierarchy) {
-            MDagPath ppath = dag;
-            while (!ppath.node().isNull() && ppath.length() > 0 &&
-                   ppath.isValid()) {
-              parents.append(ppath.node());
-              if (ppath.pop() != MStatus::kSuccess) {
-                break;
+            // one pass over the children, to check if this is a camera and
+            // to find the shapes below
+            bool isCamera = false;
+            MObjectArray shapes;
+            for (unsigned int m = 0; m < dag.childCount(); ++m) {
+              MFnDagNode child(dag.child(m));
+              if (child.object().apiType() == MFn::kCamera) {
+                isCamera = true;
+              }
+              if (!child.isIntermediateObject()) {
+                shapes.append(child.object());
               }
             }
-          }
-          else {
-            parents.append(dag.node());
-          }
 
-          // push all parents in
-          while (parents.length() > 0) {
-            bool found = false;
-            for (unsigned int m = 0; m < objects.length(); m++) {
-              if (objects[m] == parents[parents.length() - 1]) {
-                found = true;
-                break;
+            // get all parents, up to the first one added with its parents
+            MObjectArray parents;
+            if (dag.node().apiType() == MFn::kTransform && !isCamera &&
+                !globalspace && !withouthierarchy) {
+              MDagPath ppath = dag;
+              while (!ppath.node().isNull() && ppath.length() > 0 &&
+                     ppath.isValid()) {
+                // the parents of an instance depend on the path
+                if (!addedParents.insert(ppath.node()) &&
+                    !ppath.isInstanced()) {
+                  break;
+                }
+                parents.append(ppath.node());
+                if (ppath.pop() != MStatus::kSuccess) {
+                  break;
+                }
               }
             }
-            if (!found) {
-              objects.append(parents[parents.length() - 1]);
+            else {
+              parents.append(dag.node());
             }
-            parents.remove(parents.length() - 1);
-          }
 
-          // check all of the shapes below
-          if (!transformcache) {
-            sl.getDagPath(l, dag);
-            for (unsigned int m = 0; m < dag.childCount(); m++) {
-              MFnDagNode child(dag.child(m));
-              if (child.isIntermediateObject()) {
-                continue;
+            // push all parents in
+            for (int m = (int)parents.length() - 1; m >= 0; --m) {
+              if (addedObjects.insert(parents[m])) {
+                objects.append(parents[m]);
+              }
+            }
+
+            // check all of the shapes below
+            if (!transformcache) {
+              for (unsigned int m = 0; m < shapes.length(); m++) {
+                if (addedObjects.insert(shapes[m])) {
+                  objects.append(shapes[m]);
+                }
               }
-              objects.append(child.object());
             }
           }
         }
@@ -75,8 +75,9 @@ double getWeightAndIndex(double iFrame,
   if (numSamps == 0)
     numSamps = 1;
 
-  std::pair<Alembic::AbcCoreAbstract::index_t, double> floorIndex =
-    iTime->getFloorIndex(iFrame, numSamps);
+  std::pair<Alembic::AbcCoreAbstract::index_t, double> floorIndex;
+  std::pair<Alembic::AbcCoreAbstract::index_t, double> ceilIndex;
+  iTime->getFloorAndCeilIndex(iFrame, numSamps, floorIndex, ceilIndex);
 
   oIndex = floorIndex.first;
   oCeilIndex = oIndex;
@@ -84,9 +85,6 @@ double getWeightAndIndex(double iFrame,
   if (fabs(iFrame - floorIndex.second) < 0.0001)
     return 0.0;
 
-  std::pair<Alembic::AbcCoreAbstract::index_t, double> ceilIndex =
-    iTime->getCeilIndex(iFrame, numSamps);
-
   if (oIndex == ceilIndex.first)
     return 0.0;
 
@@ -12,6 +12,8 @@
 #include "AlembicSubD.h"
 #include "AlembicTimeControl.h"
 #include "AlembicXform.h"
+#include "CommonParallel.h"
+#include "CommonSamplePrefetcher.h"
 //#include "AlembicNurbs.h"
 #include <maya/MDGMessage.h>
 #include <maya/MFnDependencyNode.h>
@@ -42,6 +44,7 @@ static MCallbackId deleteAllArchivesCallbackOnExitId = 0;
 static void deleteAllArchivesCallback(void *clientData)
 {
   preDestructAllNodes();
+  SamplePrefetcher::shutdown();
   deleteAllArchives();
 }
 
@@ -239,6 +242,8 @@ EC_EXPORT MStatus uninitializePlugin(MObject obj)
     MMessage::removeCallback(deleteAllArchivesCallbackOnExitId);
     deleteAllArchivesCallbackOnExitId = 0;
   }
+  SamplePrefetcher::shutdown();
+  shutdownParallelPool();
 
   status = plugin.deregisterCommand("ExocortexAlembic_export");
   status = plugin.deregisterCommand("ExocortexAlembic_getInfo");
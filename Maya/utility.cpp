@@ -361,6 +361,7 @@ MSyntax AlembicProfileBeginCommand::createSyntax()
 {
   MSyntax syntax;
   syntax.addFlag("-f", "-fileNameArg", MSyntax::kString);
+  syntax.addFlag("-t", "-trace", MSyntax::kBoolean);
   syntax.enableQuery(false);
   syntax.enableEdit(false);
 
@@ -377,6 +378,14 @@ MStatus AlembicProfileBeginCommand::doIt(const MArgList& args)
 #ifdef ESS_PROFILING
   MArgParser argData(syntax(), args, &status);
 
+  // -t starts or stops recording the spans exported by profileStats -f
+  if (argData.isFlagSet("trace")) {
+    Profiling::setTraceEnabled(argData.flagArgumentBool("trace", 0));
+    if (!argData.isFlagSet("fileNameArg")) {
+      return status;
+    }
+  }
+
   if (!argData.isFlagSet("fileNameArg")) {
     // TODO: display dialog
     MGlobal::displayError("[ExocortexAlembic] No fileName specified.");
@@ -437,6 +446,7 @@ MStatus AlembicProfileEndCommand::doIt(const MArgList& args)
 MSyntax AlembicProfileStatsCommand::createSyntax()
 {
   MSyntax syntax;
+  syntax.addFlag("-f", "-fileNameArg", MSyntax::kString);
   syntax.enableQuery(false);
   syntax.enableEdit(false);
 
@@ -449,6 +459,15 @@ MStatus AlembicProfileStatsCommand::doIt(const MArgList& args)
 
   ESS_PROFILE_REPORT();
 
+#ifdef ESS_PROFILING
+  // also write the timeline for chrome://tracing if asked to
+  MArgParser argData(syntax(), args, &status);
+  if (argData.isFlagSet("fileNameArg")) {
+    MString fileName = argData.flagArgumentString("fileNameArg", 0);
+    ESS_PROFILE_EXPORT_TRACE(fileName.asChar());
+  }
+#endif
+
   return status;
 }
 
@@ -465,6 +484,7 @@ MStatus AlembicProfileResetCommand::doIt(const MArgList& args)
 {
 #ifdef ESS_PROFILING
   nameToProfiler.clear();
+  Profiling::reset();
 #endif
   return MS::kSuccess;
 }
@@ -0,0 +1,758 @@
+#include "stdafx.h"
+
+#include "archivecopy.h"
+#include "extension.h"
+#include "iarchive.h"
+#include "oarchive.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+static const size_t kNoParent = (size_t)-1;
+
+struct copyOptions {
+  std::vector<std::string> inputs;
+  std::string output;
+  std::string filter;
+  std::string notFilter;
+  std::string typeFilter;
+  std::string notTypeFilter;
+  double scale;
+  double offset;
+  double frameTime;
+  bool ogawa;
+  size_t threads;
+};
+
+struct copyStats {
+  size_t objects;
+  size_t properties;
+  size_t samples;
+  size_t reused;
+};
+
+// an object of the output, with the matching object of each input, NULL for
+// the inputs which don't have it
+struct copyObject {
+  size_t parent;
+  std::vector<AbcA::ObjectReaderPtr> readers;
+  AbcA::ObjectWriterPtr writer;
+};
+
+// a property of the output. The parent is kNoParent for the top properties of
+// the object, compounds have no samples
+struct copyProperty {
+  size_t object;
+  size_t parent;
+  AbcA::PropertyHeader header;
+  std::vector<AbcA::BasePropertyReaderPtr> readers;
+  AbcA::BasePropertyWriterPtr writer;
+
+  // the input and sample index of each output sample
+  std::vector<std::pair<size_t, AbcA::index_t> > samples;
+};
+
+// an object of the first input while walking the hierarchy, it only gets
+// copied once it or one of its children passes the filters
+struct pendingObject {
+  pendingObject *parent;
+  std::vector<AbcA::ObjectReaderPtr> readers;
+  size_t index;
+};
+
+// storage for one scalar sample, strings can't be read as raw bytes
+class scalarSample {
+ public:
+  scalarSample(const AbcA::DataType &dataType)
+  {
+    if (dataType.getPod() == Alembic::Util::kStringPOD) {
+      m_strings.resize(dataType.getExtent());
+    }
+    else if (dataType.getPod() == Alembic::Util::kWstringPOD) {
+      m_wstrings.resize(dataType.getExtent());
+    }
+    else {
+      m_bytes.resize(dataType.getNumBytes());
+    }
+  }
+
+  void *data()
+  {
+    if (!m_strings.empty()) {
+      return &m_strings[0];
+    }
+    if (!m_wstrings.empty()) {
+      return &m_wstrings[0];
+    }
+    return &m_bytes[0];
+  }
+
+  bool operator==(const scalarSample &other) const
+  {
+    return m_bytes == other.m_bytes && m_strings == other.m_strings &&
+           m_wstrings == other.m_wstrings;
+  }
+
+  void swap(scalarSample &other)
+  {
+    m_bytes.swap(other.m_bytes);
+    m_strings.swap(other.m_strings);
+    m_wstrings.swap(other.m_wstrings);
+  }
+
+ private:
+  std::vector<char> m_bytes;
+  std::vector<std::string> m_strings;
+  std::vector<std::wstring> m_wstrings;
+};
+
+static size_t getNumSamples(const AbcA::BasePropertyReaderPtr &reader)
+{
+  if (!reader || reader->isCompound()) {
+    return 0;
+  }
+  if (reader->isScalar()) {
+    return reader->asScalarPtr()->getNumSamples();
+  }
+  return reader->asArrayPtr()->getNumSamples();
+}
+
+static AbcA::TimeSamplingPtr getTimeSampling(
+    const AbcA::BasePropertyReaderPtr &reader)
+{
+  if (reader->isScalar()) {
+    return reader->asScalarPtr()->getTimeSampling();
+  }
+  return reader->asArrayPtr()->getTimeSampling();
+}
+
+// maps t to t * scale + t0 * (1 - scale) + offset, the scaling is anchored on
+// the first sample time t0 like retimeABC.py used to do
+static AbcA::chrono_t retimeSample(AbcA::chrono_t time, AbcA::chrono_t first,
+                                   double scale, double offset)
+{
+  return time * scale + first * (1.0 - scale) + offset;
+}
+
+// moves the time sampling by shift then retimes it around its first sample,
+// uniform and cyclic samplings stay uniform and cyclic
+static AbcA::TimeSampling retime(const AbcA::TimeSampling &ts, double shift,
+                                 double scale, double offset)
+{
+  std::vector<AbcA::chrono_t> times = ts.getStoredTimes();
+  const AbcA::chrono_t first = times.empty() ? 0.0 : times[0] + shift;
+  for (size_t i = 0; i < times.size(); ++i) {
+    times[i] = retimeSample(times[i] + shift, first, scale, offset);
+  }
+
+  AbcA::TimeSamplingType type = ts.getTimeSamplingType();
+  if (type.isUniform()) {
+    type = AbcA::TimeSamplingType(type.getTimePerCycle() * scale);
+  }
+  else if (type.isCyclic()) {
+    type = AbcA::TimeSamplingType(type.getNumSamplesPerCycle(),
+                                  type.getTimePerCycle() * scale);
+  }
+  return AbcA::TimeSampling(type, times);
+}
+
+static bool contains(const std::string &str, const std::string &part)
+{
+  return str.find(part) != std::string::npos;
+}
+
+/**
+ * Copies the hierarchy of the first input into the output. The other inputs
+ * are appended in time, their objects and properties are matched by name and
+ * the ones missing from the first input are ignored.
+ *
+ * The hierarchy is walked first, then all the writers get created in the
+ * order of the first input, then the samples are copied by several threads,
+ * one property at a time. Every call into the writer is done under a lock,
+ * the samples are read outside of it. Array samples with the same key as the
+ * previous sample are not read at all, the Ogawa writer de-duplicates the
+ * others by their content hash.
+ */
+class archiveCopier {
+ public:
+  archiveCopier(const copyOptions &options)
+      : m_options(options), m_nextJob(0), m_failed(false)
+  {
+    m_stats.objects = 0;
+    m_stats.properties = 0;
+    m_stats.samples = 0;
+    m_stats.reused = 0;
+  }
+
+  copyStats run()
+  {
+    openArchives();
+    walk();
+    createWriters();
+    copySamples();
+
+    // the property writers keep their parents alive, the archive gets
+    // written once the last of them is gone
+    m_properties.clear();
+    m_objects.clear();
+    m_output.reset();
+    m_inputs.clear();
+    m_hashTypes.clear();
+    return m_stats;
+  }
+
+ private:
+  void openArchives()
+  {
+    AbcF::IFactory iFactory;
+    iFactory.setOgawaNumStreams(m_options.threads);
+    for (size_t i = 0; i < m_options.inputs.size(); ++i) {
+      AbcF::IFactory::CoreType oType;
+      Abc::IArchive archive = iFactory.getArchive(m_options.inputs[i], oType);
+      if (!archive.valid()) {
+        throw Alembic::Util::Exception("Unable to open " +
+                                       m_options.inputs[i]);
+      }
+      // the HDF5 library can't be used from several threads
+      if (oType != AbcF::IFactory::kOgawa) {
+        m_options.threads = 1;
+      }
+      m_inputs.push_back(archive.getPtr());
+      m_hashTypes.push_back(
+          AbcA::GetArraySampleHashType(archive.getPtr()->getMetaData()));
+    }
+
+    const AbcA::MetaData &md = m_inputs[0]->getMetaData();
+    if (m_options.ogawa) {
+      m_output = Alembic::AbcCoreOgawa::WriteArchive()(m_options.output, md);
+    }
+    else {
+      m_output =
+          Alembic::AbcCoreHDF5::WriteArchive(true)(m_options.output, md);
+    }
+  }
+
+  bool isFiltered(const AbcA::ObjectHeader &header) const
+  {
+    const std::string &identifier = header.getFullName();
+    const std::string type = header.getMetaData().get("schema");
+    return (m_options.filter.empty() ||
+            contains(identifier, m_options.filter)) &&
+           (m_options.notFilter.empty() ||
+            !contains(identifier, m_options.notFilter)) &&
+           (m_options.typeFilter.empty() ||
+            contains(type, m_options.typeFilter)) &&
+           (m_options.notTypeFilter.empty() ||
+            !contains(type, m_options.notTypeFilter));
+  }
+
+  void walk()
+  {
+    pendingObject top;
+    top.parent = NULL;
+    for (size_t i = 0; i < m_inputs.size(); ++i) {
+      top.readers.push_back(m_inputs[i]->getTop());
+    }
+    top.index = 0;
+
+    copyObject object;
+    object.parent = kNoParent;
+    object.readers = top.readers;
+    m_objects.push_back(object);
+    addProperties(0, kNoParent, objectProperties(top.readers));
+
+    walk(top);
+  }
+
+  void walk(pendingObject &node)
+  {
+    const AbcA::ObjectReaderPtr &reader = node.readers[0];
+    for (size_t i = 0; i < reader->getNumChildren(); ++i) {
+      pendingObject child;
+      child.parent = &node;
+      child.index = kNoParent;
+      child.readers.push_back(reader->getChild(i));
+
+      const std::string &name = child.readers[0]->getName();
+      for (size_t k = 1; k < node.readers.size(); ++k) {
+        AbcA::ObjectReaderPtr other;
+        if (node.readers[k] && node.readers[k]->getChildHeader(name)) {
+          other = node.readers[k]->getChild(name);
+        }
+        child.readers.push_back(other);
+      }
+
+      if (isFiltered(child.readers[0]->getHeader())) {
+        claim(child);
+      }
+      walk(child);
+    }
+  }
+
+  // the parents of the filtered objects are copied as well, with their
+  // properties, so their transforms still apply
+  size_t claim(pendingObject &node)
+  {
+    if (node.index == kNoParent) {
+      copyObject object;
+      object.parent = claim(*node.parent);
+      object.readers = node.readers;
+      node.index = m_objects.size();
+      m_objects.push_back(object);
+      m_stats.objects++;
+
+      addProperties(node.index, kNoParent, objectProperties(node.readers));
+    }
+    return node.index;
+  }
+
+  static std::vector<AbcA::CompoundPropertyReaderPtr> objectProperties(
+      const std::vector<AbcA::ObjectReaderPtr> &readers)
+  {
+    std::vector<AbcA::CompoundPropertyReaderPtr> properties;
+    for (size_t k = 0; k < readers.size(); ++k) {
+      properties.push_back(readers[k] ? readers[k]->getProperties()
+                                      : AbcA::CompoundPropertyReaderPtr());
+    }
+    return properties;
+  }
+
+  void addProperties(
+      size_t object, size_t parent,
+      const std::vector<AbcA::CompoundPropertyReaderPtr> &readers)
+  {
+    const AbcA::CompoundPropertyReaderPtr &reader = readers[0];
+    for (size_t i = 0; i < reader->getNumProperties(); ++i) {
+      copyProperty prop;
+      prop.object = object;
+      prop.parent = parent;
+      prop.header = reader->getPropertyHeader(i);
+
+      const std::string &name = prop.header.getName();
+      prop.readers.push_back(reader->getProperty(name));
+      for (size_t k = 1; k < readers.size(); ++k) {
+        const AbcA::PropertyHeader *other =
+            readers[k] ? readers[k]->getPropertyHeader(name) : NULL;
+        if (other == NULL) {
+          prop.readers.push_back(AbcA::BasePropertyReaderPtr());
+          continue;
+        }
+        if (other->getPropertyType() != prop.header.getPropertyType() ||
+            (!other->isCompound() &&
+             !(other->getDataType() == prop.header.getDataType()))) {
+          throw Alembic::Util::Exception(
+              "Property " + name + " of " +
+              readers[k]->getObject()->getFullName() +
+              " doesn't have the same type in " + m_options.inputs[k]);
+        }
+        prop.readers.push_back(readers[k]->getProperty(name));
+      }
+
+      const size_t index = m_properties.size();
+      m_properties.push_back(prop);
+
+      if (prop.header.isCompound()) {
+        std::vector<AbcA::CompoundPropertyReaderPtr> children;
+        for (size_t k = 0; k < prop.readers.size(); ++k) {
+          children.push_back(prop.readers[k]
+                                 ? prop.readers[k]->asCompoundPtr()
+                                 : AbcA::CompoundPropertyReaderPtr());
+        }
+        addProperties(object, index, children);
+      }
+      else {
+        m_stats.properties++;
+      }
+    }
+  }
+
+  // every input starts one frame after the end of the previous one
+  void computeShifts()
+  {
+    const size_t nbInputs = m_inputs.size();
+    std::vector<double> starts(nbInputs, DBL_MAX);
+    std::vector<double> ends(nbInputs, -DBL_MAX);
+    for (size_t i = 0; i < m_properties.size(); ++i) {
+      const copyProperty &prop = m_properties[i];
+      for (size_t k = 0; k < prop.readers.size(); ++k) {
+        const size_t nbSamples = getNumSamples(prop.readers[k]);
+        if (nbSamples > 0) {
+          AbcA::TimeSamplingPtr ts = getTimeSampling(prop.readers[k]);
+          starts[k] = std::min(starts[k], ts->getSampleTime(0));
+          ends[k] = std::max(ends[k], ts->getSampleTime(nbSamples - 1));
+        }
+      }
+    }
+
+    m_shifts.assign(nbInputs, 0.0);
+    double end = ends[0] == -DBL_MAX ? 0.0 : ends[0];
+    for (size_t k = 1; k < nbInputs; ++k) {
+      if (starts[k] == DBL_MAX) {
+        continue;
+      }
+      m_shifts[k] = end + m_options.frameTime - starts[k];
+      end = ends[k] + m_shifts[k];
+    }
+  }
+
+  // picks the samples of the inputs and returns the output time sampling
+  AbcA::TimeSampling computeSamples(copyProperty &prop) const
+  {
+    std::vector<size_t> inputs;
+    bool animated = false;
+    for (size_t k = 0; k < prop.readers.size(); ++k) {
+      const size_t nbSamples = getNumSamples(prop.readers[k]);
+      if (nbSamples > 0) {
+        inputs.push_back(k);
+        animated = animated || nbSamples > 1;
+      }
+    }
+
+    if (inputs.empty()) {
+      return retime(*getTimeSampling(prop.readers[0]), 0.0, m_options.scale,
+                    m_options.offset);
+    }
+
+    // constant properties only keep the sample of the first input
+    if (inputs.size() == 1 || !animated) {
+      const size_t k = inputs[0];
+      const size_t nbSamples = animated ? getNumSamples(prop.readers[k]) : 1;
+      for (size_t j = 0; j < nbSamples; ++j) {
+        prop.samples.push_back(std::make_pair(k, (AbcA::index_t)j));
+      }
+      return retime(*getTimeSampling(prop.readers[k]), m_shifts[k],
+                    m_options.scale, m_options.offset);
+    }
+
+    // otherwise the samples are appended, the ones overlapping the previous
+    // inputs are dropped
+    std::vector<AbcA::chrono_t> times;
+    double first = 0.0;
+    double last = -DBL_MAX;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const size_t k = inputs[i];
+      AbcA::TimeSamplingPtr ts = getTimeSampling(prop.readers[k]);
+      const size_t nbSamples = getNumSamples(prop.readers[k]);
+      for (size_t j = 0; j < nbSamples; ++j) {
+        const double time = ts->getSampleTime((AbcA::index_t)j) + m_shifts[k];
+        if (time <= last) {
+          continue;
+        }
+        if (times.empty()) {
+          first = time;
+        }
+        last = time;
+        prop.samples.push_back(std::make_pair(k, (AbcA::index_t)j));
+        times.push_back(time);
+      }
+    }
+    for (size_t i = 0; i < times.size(); ++i) {
+      times[i] = retimeSample(times[i], first, m_options.scale,
+                              m_options.offset);
+    }
+    return AbcA::TimeSampling(
+        AbcA::TimeSamplingType(AbcA::TimeSamplingType::kAcyclic), times);
+  }
+
+  void createWriters()
+  {
+    computeShifts();
+
+    m_objects[0].writer = m_output->getTop();
+    for (size_t i = 1; i < m_objects.size(); ++i) {
+      copyObject &object = m_objects[i];
+      const AbcA::ObjectHeader &header = object.readers[0]->getHeader();
+      object.writer = m_objects[object.parent].writer->createChild(
+          AbcA::ObjectHeader(header.getName(), header.getMetaData()));
+    }
+
+    for (size_t i = 0; i < m_properties.size(); ++i) {
+      copyProperty &prop = m_properties[i];
+      AbcA::CompoundPropertyWriterPtr parent =
+          prop.parent == kNoParent
+              ? m_objects[prop.object].writer->getProperties()
+              : m_properties[prop.parent].writer->asCompoundPtr();
+
+      const std::string &name = prop.header.getName();
+      const AbcA::MetaData &md = prop.header.getMetaData();
+      if (prop.header.isCompound()) {
+        prop.writer = parent->createCompoundProperty(name, md);
+        continue;
+      }
+
+      const Alembic::Util::uint32_t tsIndex =
+          m_output->addTimeSampling(computeSamples(prop));
+      if (prop.header.isArray()) {
+        prop.writer = parent->createArrayProperty(
+            name, md, prop.header.getDataType(), tsIndex);
+      }
+      else {
+        prop.writer = parent->createScalarProperty(
+            name, md, prop.header.getDataType(), tsIndex);
+      }
+      m_jobs.push_back(i);
+    }
+  }
+
+  // the longest properties go first, so a big one isn't left for the end
+  struct moreSamples {
+    moreSamples(const std::vector<copyProperty> &properties)
+        : m_properties(properties)
+    {
+    }
+    bool operator()(size_t a, size_t b) const
+    {
+      return m_properties[a].samples.size() > m_properties[b].samples.size();
+    }
+    const std::vector<copyProperty> &m_properties;
+  };
+
+  void copySamples()
+  {
+    std::stable_sort(m_jobs.begin(), m_jobs.end(), moreSamples(m_properties));
+
+    const size_t nbThreads = std::min(m_options.threads, m_jobs.size());
+    if (nbThreads <= 1) {
+      worker();
+    }
+    else {
+      boost::thread_group threads;
+      for (size_t i = 0; i < nbThreads; ++i) {
+        threads.create_thread(boost::bind(&archiveCopier::worker, this));
+      }
+      threads.join_all();
+    }
+
+    if (m_failed) {
+      throw Alembic::Util::Exception(m_error);
+    }
+  }
+
+  void worker()
+  {
+    try {
+      for (;;) {
+        size_t job;
+        {
+          boost::mutex::scoped_lock lock(m_jobLock);
+          if (m_failed || m_nextJob == m_jobs.size()) {
+            return;
+          }
+          job = m_jobs[m_nextJob++];
+        }
+
+        copyProperty &prop = m_properties[job];
+        size_t reused = 0;
+        if (prop.header.isArray()) {
+          reused = copyArray(prop);
+        }
+        else {
+          reused = copyScalar(prop);
+        }
+
+        boost::mutex::scoped_lock lock(m_jobLock);
+        m_stats.samples += prop.samples.size();
+        m_stats.reused += reused;
+      }
+    }
+    catch (std::exception &e) {
+      boost::mutex::scoped_lock lock(m_jobLock);
+      if (!m_failed) {
+        m_failed = true;
+        m_error = e.what();
+      }
+    }
+  }
+
+  size_t copyArray(const copyProperty &prop)
+  {
+    AbcA::ArrayPropertyWriterPtr writer = prop.writer->asArrayPtr();
+    AbcA::ArraySampleKey previousKey;
+    AbcA::ArraySampleHashType previousHashType = AbcA::kMurmur3Hash;
+    bool hasPrevious = false;
+    size_t reused = 0;
+    for (size_t i = 0; i < prop.samples.size(); ++i) {
+      AbcA::ArrayPropertyReaderPtr reader =
+          prop.readers[prop.samples[i].first]->asArrayPtr();
+      const AbcA::index_t index = prop.samples[i].second;
+
+      AbcA::ArraySampleKey key;
+      const bool hasKey = reader->getKey(index, key);
+      const AbcA::ArraySampleHashType hashType =
+          m_hashTypes[prop.samples[i].first];
+      if (hasPrevious && hasKey && hashType == previousHashType &&
+          key == previousKey) {
+        boost::mutex::scoped_lock lock(m_writeLock);
+        writer->setFromPreviousSample();
+        reused++;
+        continue;
+      }
+
+      AbcA::ArraySamplePtr sample;
+      reader->getSample(index, sample);
+      {
+        boost::mutex::scoped_lock lock(m_writeLock);
+        writer->setSample(*sample);
+      }
+      previousKey = key;
+      previousHashType = hashType;
+      hasPrevious = hasKey;
+    }
+    return reused;
+  }
+
+  size_t copyScalar(const copyProperty &prop)
+  {
+    AbcA::ScalarPropertyWriterPtr writer = prop.writer->asScalarPtr();
+    scalarSample sample(prop.header.getDataType());
+    scalarSample previous(prop.header.getDataType());
+    size_t reused = 0;
+    for (size_t i = 0; i < prop.samples.size(); ++i) {
+      AbcA::ScalarPropertyReaderPtr reader =
+          prop.readers[prop.samples[i].first]->asScalarPtr();
+      reader->getSample(prop.samples[i].second, sample.data());
+
+      boost::mutex::scoped_lock lock(m_writeLock);
+      if (i > 0 && sample == previous) {
+        writer->setFromPreviousSample();
+        reused++;
+      }
+      else {
+        writer->setSample(sample.data());
+      }
+      sample.swap(previous);
+    }
+    return reused;
+  }
+
+  copyOptions m_options;
+  copyStats m_stats;
+
+  std::vector<AbcA::ArchiveReaderPtr> m_inputs;
+  // keys of samples from inputs with different hash types can't be compared
+  std::vector<AbcA::ArraySampleHashType> m_hashTypes;
+  std::vector<double> m_shifts;
+  AbcA::ArchiveWriterPtr m_output;
+
+  std::vector<copyObject> m_objects;
+  std::vector<copyProperty> m_properties;
+
+  // indices of the scalar and array properties, in copy order
+  std::vector<size_t> m_jobs;
+  size_t m_nextJob;
+  bool m_failed;
+  std::string m_error;
+  boost::mutex m_jobLock;
+
+  // one call into the writer at a time
+  boost::mutex m_writeLock;
+};
+
+PyObject *ArchiveCopy_copy(PyObject *self, PyObject *args, PyObject *kwds)
+{
+  ALEMBIC_TRY_STATEMENT
+  static char *kwlist[] = {(char *)"src",        (char *)"dst",
+                           (char *)"filter",     (char *)"notFilter",
+                           (char *)"typeFilter", (char *)"notTypeFilter",
+                           (char *)"scale",      (char *)"offset",
+                           (char *)"frameTime",  (char *)"ogawa",
+                           (char *)"threads",    NULL};
+
+  PyObject *pySrc = NULL;
+  char *dst = NULL;
+  char *filter = NULL;
+  char *notFilter = NULL;
+  char *typeFilter = NULL;
+  char *notTypeFilter = NULL;
+  double scale = 1.0;
+  double offset = 0.0;
+  double frameTime = 1.0 / 24.0;
+  PyObject *pyOgawa = NULL;
+  int threads = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "Os|zzzzdddOi", kwlist, &pySrc,
+                                   &dst, &filter, &notFilter, &typeFilter,
+                                   &notTypeFilter, &scale, &offset, &frameTime,
+                                   &pyOgawa, &threads)) {
+    return NULL;
+  }
+
+  copyOptions options;
+  if (PyString_Check(pySrc)) {
+    options.inputs.push_back(PyString_AsString(pySrc));
+  }
+  else if (PyList_Check(pySrc) || PyTuple_Check(pySrc)) {
+    const Py_ssize_t nbInputs = PySequence_Size(pySrc);
+    for (Py_ssize_t i = 0; i < nbInputs; ++i) {
+      PyObject *item = PySequence_GetItem(pySrc, i);
+      if (!PyString_Check(item)) {
+        Py_DECREF(item);
+        PyErr_SetString(getError(), "The input filenames must be strings!");
+        return NULL;
+      }
+      options.inputs.push_back(PyString_AsString(item));
+      Py_DECREF(item);
+    }
+  }
+  if (options.inputs.empty()) {
+    PyErr_SetString(getError(), "No input filename specified!");
+    return NULL;
+  }
+
+  options.output = dst;
+  if (isIArchiveOpened(options.output) || isOArchiveOpened(options.output)) {
+    PyErr_SetString(getError(), "This archive is already opened");
+    return NULL;
+  }
+
+  bool allOgawa = true;
+  for (size_t i = 0; i < options.inputs.size(); ++i) {
+    if (options.inputs[i] == options.output) {
+      PyErr_SetString(getError(),
+                      "The output filename must be distinct from all the "
+                      "input files");
+      return NULL;
+    }
+    if (!boost::filesystem::exists(options.inputs[i])) {
+      PyErr_SetString(getError(), "File does not exist!");
+      return NULL;
+    }
+    allOgawa = allOgawa && isOgawaFile(options.inputs[i]);
+  }
+
+  if (scale <= 0.0) {
+    PyErr_SetString(getError(), "The scale factor must be greater than zero");
+    return NULL;
+  }
+
+  options.filter = filter ? filter : "";
+  options.notFilter = notFilter ? notFilter : "";
+  options.typeFilter = typeFilter ? typeFilter : "";
+  options.notTypeFilter = notTypeFilter ? notTypeFilter : "";
+  options.scale = scale;
+  options.offset = offset;
+  options.frameTime = frameTime;
+  options.ogawa = pyOgawa ? PyObject_IsTrue(pyOgawa) != 0 : true;
+  options.threads =
+      threads > 0 ? (size_t)threads
+                  : std::max<size_t>(1, boost::thread::hardware_concurrency());
+
+  copyStats stats;
+  try {
+    AllowThreads allowThreads(allOgawa && options.ogawa);
+    archiveCopier copier(options);
+    stats = copier.run();
+  }
+  catch (Alembic::Util::Exception &) {
+    throw;
+  }
+  catch (std::exception &e) {
+    throw Alembic::Util::Exception(e.what());
+  }
+
+  return Py_BuildValue("{s:n,s:n,s:n,s:n}", "objects",
+                       (Py_ssize_t)stats.objects, "properties",
+                       (Py_ssize_t)stats.properties, "samples",
+                       (Py_ssize_t)stats.samples, "reused",
+                       (Py_ssize_t)stats.reused);
+  ALEMBIC_PYOBJECT_CATCH_STATEMENT
+}
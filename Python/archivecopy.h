@@ -0,0 +1,11 @@
+#ifndef _PYTHON_ALEMBIC_ARCHIVECOPY_H_
+#define _PYTHON_ALEMBIC_ARCHIVECOPY_H_
+
+/**
+ * alembic.copyArchive(src, dst, ...), copies, filters, retimes or concatenates
+ * archives without going through python objects. The samples are streamed one
+ * property at a time, the properties are copied by several threads.
+ */
+PyObject *ArchiveCopy_copy(PyObject *self, PyObject *args, PyObject *kwds);
+
+#endif
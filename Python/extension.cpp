@@ -1,7 +1,9 @@
 #include "stdafx.h"
 
 #include "extension.h"
+#include "archivecopy.h"
 #include "iarchive.h"
+#include "iarraysample.h"
 #include "icompoundproperty.h"
 #include "iobject.h"
 #include "iproperty.h"
@@ -93,6 +95,21 @@ static PyMethodDef extension_methods[] = {
      "Appendix B."},
     {"createTimeSampling", (PyCFunction)TimeSampling_new, METH_VARARGS,
      "Returns a new Time Sampling"},
+    {"copyArchive", (PyCFunction)ArchiveCopy_copy,
+     METH_VARARGS | METH_KEYWORDS,
+     "copyArchive(src, dst, filter=None, notFilter=None, typeFilter=None, "
+     "notTypeFilter=None, scale=1.0, offset=0.0, frameTime=1.0/24.0, "
+     "ogawa=True, threads=0)\n"
+     "Copies the archive src into dst without going through python objects. "
+     "src can be a list of filenames, the archives are then concatenated, "
+     "each one starting frameTime after the end of the previous one. The "
+     "filters keep the objects whose identifier or type contains, or doesn't "
+     "contain, the given string, with their parents. The times are mapped to "
+     "t * scale + t0 * (1 - scale) + offset, t0 being the first sample time "
+     "of each time sampling. threads is the number of threads copying the "
+     "properties, 0 for one per core. Returns a dictionary with the number "
+     "of objects, properties and samples copied, and the number of samples "
+     "reused from the previous sample."},
     {NULL, NULL}};
 
 static PyMethodDef unlicensed_extension_methods[] = {{NULL, NULL}};
@@ -110,9 +127,35 @@ bool register_object(PyObject* module, PyTypeObject& type_object,
   return true;
 }
 
+AllowThreads::AllowThreads(bool release, boost::mutex *lock)
+    : mState(NULL), mLock(lock)
+{
+  if (release) {
+    mState = PyEval_SaveThread();
+  }
+  if (mLock) {
+    mLock->lock();
+  }
+}
+
+AllowThreads::~AllowThreads()
+{
+  // never wait for the GIL while holding the lock, a thread owning the GIL
+  // might be waiting for that lock
+  if (mLock) {
+    mLock->unlock();
+  }
+  if (mState) {
+    PyEval_RestoreThread(mState);
+  }
+}
+
 #include <stdio.h>
 EXTENSION_CALLBACK init_ExocortexAlembicPython(void)
 {
+  // the GIL gets released around the reads and writes of Ogawa archives
+  PyEval_InitThreads();
+
   PyObject* m =
       Py_InitModule3("_ExocortexAlembicPython", extension_methods,
                      "This is the core extension module. It provides access to "
@@ -124,6 +167,7 @@ EXTENSION_CALLBACK init_ExocortexAlembicPython(void)
   reg = reg && register_object_iProperty(m);
   reg = reg && register_object_iCompoundProperty(m);
   reg = reg && register_object_iXformProperty(m);
+  reg = reg && register_object_iArraySample(m);
 
   reg = reg && register_object_oArchive(m);
   reg = reg && register_object_oObject(m);
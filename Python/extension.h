@@ -3,6 +3,8 @@
 
 #include "Python.h"
 
+#include <boost/thread/mutex.hpp>
+
 #define ABCPY_VERSION_FIRST 11000
 #define ABCPY_VERSION_CURRENT 11000
 #define ALEMBIC_VERSION 11000
@@ -21,4 +23,23 @@ PyObject *getError();
 bool register_object(PyObject *module, PyTypeObject &type_object,
                      const char *object_name);
 
+/**
+ * Releases the GIL for the lifetime of the object, so other python threads
+ * keep running while Alembic reads or writes. The optional lock is taken once
+ * the GIL is released. No python API may be used while the object exists.
+ *
+ * Only Ogawa archives can be accessed from several threads, the HDF5 library
+ * isn't thread safe. Calls on HDF5 archives pass release = false and keep the
+ * GIL, which then serializes everything touching HDF5.
+ */
+class AllowThreads {
+ public:
+  AllowThreads(bool release, boost::mutex *lock = NULL);
+  ~AllowThreads();
+
+ private:
+  PyThreadState *mState;
+  boost::mutex *mLock;
+};
+
 #endif
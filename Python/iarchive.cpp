@@ -7,17 +7,41 @@
 #include "oarchive.h"
 #include "timesampling.h"
 
-typedef std::set<std::string> str_set;
+#include <boost/thread/thread.hpp>
 
-static str_set iArchive_filenames;
+// the opened files and their core type
+typedef std::map<std::string, AbcF::IFactory::CoreType> str_map;
+
+static str_map iArchive_filenames;
 bool isIArchiveOpened(std::string filename)
 {
   return iArchive_filenames.find(filename) != iArchive_filenames.end();
 }
 
-static bool setIArchiveOpened(std::string filename)
+bool isIArchiveOgawa(const std::string &filename)
+{
+  str_map::const_iterator it = iArchive_filenames.find(filename);
+  return it != iArchive_filenames.end() &&
+         it->second == AbcF::IFactory::kOgawa;
+}
+
+bool isOgawaFile(const std::string &filename)
+{
+  FILE *file = fopen(filename.c_str(), "rb");
+  if (file == NULL) {
+    return false;
+  }
+  char magic[5] = {0};
+  const bool isOgawa =
+      fread(magic, 1, 5, file) == 5 && memcmp(magic, "Ogawa", 5) == 0;
+  fclose(file);
+  return isOgawa;
+}
+
+static void setIArchiveOpened(std::string filename,
+                              AbcF::IFactory::CoreType oType)
 {
-  return iArchive_filenames.insert(filename).second;
+  iArchive_filenames[filename] = oType;
 }
 
 static bool setIArchiveClosed(std::string filename)
@@ -44,18 +68,15 @@ static PyObject *iArchive_getVersion(PyObject *self, PyObject *args)
 }
 
 #include <string>
-static void recurseObjectChildren(PyObject *list, const Abc::IObject &obj)
+static void recurseObjectChildren(std::vector<std::string> &names,
+                                  const Abc::IObject &obj)
 {
   const int nbChildren = obj.getNumChildren();
   for (int i = 0; i < nbChildren; ++i) {
     const Abc::IObject child = obj.getChild(i);
-    const std::string fullName = child.getFullName();
+    names.push_back(child.getFullName());
 
-    PyObject *item =
-        PyString_FromStringAndSize(fullName.c_str(), fullName.size());
-    PyList_Append(list, item);
-
-    recurseObjectChildren(list, child);
+    recurseObjectChildren(names, child);
   }
 }
 
@@ -65,8 +86,18 @@ static PyObject *iArchive_getIdentifiers(PyObject *self, PyObject *args)
 
   iArchive *archive = (iArchive *)self;
 
-  PyObject *list = PyList_New(0);
-  recurseObjectChildren(list, archive->mArchive->getTop());
+  // walk the hierarchy without the GIL, then build the list
+  std::vector<std::string> names;
+  {
+    AllowThreads allowThreads(archive->oType == AbcF::IFactory::kOgawa);
+    recurseObjectChildren(names, archive->mArchive->getTop());
+  }
+
+  PyObject *list = PyList_New((Py_ssize_t)names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    PyList_SET_ITEM(
+        list, i, PyString_FromStringAndSize(names[i].c_str(), names[i].size()));
+  }
 
   return list;
 
@@ -172,7 +203,10 @@ static void iArchive_delete(PyObject *self)
   // NEW, remove the filename from the list
   setIArchiveClosed(object->mArchive->getName());
 
-  delete (object->mArchive);
+  {
+    AllowThreads allowThreads(object->oType == AbcF::IFactory::kOgawa);
+    delete (object->mArchive);
+  }
   PyObject_FREE(object);
   gNbIArchives--;
   ALEMBIC_VOID_CATCH_STATEMENT
@@ -201,7 +235,9 @@ static PyTypeObject iArchive_Type = {
     0,                                        /*tp_as_buffer*/
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
     "This is the input archive. It provides access to all of the archive's "
-    "data, including TimeSamplings as well as objects.", /* tp_doc */
+    "data, including TimeSamplings as well as objects. Ogawa archives can be "
+    "read from several threads at once, their samples are read without "
+    "holding the GIL. HDF5 archives keep the GIL.", /* tp_doc */
     0,                                                   /* tp_traverse */
     0,                                                   /* tp_clear */
     0,                                                   /* tp_richcompare */
@@ -241,13 +277,31 @@ PyObject *iArchive_new(PyObject *self, PyObject *args)
     return NULL;
   }
   fclose(file);
+  const bool isOgawa = isOgawaFile(fileName);
 
   iArchive *object = PyObject_NEW(iArchive, &iArchive_Type);
   if (object != NULL) {
+    // one stream per core, so threads reading the same archive don't wait
+    // on each other
     AbcF::IFactory iFactory;
-    object->mArchive =
-        new Abc::IArchive(iFactory.getArchive(fileName, object->oType));
-    setIArchiveOpened(fileName);
+    iFactory.setOgawaNumStreams(
+        std::max<size_t>(1, boost::thread::hardware_concurrency()));
+
+    // claim the filename before releasing the GIL, so other threads can't
+    // open it in the meantime
+    setIArchiveOpened(fileName, AbcF::IFactory::kUnknown);
+    Abc::IArchive archive;
+    try {
+      AllowThreads allowThreads(isOgawa);
+      archive = iFactory.getArchive(fileName, object->oType);
+    }
+    catch (...) {
+      setIArchiveClosed(fileName);
+      PyObject_FREE(object);
+      throw;
+    }
+    object->mArchive = new Abc::IArchive(archive);
+    setIArchiveOpened(fileName, object->oType);
     gNbIArchives++;
   }
   return (PyObject *)object;
@@ -11,6 +11,11 @@ typedef struct {
 PyObject *iArchive_new(PyObject *self, PyObject *args);
 size_t getNbIArchives();
 bool isIArchiveOpened(std::string filename);
+// true for files opened as Ogawa iArchives, those can be read without the GIL
+bool isIArchiveOgawa(const std::string &filename);
+// the factory falls back to HDF5 when Ogawa fails, only files starting with
+// the Ogawa magic can be opened without the GIL
+bool isOgawaFile(const std::string &filename);
 
 bool register_object_iArchive(PyObject *module);
 
@@ -0,0 +1,230 @@
+#include "stdafx.h"
+
+#include "iarraysample.h"
+#include "extension.h"
+
+#ifdef __cplusplus__
+extern "C" {
+#endif
+
+// struct module format of a pod, 0 if it can't be exposed as plain memory.
+// Python 2 has no format for half floats, they are exposed as their raw 16
+// bits, 'H' with an itemsize of 2.
+static char iArraySample_getFormat(AbcA::PlainOldDataType pod)
+{
+  switch (pod) {
+    case Alembic::Util::kBooleanPOD:
+      return '?';
+    case Alembic::Util::kUint8POD:
+      return 'B';
+    case Alembic::Util::kInt8POD:
+      return 'b';
+    case Alembic::Util::kUint16POD:
+      return 'H';
+    case Alembic::Util::kInt16POD:
+      return 'h';
+    case Alembic::Util::kUint32POD:
+      return 'I';
+    case Alembic::Util::kInt32POD:
+      return 'i';
+    case Alembic::Util::kUint64POD:
+      return 'Q';
+    case Alembic::Util::kInt64POD:
+      return 'q';
+    case Alembic::Util::kFloat16POD:
+      return 'H';
+    case Alembic::Util::kFloat32POD:
+      return 'f';
+    case Alembic::Util::kFloat64POD:
+      return 'd';
+    default:
+      return 0;
+  }
+}
+
+static PyObject *iArraySample_getFormat(PyObject *self, PyObject *args)
+{
+  return Py_BuildValue("s", ((iArraySample *)self)->format);
+}
+
+static PyObject *iArraySample_getShape(PyObject *self, PyObject *args)
+{
+  iArraySample *sample = (iArraySample *)self;
+  if (sample->ndim == 1) {
+    return Py_BuildValue("(n)", sample->shape[0]);
+  }
+  return Py_BuildValue("(nn)", sample->shape[0], sample->shape[1]);
+}
+
+static PyMethodDef iArraySample_methods[] = {
+    {"getFormat", (PyCFunction)iArraySample_getFormat, METH_NOARGS,
+     "Returns the struct module format of one component. Half floats are "
+     "'H', the raw 16 bits of each value, use .view(numpy.float16) on the "
+     "numpy array to read them."},
+    {"getShape", (PyCFunction)iArraySample_getShape, METH_NOARGS,
+     "Returns (count,) for scalar elements, (count, components) otherwise."},
+    {NULL, NULL}};
+
+static PyObject *iArraySample_getAttr(PyObject *self, char *attrName)
+{
+  return Py_FindMethod(iArraySample_methods, self, attrName);
+}
+
+static void iArraySample_delete(PyObject *self)
+{
+  ((iArraySample *)self)->sample.reset();
+  PyObject_FREE(self);
+}
+
+static void *iArraySample_data(iArraySample *sample)
+{
+  return const_cast<void *>(sample->sample->getData());
+}
+
+static Py_ssize_t iArraySample_length(iArraySample *sample)
+{
+  return sample->shape[0] * sample->strides[0];
+}
+
+// old style buffer protocol, used by buffer() and numpy.frombuffer
+static Py_ssize_t iArraySample_getReadBuffer(PyObject *self, Py_ssize_t segment,
+                                             void **ptr)
+{
+  if (segment != 0) {
+    PyErr_SetString(PyExc_SystemError, "accessing non-existent segment");
+    return -1;
+  }
+  iArraySample *sample = (iArraySample *)self;
+  *ptr = iArraySample_data(sample);
+  return iArraySample_length(sample);
+}
+
+static Py_ssize_t iArraySample_getSegCount(PyObject *self, Py_ssize_t *lenp)
+{
+  if (lenp) {
+    *lenp = iArraySample_length((iArraySample *)self);
+  }
+  return 1;
+}
+
+#if PY_VERSION_HEX >= 0x02060000
+// new style buffer protocol, used by memoryview and numpy.asarray
+static int iArraySample_getBuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "Alembic samples are read only");
+    return -1;
+  }
+
+  iArraySample *sample = (iArraySample *)self;
+  view->buf = iArraySample_data(sample);
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = iArraySample_length(sample);
+  view->readonly = 1;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  if ((flags & PyBUF_ND) != PyBUF_ND) {
+    // a plain run of bytes, the format has to agree with the itemsize
+    view->itemsize = 1;
+    view->format = (flags & PyBUF_FORMAT) ? (char *)"B" : NULL;
+    view->ndim = 1;
+    view->shape = NULL;
+    view->strides = NULL;
+    return 0;
+  }
+  view->itemsize = sample->itemsize;
+  view->format = (flags & PyBUF_FORMAT) ? sample->format : NULL;
+  view->ndim = sample->ndim;
+  view->shape = sample->shape;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? sample->strides
+                                                           : NULL;
+  return 0;
+}
+#endif
+
+static PyBufferProcs iArraySample_bufferProcs = {
+    (readbufferproc)iArraySample_getReadBuffer,  // bf_getreadbuffer
+    0,                                           // bf_getwritebuffer
+    (segcountproc)iArraySample_getSegCount,      // bf_getsegcount
+    0,                                           // bf_getcharbuffer
+#if PY_VERSION_HEX >= 0x02060000
+    (getbufferproc)iArraySample_getBuffer,  // bf_getbuffer
+    0,                                      // bf_releasebuffer
+#endif
+};
+
+#if PY_VERSION_HEX >= 0x02060000
+#define IARRAYSAMPLE_TPFLAGS (Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER)
+#else
+#define IARRAYSAMPLE_TPFLAGS Py_TPFLAGS_DEFAULT
+#endif
+
+static PyTypeObject iArraySample_Type = {
+    PyObject_HEAD_INIT(&PyType_Type) 0,    // op_size
+    "iArraySample",                        // tp_name
+    sizeof(iArraySample),                  // tp_basicsize
+    0,                                     // tp_itemsize
+    (destructor)iArraySample_delete,       // tp_dealloc
+    0,                                     // tp_print
+    (getattrfunc)iArraySample_getAttr,     // tp_getattr
+    0,                                     // tp_setattr
+    0,                                     // tp_compare
+    0,                                     /*tp_repr*/
+    0,                                     /*tp_as_number*/
+    0,                                     /*tp_as_sequence*/
+    0,                                     /*tp_as_mapping*/
+    0,                                     /*tp_hash */
+    0,                                     /*tp_call*/
+    0,                                     /*tp_str*/
+    0,                                     /*tp_getattro*/
+    0,                                     /*tp_setattro*/
+    &iArraySample_bufferProcs,             /*tp_as_buffer*/
+    IARRAYSAMPLE_TPFLAGS,                  /*tp_flags*/
+    "Read only view on the values of an array sample, without any copy. Use "
+    "numpy.asarray or memoryview on it.", /* tp_doc */
+    0,                                    /* tp_traverse */
+    0,                                    /* tp_clear */
+    0,                                    /* tp_richcompare */
+    0,                                    /* tp_weaklistoffset */
+    0,                                    /* tp_iter */
+    0,                                    /* tp_iternext */
+    iArraySample_methods,                 /* tp_methods */
+};
+
+#ifdef __cplusplus__
+}
+#endif
+
+PyObject *iArraySample_new(AbcA::ArraySamplePtr sample)
+{
+  ALEMBIC_TRY_STATEMENT
+  const AbcA::DataType &dataType = sample->getDataType();
+  const char format = iArraySample_getFormat(dataType.getPod());
+  if (format == 0) {
+    PyErr_SetString(getError(),
+                    "Only numeric array samples can be accessed as a buffer!");
+    return NULL;
+  }
+
+  iArraySample *view = PyObject_NEW(iArraySample, &iArraySample_Type);
+  new (&(view->sample)) AbcA::ArraySamplePtr(sample);
+  view->format[0] = format;
+  view->format[1] = 0;
+  view->itemsize = (Py_ssize_t)AbcA::PODNumBytes(dataType.getPod());
+
+  // vectors, colors and matrices are a second dimension of their components
+  const Py_ssize_t extent = (Py_ssize_t)dataType.getExtent();
+  view->shape[0] = (Py_ssize_t)sample->size();
+  view->shape[1] = extent;
+  view->strides[0] = extent * view->itemsize;
+  view->strides[1] = view->itemsize;
+  view->ndim = extent > 1 ? 2 : 1;
+  return (PyObject *)view;
+  ALEMBIC_PYOBJECT_CATCH_STATEMENT
+}
+
+bool register_object_iArraySample(PyObject *module)
+{
+  return register_object(module, iArraySample_Type, "iArraySample");
+}
@@ -0,0 +1,20 @@
+#ifndef _PYTHON_ALEMBIC_IARRAYSAMPLE_H_
+#define _PYTHON_ALEMBIC_IARRAYSAMPLE_H_
+
+// read only view on an array sample, exposed through the buffer protocol. The
+// sample stays alive as long as this object or any view on it.
+typedef struct {
+  PyObject_HEAD AbcA::ArraySamplePtr sample;
+  char format[2];
+  int ndim;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+  Py_ssize_t itemsize;
+} iArraySample;
+
+// returns NULL and sets the error if the type can't be viewed (strings)
+PyObject *iArraySample_new(AbcA::ArraySamplePtr sample);
+
+bool register_object_iArraySample(PyObject *module);
+
+#endif
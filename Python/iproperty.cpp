@@ -4,6 +4,8 @@
 #include "AlembicLicensing.h"
 #include "CommonUtilities.h"
 #include "extension.h"
+#include "iarchive.h"
+#include "iarraysample.h"
 #include "icompoundproperty.h"  // to call iCompoundProperty_new in iProperty_new if it's an iCompoundProperty
 #include "iobject.h"
 #include "timesampling.h"
@@ -501,6 +503,10 @@ static PyObject *iProperty_getSize(PyObject *self, PyObject *args)
     PyTuple_SetItem(tuple, 0, Py_BuildValue(python_cast, (cast_type)value)); \
   }
 
+// the array samples are read before the switch, without the GIL
+#define _CAST_ARRAY_SAMPLE(arrayprop) \
+  Alembic::Util::static_pointer_cast<Abc::arrayprop::sample_type>(baseSample)
+
 static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
 {
   ALEMBIC_TRY_STATEMENT
@@ -529,6 +535,14 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     return NULL;
   }
 
+  // read array samples without the GIL, the cases below only convert them
+  AbcA::ArraySamplePtr baseSample;
+  if (prop->mIsArray) {
+    AllowThreads allowThreads(prop->mAllowThreads);
+    prop->mBaseArrayProperty->get(
+        baseSample, Abc::ISampleSelector((Abc::index_t)sampleIndex));
+  }
+
   PyObject *tuple = NULL;
   switch (prop->mPropType) {
     case propertyTP_boolean: {
@@ -1072,7 +1086,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_boolean_array: {
       Abc::IBoolArrayProperty::sample_ptr_type sample;
       Abc::IBoolArrayProperty::value_type value;
-      prop->mBoolArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBoolArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1091,7 +1105,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_uchar_array: {
       Abc::IUcharArrayProperty::sample_ptr_type sample;
       Abc::IUcharArrayProperty::value_type value;
-      prop->mUcharArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IUcharArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1111,7 +1125,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_char_array: {
       Abc::ICharArrayProperty::sample_ptr_type sample;
       Abc::ICharArrayProperty::value_type value;
-      prop->mCharArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(ICharArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1130,7 +1144,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_uint16_array: {
       Abc::IUInt16ArrayProperty::sample_ptr_type sample;
       Abc::IUInt16ArrayProperty::value_type value;
-      prop->mUInt16ArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IUInt16ArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1150,7 +1164,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_int16_array: {
       Abc::IInt16ArrayProperty::sample_ptr_type sample;
       Abc::IInt16ArrayProperty::value_type value;
-      prop->mInt16ArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IInt16ArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1169,7 +1183,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_uint32_array: {
       Abc::IUInt32ArrayProperty::sample_ptr_type sample;
       Abc::IUInt32ArrayProperty::value_type value;
-      prop->mUInt32ArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IUInt32ArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1189,7 +1203,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_int32_array: {
       Abc::IInt32ArrayProperty::sample_ptr_type sample;
       Abc::IInt32ArrayProperty::value_type value;
-      prop->mInt32ArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IInt32ArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1208,7 +1222,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_uint64_array: {
       Abc::IUInt64ArrayProperty::sample_ptr_type sample;
       Abc::IUInt64ArrayProperty::value_type value;
-      prop->mUInt64ArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IUInt64ArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1228,7 +1242,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_int64_array: {
       Abc::IInt64ArrayProperty::sample_ptr_type sample;
       Abc::IInt64ArrayProperty::value_type value;
-      prop->mInt64ArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IInt64ArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1248,7 +1262,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_half_array: {
       Abc::IHalfArrayProperty::sample_ptr_type sample;
       Abc::IHalfArrayProperty::value_type value;
-      prop->mHalfArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IHalfArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1267,7 +1281,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_float_array: {
       Abc::IFloatArrayProperty::sample_ptr_type sample;
       Abc::IFloatArrayProperty::value_type value;
-      prop->mFloatArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IFloatArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1286,7 +1300,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_double_array: {
       Abc::IDoubleArrayProperty::sample_ptr_type sample;
       Abc::IDoubleArrayProperty::value_type value;
-      prop->mDoubleArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IDoubleArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1305,7 +1319,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_string_array: {
       Abc::IStringArrayProperty::sample_ptr_type sample;
       Abc::IStringArrayProperty::value_type value;
-      prop->mStringArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IStringArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1324,7 +1338,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_wstring_array: {
       Abc::IWstringArrayProperty::sample_ptr_type sample;
       Abc::IWstringArrayProperty::value_type value;
-      prop->mWstringArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IWstringArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1343,7 +1357,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v2s_array: {
       Abc::IV2sArrayProperty::sample_ptr_type sample;
       Abc::IV2sArrayProperty::value_type value;
-      prop->mV2sArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV2sArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1363,7 +1377,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v2i_array: {
       Abc::IV2iArrayProperty::sample_ptr_type sample;
       Abc::IV2iArrayProperty::value_type value;
-      prop->mV2iArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV2iArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1383,7 +1397,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v2f_array: {
       Abc::IV2fArrayProperty::sample_ptr_type sample;
       Abc::IV2fArrayProperty::value_type value;
-      prop->mV2fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV2fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1403,7 +1417,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v2d_array: {
       Abc::IV2dArrayProperty::sample_ptr_type sample;
       Abc::IV2dArrayProperty::value_type value;
-      prop->mV2dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV2dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1423,7 +1437,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v3s_array: {
       Abc::IV3sArrayProperty::sample_ptr_type sample;
       Abc::IV3sArrayProperty::value_type value;
-      prop->mV3sArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV3sArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1444,7 +1458,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v3i_array: {
       Abc::IV3iArrayProperty::sample_ptr_type sample;
       Abc::IV3iArrayProperty::value_type value;
-      prop->mV3iArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV3iArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1465,7 +1479,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v3f_array: {
       Abc::IV3fArrayProperty::sample_ptr_type sample;
       Abc::IV3fArrayProperty::value_type value;
-      prop->mV3fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV3fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1486,7 +1500,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_v3d_array: {
       Abc::IV3dArrayProperty::sample_ptr_type sample;
       Abc::IV3dArrayProperty::value_type value;
-      prop->mV3dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IV3dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1507,7 +1521,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p2s_array: {
       Abc::IP2sArrayProperty::sample_ptr_type sample;
       Abc::IP2sArrayProperty::value_type value;
-      prop->mP2sArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP2sArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1527,7 +1541,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p2i_array: {
       Abc::IP2iArrayProperty::sample_ptr_type sample;
       Abc::IP2iArrayProperty::value_type value;
-      prop->mP2iArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP2iArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1547,7 +1561,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p2f_array: {
       Abc::IP2fArrayProperty::sample_ptr_type sample;
       Abc::IP2fArrayProperty::value_type value;
-      prop->mP2fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP2fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1567,7 +1581,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p2d_array: {
       Abc::IP2dArrayProperty::sample_ptr_type sample;
       Abc::IP2dArrayProperty::value_type value;
-      prop->mP2dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP2dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1587,7 +1601,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p3s_array: {
       Abc::IP3sArrayProperty::sample_ptr_type sample;
       Abc::IP3sArrayProperty::value_type value;
-      prop->mP3sArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP3sArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1608,7 +1622,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p3i_array: {
       Abc::IP3iArrayProperty::sample_ptr_type sample;
       Abc::IP3iArrayProperty::value_type value;
-      prop->mP3iArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP3iArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1629,7 +1643,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p3f_array: {
       Abc::IP3fArrayProperty::sample_ptr_type sample;
       Abc::IP3fArrayProperty::value_type value;
-      prop->mP3fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP3fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1650,7 +1664,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_p3d_array: {
       Abc::IP3dArrayProperty::sample_ptr_type sample;
       Abc::IP3dArrayProperty::value_type value;
-      prop->mP3dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IP3dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1671,7 +1685,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box2s_array: {
       Abc::IBox2sArrayProperty::sample_ptr_type sample;
       Abc::IBox2sArrayProperty::value_type value;
-      prop->mBox2sArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox2sArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1697,7 +1711,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box2i_array: {
       Abc::IBox2iArrayProperty::sample_ptr_type sample;
       Abc::IBox2iArrayProperty::value_type value;
-      prop->mBox2iArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox2iArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1723,7 +1737,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box2f_array: {
       Abc::IBox2fArrayProperty::sample_ptr_type sample;
       Abc::IBox2fArrayProperty::value_type value;
-      prop->mBox2fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox2fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1745,7 +1759,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box2d_array: {
       Abc::IBox2dArrayProperty::sample_ptr_type sample;
       Abc::IBox2dArrayProperty::value_type value;
-      prop->mBox2dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox2dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1767,7 +1781,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box3s_array: {
       Abc::IBox3sArrayProperty::sample_ptr_type sample;
       Abc::IBox3sArrayProperty::value_type value;
-      prop->mBox3sArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox3sArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1797,7 +1811,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box3i_array: {
       Abc::IBox3iArrayProperty::sample_ptr_type sample;
       Abc::IBox3iArrayProperty::value_type value;
-      prop->mBox3iArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox3iArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1827,7 +1841,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box3f_array: {
       Abc::IBox3fArrayProperty::sample_ptr_type sample;
       Abc::IBox3fArrayProperty::value_type value;
-      prop->mBox3fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox3fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1851,7 +1865,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_box3d_array: {
       Abc::IBox3dArrayProperty::sample_ptr_type sample;
       Abc::IBox3dArrayProperty::value_type value;
-      prop->mBox3dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IBox3dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1875,7 +1889,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_m33f_array: {
       Abc::IM33fArrayProperty::sample_ptr_type sample;
       Abc::IM33fArrayProperty::value_type value;
-      prop->mM33fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IM33fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1902,7 +1916,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_m33d_array: {
       Abc::IM33dArrayProperty::sample_ptr_type sample;
       Abc::IM33dArrayProperty::value_type value;
-      prop->mM33dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IM33dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1929,7 +1943,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_m44f_array: {
       Abc::IM44fArrayProperty::sample_ptr_type sample;
       Abc::IM44fArrayProperty::value_type value;
-      prop->mM44fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IM44fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1963,7 +1977,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_m44d_array: {
       Abc::IM44dArrayProperty::sample_ptr_type sample;
       Abc::IM44dArrayProperty::value_type value;
-      prop->mM44dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IM44dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -1997,7 +2011,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_quatf_array: {
       Abc::IQuatfArrayProperty::sample_ptr_type sample;
       Abc::IQuatfArrayProperty::value_type value;
-      prop->mQuatfArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IQuatfArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2019,7 +2033,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_quatd_array: {
       Abc::IQuatdArrayProperty::sample_ptr_type sample;
       Abc::IQuatdArrayProperty::value_type value;
-      prop->mQuatdArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IQuatdArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2041,7 +2055,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_c3h_array: {
       Abc::IC3hArrayProperty::sample_ptr_type sample;
       Abc::IC3hArrayProperty::value_type value;
-      prop->mC3hArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IC3hArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2062,7 +2076,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_c3f_array: {
       Abc::IC3fArrayProperty::sample_ptr_type sample;
       Abc::IC3fArrayProperty::value_type value;
-      prop->mC3fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IC3fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2083,7 +2097,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_c3c_array: {
       Abc::IC3cArrayProperty::sample_ptr_type sample;
       Abc::IC3cArrayProperty::value_type value;
-      prop->mC3cArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IC3cArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2107,7 +2121,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_c4h_array: {
       Abc::IC4hArrayProperty::sample_ptr_type sample;
       Abc::IC4hArrayProperty::value_type value;
-      prop->mC4hArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IC4hArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2129,7 +2143,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_c4f_array: {
       Abc::IC4fArrayProperty::sample_ptr_type sample;
       Abc::IC4fArrayProperty::value_type value;
-      prop->mC4fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IC4fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2151,7 +2165,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_c4c_array: {
       Abc::IC4cArrayProperty::sample_ptr_type sample;
       Abc::IC4cArrayProperty::value_type value;
-      prop->mC4cArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IC4cArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2177,7 +2191,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_n2f_array: {
       Abc::IN2fArrayProperty::sample_ptr_type sample;
       Abc::IN2fArrayProperty::value_type value;
-      prop->mN2fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IN2fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2197,7 +2211,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_n2d_array: {
       Abc::IN2dArrayProperty::sample_ptr_type sample;
       Abc::IN2dArrayProperty::value_type value;
-      prop->mN2dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IN2dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2217,7 +2231,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_n3f_array: {
       Abc::IN3fArrayProperty::sample_ptr_type sample;
       Abc::IN3fArrayProperty::value_type value;
-      prop->mN3fArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IN3fArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2238,7 +2252,7 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
     case propertyTP_n3d_array: {
       Abc::IN3dArrayProperty::sample_ptr_type sample;
       Abc::IN3dArrayProperty::value_type value;
-      prop->mN3dArrayProperty->get(sample, sampleIndex);
+      sample = _CAST_ARRAY_SAMPLE(IN3dArrayProperty);
       if (start >= sample->size()) {
         tuple = PyTuple_New(0);
       }
@@ -2263,6 +2277,40 @@ static PyObject *iProperty_getValues(PyObject *self, PyObject *args)
   ALEMBIC_PYOBJECT_CATCH_STATEMENT
 }
 
+static PyObject *iProperty_getBuffer(PyObject *self, PyObject *args)
+{
+  ALEMBIC_TRY_STATEMENT
+  iProperty *prop = (iProperty *)self;
+  if (!prop->mIsArray) {
+    PyErr_SetString(getError(), "getBuffer only supports array properties!");
+    return NULL;
+  }
+
+  unsigned long long sampleIndex = 0;
+  if (!PyArg_ParseTuple(args, "|K", &sampleIndex)) {
+    return NULL;
+  }
+
+  size_t numSamples = iProperty_getNbStoredSamples_func(self);
+  if (sampleIndex >= numSamples) {
+    std::string msg;
+    msg.append("SampleIndex for Property '");
+    msg.append(iProperty_getName_func(self));
+    msg.append("' is out of bounds!");
+    PyErr_SetString(getError(), msg.c_str());
+    return NULL;
+  }
+
+  AbcA::ArraySamplePtr sample;
+  {
+    AllowThreads allowThreads(prop->mAllowThreads);
+    prop->mBaseArrayProperty->get(
+        sample, Abc::ISampleSelector((Abc::index_t)sampleIndex));
+  }
+  return iArraySample_new(sample);
+  ALEMBIC_PYOBJECT_CATCH_STATEMENT
+}
+
 static PyObject *iProperty_isCompound(PyObject *self, PyObject *args)
 {
   Py_INCREF(Py_False);
@@ -2284,6 +2332,10 @@ static PyMethodDef iProperty_methods[] = {
      "array."},
     {"getValues", (PyCFunction)iProperty_getValues, METH_VARARGS,
      "Returns the values of the property at the (optional) sample index."},
+    {"getBuffer", (PyCFunction)iProperty_getBuffer, METH_VARARGS,
+     "Returns an iArraySample giving read only access to the values of an "
+     "array property at the (optional) sample index, without copying them. "
+     "numpy.asarray on it returns a (count,) or (count, components) array."},
     {"isCompound", (PyCFunction)iProperty_isCompound, METH_NOARGS,
      "To distinguish between an iProperty and an iCompoundProperty, always "
      "returns false for iProperty."},
@@ -2822,6 +2874,8 @@ PyObject *iProperty_new(Abc::ICompoundProperty &compound, char *in_propName)
     else {
       prop->mIsArray = propHeader->isArray();
       prop->intent = propHeader->getDataType().getExtent();  // NEW
+      prop->mAllowThreads =
+          isIArchiveOgawa(compound.getObject().getArchive().getName());
       std::string interpretation;
       if (prop->mIsArray) {
         prop->intent = 0;
@@ -93,25 +93,28 @@ static PyObject *oArchive_createTimeSampling(PyObject *self, PyObject *args)
   }
 
   // check the list/tuple if all the items are valid!
-  std::list<PyObject *> valid_obj;
+  std::list<AbcA::TimeSamplingPtr> valid_obj;
   for (int i = 0; i < nbTimes; ++i) {
     PyObject *item = _GetItem(timesTuple, i);
     if (!PyObject_TimeSampling_Check(item)) {
       PyErr_SetString(getError(), "item should be a TimeSampling");
       return NULL;
     }
-    valid_obj.push_back(item);
+    valid_obj.push_back(((EA_TimeSampling *)item)->tsampling);
   }
 
   // add the time sampling!
-  PyObject *_list = PyList_New(valid_obj.size());
-  int ii = 0;
-  for (std::list<PyObject *>::iterator beg = valid_obj.begin();
-       beg != valid_obj.end(); ++beg, ++ii) {
-    unsigned long tsIndex = archive->mArchive->addTimeSampling(
-        *(((EA_TimeSampling *)*beg)->tsampling));
-    PyList_SetItem(_list, ii, Py_BuildValue("i", (int)tsIndex));
-    PyObject_FREE(*beg);
+  std::vector<unsigned long> tsIndices;
+  {
+    oArchiveLock lock(archive);
+    for (std::list<AbcA::TimeSamplingPtr>::iterator beg = valid_obj.begin();
+         beg != valid_obj.end(); ++beg) {
+      tsIndices.push_back(archive->mArchive->addTimeSampling(**beg));
+    }
+  }
+  PyObject *_list = PyList_New(tsIndices.size());
+  for (size_t i = 0; i < tsIndices.size(); ++i) {
+    PyList_SetItem(_list, i, Py_BuildValue("i", (int)tsIndices[i]));
   }
   return _list;
 
@@ -139,7 +142,12 @@ static PyObject *oArchive_createObject(PyObject *self, PyObject *args)
   }
 
   // check if the timesampling is in range
-  if (tsIndex < 0 || tsIndex >= (int)archive->mArchive->getNumTimeSamplings()) {
+  size_t nbTimeSamplings = 0;
+  {
+    oArchiveLock lock(archive);
+    nbTimeSamplings = archive->mArchive->getNumTimeSamplings();
+  }
+  if (tsIndex < 0 || tsIndex >= (int)nbTimeSamplings) {
     PyErr_SetString(getError(), "timeSamplingIndex is out of range!");
     return NULL;
   }
@@ -163,95 +171,103 @@ static PyObject *oArchive_createObject(PyObject *self, PyObject *args)
   }
 
   // recurse to find it
-  Abc::OObject parent = archive->mArchive->getTop();
+  oObject *parentPtr = NULL;
   if (parts.size() > 2) {
     // look for the parent in our map
     std::string parentIdentifier = "";
     for (size_t i = 1; i < parts.size() - 1; i++) {
       parentIdentifier += "/" + parts[i];
     }
-    oObject *parentPtr = oArchive_getObjectElement(archive, parentIdentifier);
+    parentPtr = oArchive_getObjectElement(archive, parentIdentifier);
     if (!parentPtr) {
       PyErr_SetString(getError(), "Invalid identifier!");
       return NULL;
     }
-    if (parentPtr->mObject) {
-      parent = *parentPtr->mObject;
-    }
   }
 
   // now validate the type
   std::string typeStr(type);
   oObjectPtr casted;
   Abc::OObject obj;
-  if (typeStr.substr(0, 14) == "AbcGeom_Xform_") {
-    casted.mType = oObjectType_Xform;
-    casted.mXform = new AbcG::OXform(parent, parts[parts.size() - 1], tsIndex);
-    obj = Abc::OObject(*casted.mXform, Abc::kWrapExisting);
-  }
-  else {
-    // if we are not a transform, ensure that we are nested below a xform!
-    // INFO_MSG("parent.getMetaData().get(\"schema\") = " <<
-    // parent.getMetaData().get("schema"));
-    // INFO_MSG("type string = " << typeStr);
-
-    if (typeStr.substr(0, 15) == "AbcGeom_Camera_") {
-      casted.mType = oObjectType_Camera;
-      casted.mCamera =
-          new AbcG::OCamera(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mCamera, Abc::kWrapExisting);
-    }
-    else if (typeStr.substr(0, 17) == "AbcGeom_PolyMesh_") {
-      casted.mType = oObjectType_PolyMesh;
-      casted.mPolyMesh =
-          new AbcG::OPolyMesh(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mPolyMesh, Abc::kWrapExisting);
-    }
-    else if (typeStr.substr(0, 13) == "AbcGeom_SubD_") {
-      casted.mType = oObjectType_SubD;
-      casted.mSubD = new AbcG::OSubD(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mSubD, Abc::kWrapExisting);
-    }
-    else if (typeStr.substr(0, 14) == "AbcGeom_Curve_") {
-      casted.mType = oObjectType_Curves;
-      casted.mCurves =
-          new AbcG::OCurves(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mCurves, Abc::kWrapExisting);
+  const char *error = NULL;
+  {
+    // another thread might be writing a sample of this archive
+    oArchiveLock lock(archive);
+    Abc::OObject parent = archive->mArchive->getTop();
+    if (parentPtr && parentPtr->mObject) {
+      parent = *parentPtr->mObject;
     }
-    else if (typeStr.substr(0, 15) == "AbcGeom_Points_") {
-      casted.mType = oObjectType_Points;
-      casted.mPoints =
-          new AbcG::OPoints(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mPoints, Abc::kWrapExisting);
+    if (typeStr.substr(0, 14) == "AbcGeom_Xform_") {
+      casted.mType = oObjectType_Xform;
+      casted.mXform =
+          new AbcG::OXform(parent, parts[parts.size() - 1], tsIndex);
+      obj = Abc::OObject(*casted.mXform, Abc::kWrapExisting);
     }
+    else {
+      // if we are not a transform, ensure that we are nested below a xform!
+      // INFO_MSG("parent.getMetaData().get(\"schema\") = " <<
+      // parent.getMetaData().get("schema"));
+      // INFO_MSG("type string = " << typeStr);
+
+      if (typeStr.substr(0, 15) == "AbcGeom_Camera_") {
+        casted.mType = oObjectType_Camera;
+        casted.mCamera =
+            new AbcG::OCamera(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mCamera, Abc::kWrapExisting);
+      }
+      else if (typeStr.substr(0, 17) == "AbcGeom_PolyMesh_") {
+        casted.mType = oObjectType_PolyMesh;
+        casted.mPolyMesh =
+            new AbcG::OPolyMesh(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mPolyMesh, Abc::kWrapExisting);
+      }
+      else if (typeStr.substr(0, 13) == "AbcGeom_SubD_") {
+        casted.mType = oObjectType_SubD;
+        casted.mSubD =
+            new AbcG::OSubD(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mSubD, Abc::kWrapExisting);
+      }
+      else if (typeStr.substr(0, 14) == "AbcGeom_Curve_") {
+        casted.mType = oObjectType_Curves;
+        casted.mCurves =
+            new AbcG::OCurves(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mCurves, Abc::kWrapExisting);
+      }
+      else if (typeStr.substr(0, 15) == "AbcGeom_Points_") {
+        casted.mType = oObjectType_Points;
+        casted.mPoints =
+            new AbcG::OPoints(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mPoints, Abc::kWrapExisting);
+      }
 
-    // **** NEW
-    else if (typeStr.substr(0, 16) == "AbcGeom_FaceSet_") {
-      casted.mType = oObjectType_FaceSet;
-      casted.mFaceSet =
-          new AbcG::OFaceSet(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mFaceSet, Abc::kWrapExisting);
-    }
-    else if (typeStr.substr(0, 16) == "AbcGeom_NuPatch_") {
-      casted.mType = oObjectType_NuPatch;
-      casted.mNuPatch =
-          new AbcG::ONuPatch(parent, parts[parts.size() - 1], tsIndex);
-      obj = Abc::OObject(*casted.mNuPatch, Abc::kWrapExisting);
-    }
+      // **** NEW
+      else if (typeStr.substr(0, 16) == "AbcGeom_FaceSet_") {
+        casted.mType = oObjectType_FaceSet;
+        casted.mFaceSet =
+            new AbcG::OFaceSet(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mFaceSet, Abc::kWrapExisting);
+      }
+      else if (typeStr.substr(0, 16) == "AbcGeom_NuPatch_") {
+        casted.mType = oObjectType_NuPatch;
+        casted.mNuPatch =
+            new AbcG::ONuPatch(parent, parts[parts.size() - 1], tsIndex);
+        obj = Abc::OObject(*casted.mNuPatch, Abc::kWrapExisting);
+      }
 
-    // moved at the end!! let see if it works
-    else if (parent.getMetaData().get("schema").substr(0, 14) !=
-             "AbcGeom_Xform_") {
-      PyErr_SetString(
-          getError(),
-          "This type of object has to be put below a xform object!");
-      return NULL;
-    }
-    else {
-      PyErr_SetString(getError(), "Object type invalid!");
-      return NULL;
+      // moved at the end!! let see if it works
+      else if (parent.getMetaData().get("schema").substr(0, 14) !=
+               "AbcGeom_Xform_") {
+        error = "This type of object has to be put below a xform object!";
+      }
+      else {
+        error = "Object type invalid!";
+      }
     }
   }
+  if (error) {
+    PyErr_SetString(getError(), error);
+    return NULL;
+  }
 
   if (!obj.valid()) {
     PyErr_SetString(getError(), "Unexpected error!");
@@ -338,12 +354,17 @@ static void oArchive_delete(PyObject *self)
     archive->mElements->clear();
     delete (archive->mElements);
     archive->mElements = NULL;
-    delete (archive->mArchive);
+    {
+      // Ogawa writes the whole hierarchy when closing
+      AllowThreads allowThreads(archive->mIsOgawa);
+      delete (archive->mArchive);
+    }
     archive->mArchive = NULL;
 #ifdef PYTHON_DEBUG
     printf("closed archive.\n");
 #endif
   }
+  delete (archive->mLock);
   PyObject_FREE(archive);
   gNbOArchives--;
   ALEMBIC_VOID_CATCH_STATEMENT
@@ -372,7 +393,9 @@ static PyTypeObject oArchive_Type = {
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
     "This is the output archive. It provides methods for creating "
     "content inside the archive, including TimeSamplings as well as "
-    "objects.",       /* tp_doc */
+    "objects. Ogawa archives write their array samples without holding the "
+    "GIL, the calls on one archive are still done one at a time, so threads "
+    "should write to different archives.", /* tp_doc */
     0,                /* tp_traverse */
     0,                /* tp_clear */
     0,                /* tp_richcompare */
@@ -419,6 +442,8 @@ PyObject *oArchive_new(PyObject *self, PyObject *args)
 
   oArchive *object = PyObject_NEW(oArchive, &oArchive_Type);
   if (object != NULL) {
+    object->mIsOgawa = useOgawa;
+    object->mLock = new boost::mutex();
     object->mArchive = new Abc::OArchive();
     createArchive(object, fileName, useOgawa);
     AbcG::CreateOArchiveBounds(*object->mArchive, 0);
@@ -431,6 +456,26 @@ PyObject *oArchive_new(PyObject *self, PyObject *args)
   ALEMBIC_PYOBJECT_CATCH_STATEMENT
 }
 
+boost::mutex &oArchive_getLock(void *archive)
+{
+  return *((oArchive *)archive)->mLock;
+}
+
+oArchiveLock::Reference::Reference(void *archive)
+    : mArchive((PyObject *)archive)
+{
+  Py_INCREF(mArchive);
+}
+
+oArchiveLock::Reference::~Reference() { Py_DECREF(mArchive); }
+
+oArchiveLock::oArchiveLock(void *archive)
+    : mReference(archive),
+      mAllowThreads(((oArchive *)archive)->mIsOgawa,
+                    &oArchive_getLock(archive))
+{
+}
+
 static void init_oArchiveElement(oArchiveElement &element,
                                  std::string &identifier)
 {
@@ -1,11 +1,14 @@
 #ifndef _PYTHON_ALEMBIC_OARCHIVE_H_
 #define _PYTHON_ALEMBIC_OARCHIVE_H_
 
+#include "extension.h"
 #include "ocompoundproperty.h"
 #include "oobject.h"
 #include "oproperty.h"
 #include "oxformproperty.h"
 
+#include <boost/thread/mutex.hpp>
+
 struct oArchiveElement {
   std::string identifier;
   oObject *object;
@@ -19,6 +22,8 @@ typedef std::vector<oArchiveElement> oArchiveElementVec;
 typedef struct {
   PyObject_HEAD Abc::OArchive *mArchive;
   oArchiveElementVec *mElements;
+  bool mIsOgawa;        // samples are written without the GIL
+  boost::mutex *mLock;  // one call into the writer at a time
 } oArchive;
 
 void oArchive_registerObjectElement(oArchive *archive, std::string identifier,
@@ -37,6 +42,33 @@ oCompoundProperty *oArchive_getCompPropElement(oArchive *archive,
 oXformProperty *oArchive_getXformElement(oArchive *archive,
                                          std::string identifier);
 
+// taken by every call into the writer of the archive, the array samples of
+// Ogawa archives are written without the GIL
+boost::mutex &oArchive_getLock(void *archive);
+
+/**
+ * Takes the lock of the archive for the lifetime of the object, after
+ * releasing the GIL if the archive is an Ogawa one. The archive is kept alive
+ * meanwhile. Arguments have to be parsed and results built outside of its
+ * scope, the python API can't be used while the lock is held.
+ */
+class oArchiveLock {
+ public:
+  oArchiveLock(void *archive);
+
+ private:
+  oArchiveLock(const oArchiveLock &);
+  oArchiveLock &operator=(const oArchiveLock &);
+
+  // destroyed last, once the GIL is held again
+  struct Reference {
+    Reference(void *archive);
+    ~Reference();
+    PyObject *mArchive;
+  } mReference;
+  AllowThreads mAllowThreads;
+};
+
 PyObject *oArchive_new(PyObject *self, PyObject *args);
 size_t getNbOArchives();
 bool isOArchiveOpened(std::string filename);
@@ -143,16 +143,19 @@ PyObject *oCompoundProperty_new(Abc::OCompoundProperty compound,
   cprop->mFullName = new std::string(identifier);
   cprop->tsIndex = tsIndex;
 
-  const Abc::PropertyHeader *propHeader =
-      compound.getPropertyHeader(in_propName);
   std::string propName(in_propName);
-  if (propHeader != NULL)
-    cprop->mBaseCompoundProperty = new Abc::OCompoundProperty(
-        compound.getProperty(in_propName).getPtr()->asCompoundPtr(),
-        Alembic::Abc::kWrapExisting);
-  else
-    cprop->mBaseCompoundProperty =
-        new Abc::OCompoundProperty(compound.getPtr(), propName);
+  {
+    oArchiveLock lock(archive);
+    const Abc::PropertyHeader *propHeader =
+        compound.getPropertyHeader(in_propName);
+    if (propHeader != NULL)
+      cprop->mBaseCompoundProperty = new Abc::OCompoundProperty(
+          compound.getProperty(in_propName).getPtr()->asCompoundPtr(),
+          Alembic::Abc::kWrapExisting);
+    else
+      cprop->mBaseCompoundProperty =
+          new Abc::OCompoundProperty(compound.getPtr(), propName);
+  }
 
   return (PyObject *)cprop;
   ALEMBIC_PYOBJECT_CATCH_STATEMENT
@@ -111,41 +111,50 @@ static PyObject *oObject_setMetaData(PyObject *self, PyObject *args)
     metaData[i] = itemStr;
   }
 
+  int result = 0;
+  const char *error = NULL;
+  {
+    oArchiveLock lock(object->mArchive);
 #ifdef PYTHON_DEBUG
-  printf("retrieving ocompound...\n");
-  if (object->mObject == NULL) {
-    printf("what the heck?... NULL pointer?\n");
-  }
-  printf("object name is: %s\n", object->mObject->getFullName().c_str());
+    printf("retrieving ocompound...\n");
+    if (object->mObject == NULL) {
+      printf("what the heck?... NULL pointer?\n");
+    }
+    printf("object name is: %s\n", object->mObject->getFullName().c_str());
 #endif
 
-  Abc::OCompoundProperty compound = getCompoundFromOObject(object->mCasted);
+    Abc::OCompoundProperty compound = getCompoundFromOObject(object->mCasted);
 #ifdef PYTHON_DEBUG
-  printf("ocompound retrieved.\n");
+    printf("ocompound retrieved.\n");
 #endif
-  if (!compound.valid()) {
-    return Py_BuildValue("i", 0);
-  };
-
+    if (!compound.valid()) {
+      result = 0;
+    }
+    else if (compound.getPropertyHeader(".metadata") != NULL) {
+      error = "Metadata already set!";
+    }
+    else {
 #ifdef PYTHON_DEBUG
-  printf("creating metadata property...\n");
+      printf("creating metadata property...\n");
 #endif
 
-  if (compound.getPropertyHeader(".metadata") != NULL) {
-    PyErr_SetString(getError(), "Metadata already set!");
-    return NULL;
-  }
-
-  Abc::OStringArrayProperty metaDataProperty =
-      Abc::OStringArrayProperty(compound, ".metadata", compound.getMetaData(),
-                                compound.getTimeSampling());
+      Abc::OStringArrayProperty metaDataProperty = Abc::OStringArrayProperty(
+          compound, ".metadata", compound.getMetaData(),
+          compound.getTimeSampling());
 
 #ifdef PYTHON_DEBUG
-  printf("metadata property created.\n");
+      printf("metadata property created.\n");
 #endif
 
-  Abc::StringArraySample metaDataSample(&metaData.front(), metaData.size());
-  metaDataProperty.set(metaDataSample);
+      Abc::StringArraySample metaDataSample(&metaData.front(), metaData.size());
+      metaDataProperty.set(metaDataSample);
+      result = 1;
+    }
+  }
+  if (error) {
+    PyErr_SetString(getError(), error);
+    return NULL;
+  }
 
   // todo existing properties
   // Abc::ArrayPropertyWriterPtr arrayPtr =
@@ -153,7 +162,7 @@ static PyObject *oObject_setMetaData(PyObject *self, PyObject *args)
   // ".metadata" ).getPtr());
   // metaDataProperty = Abc::OStringArrayProperty(arrayPtr, Abc::kWrapExisting);
 
-  return Py_BuildValue("i", 1);
+  return Py_BuildValue("i", result);
   ALEMBIC_PYOBJECT_CATCH_STATEMENT
 }
 
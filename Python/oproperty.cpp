@@ -115,6 +115,277 @@ static PyObject *oProperty_getName(PyObject *self, PyObject *args)
       prop->mXProperty->set(tupleVec[0]);           \
   }
 
+// kind and size of one component of a buffer format like "<f" or "d", the
+// kind is 'b' for bool, 'i' for signed, 'u' for unsigned and 'f' for floats
+static bool oProperty_parseBufferFormat(const char *format, char &kind,
+                                        size_t &size)
+{
+  bool native = true;
+  if (*format == '@') {
+    ++format;
+  }
+  else if (*format == '=' || *format == '<' || *format == '>' ||
+           *format == '!') {
+    const bool little = *format == '<' || *format == '=';
+    ++format;
+    native = false;
+    // the samples are written in the byte order of this machine
+    const unsigned short one = 1;
+    const bool isLittleEndian = *(const unsigned char *)&one == 1;
+    if (little != isLittleEndian) {
+      return false;
+    }
+  }
+  if (format[0] == 0 || format[1] != 0) {
+    return false;
+  }
+
+  switch (format[0]) {
+    case '?':
+      kind = 'b';
+      size = 1;
+      return true;
+    case 'b':
+    case 'B':
+      size = 1;
+      break;
+    case 'h':
+    case 'H':
+      size = 2;
+      break;
+    case 'i':
+    case 'I':
+      size = 4;
+      break;
+    case 'l':
+    case 'L':
+      size = native ? sizeof(long) : 4;
+      break;
+    case 'q':
+    case 'Q':
+      size = 8;
+      break;
+    case 'e':
+      kind = 'f';
+      size = 2;
+      return true;
+    case 'f':
+      kind = 'f';
+      size = 4;
+      return true;
+    case 'd':
+      kind = 'f';
+      size = 8;
+      return true;
+    default:
+      return false;
+  }
+  kind = (format[0] >= 'a' && format[0] <= 'z') ? 'i' : 'u';
+  return true;
+}
+
+static char oProperty_getPodKind(Alembic::Util::PlainOldDataType pod)
+{
+  switch (pod) {
+    case Alembic::Util::kBooleanPOD:
+      return 'b';
+    case Alembic::Util::kInt8POD:
+    case Alembic::Util::kInt16POD:
+    case Alembic::Util::kInt32POD:
+    case Alembic::Util::kInt64POD:
+      return 'i';
+    case Alembic::Util::kUint8POD:
+    case Alembic::Util::kUint16POD:
+    case Alembic::Util::kUint32POD:
+    case Alembic::Util::kUint64POD:
+      return 'u';
+    case Alembic::Util::kFloat16POD:
+    case Alembic::Util::kFloat32POD:
+    case Alembic::Util::kFloat64POD:
+      return 'f';
+    default:
+      return 0;
+  }
+}
+
+// writes an array sample, without the GIL for Ogawa archives
+static void oProperty_setSample(oProperty *prop,
+                               const AbcA::ArraySample &sample)
+{
+  oArchiveLock lock(prop->mArchive);
+  prop->mBaseArrayProperty->set(sample);
+}
+
+static bool oProperty_isBuffer(PyObject *obj)
+{
+#if PY_VERSION_HEX >= 0x02060000
+  if (PyObject_CheckBuffer(obj)) {
+    return true;
+  }
+#endif
+  return PyObject_CheckReadBuffer(obj) != 0;
+}
+
+#if PY_VERSION_HEX >= 0x02060000
+// releases the view when leaving the scope, also when writing the sample
+// throws
+struct oPropertyBufferView {
+  Py_buffer view;
+  bool valid;
+
+  oPropertyBufferView() : valid(false) {}
+  ~oPropertyBufferView()
+  {
+    if (valid) {
+      PyBuffer_Release(&view);
+    }
+  }
+};
+#endif
+
+// checks a buffer format, or an array.array typecode, against the pod of
+// the property. Byte formats ('B' or 'c') can only set uchar and char
+// properties, their size is checked by the caller. Half floats are also
+// accepted as 'H', the format iArraySample gives them.
+static bool oProperty_checkBufferFormat(const char *format,
+                                        Alembic::Util::PlainOldDataType pod,
+                                        bool &isBytes, std::string &error)
+{
+  isBytes = strcmp(format, "B") == 0 || strcmp(format, "c") == 0;
+  if (isBytes) {
+    if (pod == Alembic::Util::kUint8POD || pod == Alembic::Util::kInt8POD) {
+      return true;
+    }
+    error = "Byte buffers can only set uchar and char properties, not '";
+    error += Alembic::Util::PODName(pod);
+    error += "' ones!";
+    return false;
+  }
+
+  char kind = 'u';
+  size_t size = 1;
+  if (!oProperty_parseBufferFormat(format, kind, size)) {
+    error = "Unsupported sample buffer format '";
+    error += format;
+    error += "'!";
+    return false;
+  }
+  const AbcA::DataType dataType(pod, 1);
+  if ((kind != oProperty_getPodKind(pod) || size != dataType.getNumBytes()) &&
+      !(kind == 'u' && size == 2 && pod == Alembic::Util::kFloat16POD)) {
+    error = "The sample buffer format '";
+    error += format;
+    error += "' doesn't match the property type '";
+    error += Alembic::Util::PODName(pod);
+    error += "'!";
+    return false;
+  }
+  return true;
+}
+
+// writes the memory of a buffer object (numpy array, array.array, string)
+// as one array sample, without going through python objects. The format of
+// typed buffers, or the typecode of an array.array, must match the pod of
+// the property, untyped ones like strings can only set uchar and char
+// properties.
+static PyObject *oProperty_setBuffer(oProperty *prop, PyObject *obj,
+                                     long numSamples)
+{
+  const AbcA::DataType dataType = prop->mBaseArrayProperty->getDataType();
+  const char podKind = oProperty_getPodKind(dataType.getPod());
+  const size_t podSize = dataType.getNumBytes() / dataType.getExtent();
+  const size_t extent = dataType.getExtent();
+  if (podKind == 0) {
+    PyErr_SetString(getError(),
+                    "String properties can't be set from a buffer!");
+    return NULL;
+  }
+
+  const Alembic::Util::PlainOldDataType pod = dataType.getPod();
+  const void *data = NULL;
+  Py_ssize_t length = 0;
+  std::vector<char> copy;
+  std::string error;
+  PyObject *errorType = PyExc_TypeError;
+#if PY_VERSION_HEX >= 0x02060000
+  oPropertyBufferView buffer;
+  if (PyObject_CheckBuffer(obj)) {
+    Py_buffer &view = buffer.view;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) <
+        0) {
+      PyErr_Clear();
+      PyErr_SetString(getError(),
+                      "The sample buffer must be C contiguous!");
+      return NULL;
+    }
+    buffer.valid = true;
+    data = view.buf;
+    length = view.len;
+
+    // no format means raw bytes
+    bool isBytes = true;
+    const char *format = view.format ? view.format : "B";
+    if (oProperty_checkBufferFormat(format, pod, isBytes, error) &&
+        !isBytes && view.ndim > 1) {
+      // (count, extent) or (count, rows, columns) for matrices
+      Py_ssize_t components = 1;
+      for (int i = 1; i < view.ndim; i++) {
+        components *= view.shape[i];
+      }
+      if (components != (Py_ssize_t)extent) {
+        char message[128];
+        sprintf(message,
+                "The inner dimensions of the sample buffer should hold %d "
+                "components!",
+                (int)extent);
+        error = message;
+        errorType = getError();
+      }
+    }
+  }
+  else
+#endif
+  // old style buffers are typed by their typecode if they have one, like
+  // array.array, otherwise they are raw bytes. Nothing pins their memory,
+  // so it is copied before the GIL is released to write the sample.
+  {
+    std::string format = "B";
+    PyObject *typecode = PyObject_GetAttrString(obj, "typecode");
+    if (typecode != NULL && PyString_Check(typecode)) {
+      format = PyString_AsString(typecode);
+    }
+    Py_XDECREF(typecode);
+    PyErr_Clear();
+
+    bool isBytes = true;
+    if (oProperty_checkBufferFormat(format.c_str(), pod, isBytes, error)) {
+      if (PyObject_AsReadBuffer(obj, &data, &length) < 0) {
+        return NULL;
+      }
+      copy.assign((const char *)data, (const char *)data + length);
+      data = copy.empty() ? NULL : &copy[0];
+    }
+  }
+
+  const size_t elementSize = podSize * extent;
+  if (error.empty() && length % elementSize != 0) {
+    char message[128];
+    sprintf(message, "The sample buffer size should be a multiple of %d bytes!",
+            (int)elementSize);
+    error = message;
+    errorType = getError();
+  }
+  if (!error.empty()) {
+    PyErr_SetString(errorType, error.c_str());
+    return NULL;
+  }
+
+  const size_t count = length / elementSize;
+  AbcA::ArraySample sample(data, dataType, Alembic::Util::Dimensions(count));
+  oProperty_setSample(prop, sample);
+  return Py_BuildValue("l", numSamples);
+}
+
 static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
 {
   ALEMBIC_TRY_STATEMENT
@@ -159,6 +430,9 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     return NULL;
   }
   if (!PyTuple_Check(tuple) && !PyList_Check(tuple)) {
+    if (prop->mIsArray && oProperty_isBuffer(tuple)) {
+      return oProperty_setBuffer(prop, tuple, numSamples);
+    }
     PyErr_SetString(getError(), "Sample tuple argument is not a tuple!");
     return NULL;
   }
@@ -175,177 +449,210 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       _COPY_TUPLE_TO_VALUE_(unsigned char, "i",
                             prop->intent);  // cannot use bool, because it would
       // create a bit-train
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mBoolProperty);
       // prop->mBoolProperty->set(tupleVec[0] == 1);
       break;
     }
     case propertyTP_uchar: {
       _COPY_TUPLE_TO_VALUE_(unsigned int, "I", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mUcharProperty);
       // prop->mUcharProperty->set((unsigned char)tupleVec[0]);
       break;
     }
     case propertyTP_char: {
       _COPY_TUPLE_TO_VALUE_(int, "i", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mCharProperty);
       // prop->mCharProperty->set((char)tupleVec[0]);
       break;
     }
     case propertyTP_uint16: {
       _COPY_TUPLE_TO_VALUE_(unsigned int, "I", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mUInt16Property);
       // prop->mUInt16Property->set(tupleVec[0]);
       break;
     }
     case propertyTP_int16: {
       _COPY_TUPLE_TO_VALUE_(int, "i", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mInt16Property);
       // prop->mInt16Property->set(tupleVec[0]);
       break;
     }
     case propertyTP_uint32: {
       _COPY_TUPLE_TO_VALUE_(unsigned long, "k", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mUInt32Property);
       // prop->mUInt32Property->set(tupleVec[0]);
       break;
     }
     case propertyTP_int32: {
       _COPY_TUPLE_TO_VALUE_(long, "l", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mInt32Property);
       // prop->mInt32Property->set(tupleVec[0]);
       break;
     }
     case propertyTP_uint64: {
       _COPY_TUPLE_TO_VALUE_(unsigned long long, "K", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mUInt64Property);
       // prop->mUInt64Property->set(tupleVec[0]);
       break;
     }
     case propertyTP_int64: {
       _COPY_TUPLE_TO_VALUE_(long long, "L", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mInt64Property);
       // prop->mInt64Property->set(tupleVec[0]);
       break;
     }
     case propertyTP_half: {
       _COPY_TUPLE_TO_VALUE_(float, "f", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mHalfProperty);
       // prop->mHalfProperty->set(tupleVec[0]);
       break;
     }
     case propertyTP_float: {
       _COPY_TUPLE_TO_VALUE_(float, "f", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mFloatProperty);
       // prop->mFloatProperty->set(tupleVec[0]);
       break;
     }
     case propertyTP_double: {
       _COPY_TUPLE_TO_VALUE_(double, "d", prop->intent);
+      oArchiveLock lock(prop->mArchive);
       _SET_PROPERTY(mDoubleProperty);
       break;
     }
     case propertyTP_string: {
       _COPY_TUPLE_TO_VALUE_(const char *, "s", 1);
-      prop->mStringProperty->set(tupleVec[0]);
+      const std::string value(tupleVec[0]);
+      oArchiveLock lock(prop->mArchive);
+      prop->mStringProperty->set(value);
       break;
     }
     case propertyTP_wstring: {
       _COPY_TUPLE_TO_VALUE_(const char *, "s", 1);
-      prop->mWstringProperty->set((wchar_t *)tupleVec[0]);
+      const std::wstring value((wchar_t *)tupleVec[0]);
+      oArchiveLock lock(prop->mArchive);
+      prop->mWstringProperty->set(value);
       break;
     }
     case propertyTP_v2s: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mV2sProperty->set(
           Imath::V2s((short)tupleVec[0], (short)tupleVec[1]));
       break;
     }
     case propertyTP_v2i: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mV2iProperty->set(Imath::V2i(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_v2f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mV2fProperty->set(Imath::V2f(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_v2d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mV2dProperty->set(Imath::V2d(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_v3s: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mV3sProperty->set(Imath::V3s((short)tupleVec[0], (short)tupleVec[1],
                                          (short)tupleVec[2]));
       break;
     }
     case propertyTP_v3i: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mV3iProperty->set(
           Imath::V3i(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_v3f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mV3fProperty->set(
           Imath::V3f(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_v3d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mV3dProperty->set(
           Imath::V3d(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_p2s: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mP2sProperty->set(
           Imath::V2s((short)tupleVec[0], (short)tupleVec[1]));
       break;
     }
     case propertyTP_p2i: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mP2iProperty->set(Imath::V2i(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_p2f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mP2fProperty->set(Imath::V2f(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_p2d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mP2dProperty->set(Imath::V2d(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_p3s: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mP3sProperty->set(Imath::V3s((short)tupleVec[0], (short)tupleVec[1],
                                          (short)tupleVec[2]));
       break;
     }
     case propertyTP_p3i: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mP3iProperty->set(
           Imath::V3i(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_p3f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mP3fProperty->set(
           Imath::V3f(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_p3d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mP3dProperty->set(
           Imath::V3d(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_box2s: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox2sProperty->set(
           Imath::Box2s(Imath::V2s((short)tupleVec[0], (short)tupleVec[1]),
                        Imath::V2s((short)tupleVec[2], (short)tupleVec[3])));
@@ -353,6 +660,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box2i: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox2iProperty->set(
           Imath::Box2i(Imath::V2i(tupleVec[0], tupleVec[1]),
                        Imath::V2i(tupleVec[2], tupleVec[3])));
@@ -360,6 +668,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box2f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox2fProperty->set(
           Imath::Box2f(Imath::V2f(tupleVec[0], tupleVec[1]),
                        Imath::V2f(tupleVec[2], tupleVec[3])));
@@ -367,6 +676,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box2d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox2dProperty->set(
           Imath::Box2d(Imath::V2d(tupleVec[0], tupleVec[1]),
                        Imath::V2d(tupleVec[2], tupleVec[3])));
@@ -374,6 +684,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box3s: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 6);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox3sProperty->set(
           Imath::Box3s(Imath::V3s((short)tupleVec[0], (short)tupleVec[1],
                                   (short)tupleVec[2]),
@@ -383,6 +694,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box3i: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 6);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox3iProperty->set(
           Imath::Box3i(Imath::V3i(tupleVec[0], tupleVec[1], tupleVec[2]),
                        Imath::V3i(tupleVec[3], tupleVec[4], tupleVec[5])));
@@ -390,6 +702,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box3f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 6);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox3fProperty->set(
           Imath::Box3f(Imath::V3f(tupleVec[0], tupleVec[1], tupleVec[2]),
                        Imath::V3f(tupleVec[3], tupleVec[4], tupleVec[5])));
@@ -397,6 +710,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_box3d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 6);
+      oArchiveLock lock(prop->mArchive);
       prop->mBox3dProperty->set(
           Imath::Box3d(Imath::V3d(tupleVec[0], tupleVec[1], tupleVec[2]),
                        Imath::V3d(tupleVec[3], tupleVec[4], tupleVec[5])));
@@ -404,6 +718,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_m33f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 9);
+      oArchiveLock lock(prop->mArchive);
       prop->mM33fProperty->set(Imath::M33f(
           tupleVec[0], tupleVec[1], tupleVec[2], tupleVec[3], tupleVec[4],
           tupleVec[5], tupleVec[6], tupleVec[7], tupleVec[8]));
@@ -411,6 +726,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_m33d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 9);
+      oArchiveLock lock(prop->mArchive);
       prop->mM33dProperty->set(Imath::M33d(
           tupleVec[0], tupleVec[1], tupleVec[2], tupleVec[3], tupleVec[4],
           tupleVec[5], tupleVec[6], tupleVec[7], tupleVec[8]));
@@ -418,6 +734,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_m44f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 16);
+      oArchiveLock lock(prop->mArchive);
       prop->mM44fProperty->set(
           Imath::M44f(tupleVec[0], tupleVec[1], tupleVec[2], tupleVec[3],
                       tupleVec[4], tupleVec[5], tupleVec[6], tupleVec[7],
@@ -427,6 +744,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_m44d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 16);
+      oArchiveLock lock(prop->mArchive);
       prop->mM44dProperty->set(
           Imath::M44d(tupleVec[0], tupleVec[1], tupleVec[2], tupleVec[3],
                       tupleVec[4], tupleVec[5], tupleVec[6], tupleVec[7],
@@ -436,30 +754,35 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_quatf: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mQuatfProperty->set(Imath::Quatf(
           tupleVec[0], Imath::V3f(tupleVec[1], tupleVec[2], tupleVec[3])));
       break;
     }
     case propertyTP_quatd: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mQuatdProperty->set(Imath::Quatd(
           tupleVec[0], Imath::V3d(tupleVec[1], tupleVec[2], tupleVec[3])));
       break;
     }
     case propertyTP_c3h: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mC3hProperty->set(
           Imath::C3h((half)tupleVec[0], (half)tupleVec[1], (half)tupleVec[2]));
       break;
     }
     case propertyTP_c3f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mC3fProperty->set(
           Imath::C3f(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_c3c: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mC3cProperty->set(Imath::C3c((unsigned char)tupleVec[0],
                                          (unsigned char)tupleVec[1],
                                          (unsigned char)tupleVec[2]));
@@ -467,18 +790,21 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_c4h: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mC4hProperty->set(Imath::C4h((half)tupleVec[0], (half)tupleVec[1],
                                          (half)tupleVec[2], (half)tupleVec[3]));
       break;
     }
     case propertyTP_c4f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mC4fProperty->set(
           Imath::C4f(tupleVec[0], tupleVec[1], tupleVec[2], tupleVec[3]));
       break;
     }
     case propertyTP_c4c: {
       _COPY_TUPLE_TO_VALUE_(int, "i", 4);
+      oArchiveLock lock(prop->mArchive);
       prop->mC4cProperty->set(
           Imath::C4c((unsigned char)tupleVec[0], (unsigned char)tupleVec[1],
                      (unsigned char)tupleVec[2], (unsigned char)tupleVec[3]));
@@ -486,22 +812,26 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
     }
     case propertyTP_n2f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mN2fProperty->set(Imath::V2f(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_n2d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 2);
+      oArchiveLock lock(prop->mArchive);
       prop->mN2dProperty->set(Imath::V2d(tupleVec[0], tupleVec[1]));
       break;
     }
     case propertyTP_n3f: {
       _COPY_TUPLE_TO_VALUE_(float, "f", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mN3fProperty->set(
           Imath::V3f(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
     }
     case propertyTP_n3d: {
       _COPY_TUPLE_TO_VALUE_(double, "d", 3);
+      oArchiveLock lock(prop->mArchive);
       prop->mN3dProperty->set(
           Imath::V3d(tupleVec[0], tupleVec[1], tupleVec[2]));
       break;
@@ -516,7 +846,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBoolArrayProperty::sample_type(&values.front(),
                                                       values.size());
-      prop->mBoolArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_uchar_array: {
@@ -529,7 +859,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OUcharArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mUcharArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_char_array: {
@@ -542,7 +872,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OCharArrayProperty::sample_type(&values.front(),
                                                       values.size());
-      prop->mCharArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_uint16_array: {
@@ -551,7 +881,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OUInt16ArrayProperty::sample_type(tupleVec);
       }
-      prop->mUInt16ArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_int16_array: {
@@ -560,7 +890,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OInt16ArrayProperty::sample_type(tupleVec);
       }
-      prop->mInt16ArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_uint32_array: {
@@ -570,7 +900,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OUInt32ArrayProperty::sample_type(tupleVec);
       }
-      prop->mUInt32ArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_int32_array: {
@@ -580,7 +910,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OInt32ArrayProperty::sample_type(tupleVec);
       }
-      prop->mInt32ArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_uint64_array: {
@@ -589,7 +919,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OUInt64ArrayProperty::sample_type(tupleVec);
       }
-      prop->mUInt64ArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_int64_array: {
@@ -598,7 +928,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OInt64ArrayProperty::sample_type(tupleVec);
       }
-      prop->mInt64ArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_half_array: {
@@ -607,7 +937,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OHalfArrayProperty::sample_type(tupleVec);
       }
-      prop->mHalfArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_float_array: {
@@ -616,7 +946,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OFloatArrayProperty::sample_type(tupleVec);
       }
-      prop->mFloatArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_double_array: {
@@ -625,7 +955,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::ODoubleArrayProperty::sample_type(tupleVec);
       }
-      prop->mDoubleArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_string_array: {
@@ -634,7 +964,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (tupleVec.size() > 0) {
         sample = Abc::OStringArrayProperty::sample_type(tupleVec);
       }
-      prop->mStringArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_wstring_array: {
@@ -647,7 +977,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OWstringArrayProperty::sample_type(&values.front(),
                                                          values.size());
-      prop->mWstringArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
     }
     case propertyTP_v2s_array: {
       _COPY_TUPLE_TO_VECTOR_AND_CONVERT_(Imath::V2s, short, int, "i", 2);
@@ -655,7 +985,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV2sArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV2sArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v2i_array: {
@@ -664,7 +994,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV2iArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV2iArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v2f_array: {
@@ -673,7 +1003,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV2fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV2fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v2d_array: {
@@ -682,7 +1012,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV2dArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV2dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v3s_array: {
@@ -691,7 +1021,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV3sArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV3sArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v3i_array: {
@@ -700,7 +1030,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV3iArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV3iArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v3f_array: {
@@ -709,7 +1039,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV3fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV3fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_v3d_array: {
@@ -718,7 +1048,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OV3dArrayProperty::sample_type(&values.front(), values.size());
-      prop->mV3dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p2s_array: {
@@ -727,7 +1057,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP2sArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP2sArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p2i_array: {
@@ -736,7 +1066,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP2iArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP2iArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p2f_array: {
@@ -745,7 +1075,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP2fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP2fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p2d_array: {
@@ -754,7 +1084,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP2dArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP2dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p3s_array: {
@@ -763,7 +1093,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP3sArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP3sArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p3i_array: {
@@ -772,7 +1102,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP3iArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP3iArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p3f_array: {
@@ -781,7 +1111,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP3fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP3fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_p3d_array: {
@@ -790,7 +1120,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OP3dArrayProperty::sample_type(&values.front(), values.size());
-      prop->mP3dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box2s_array: {
@@ -799,7 +1129,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox2sArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox2sArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box2i_array: {
@@ -808,7 +1138,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox2iArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox2iArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box2f_array: {
@@ -817,7 +1147,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox2fArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox2fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box2d_array: {
@@ -826,7 +1156,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox2dArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox2dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box3s_array: {
@@ -835,7 +1165,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox3sArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox3sArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box3i_array: {
@@ -844,7 +1174,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox3iArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox3iArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box3f_array: {
@@ -853,7 +1183,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox3fArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox3fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_box3d_array: {
@@ -862,7 +1192,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OBox3dArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mBox3dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_m33f_array: {
@@ -871,7 +1201,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OM33fArrayProperty::sample_type(&values.front(),
                                                       values.size());
-      prop->mM33fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_m33d_array: {
@@ -880,7 +1210,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OM33dArrayProperty::sample_type(&values.front(),
                                                       values.size());
-      prop->mM33dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_m44f_array: {
@@ -889,7 +1219,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OM44fArrayProperty::sample_type(&values.front(),
                                                       values.size());
-      prop->mM44fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_m44d_array: {
@@ -898,7 +1228,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OM44dArrayProperty::sample_type(&values.front(),
                                                       values.size());
-      prop->mM44dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_quatf_array: {
@@ -907,7 +1237,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OQuatfArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mQuatfArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_quatd_array: {
@@ -916,7 +1246,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample = Abc::OQuatdArrayProperty::sample_type(&values.front(),
                                                        values.size());
-      prop->mQuatdArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_c3h_array: {
@@ -925,7 +1255,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OC3hArrayProperty::sample_type(&values.front(), values.size());
-      prop->mC3hArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_c3f_array: {
@@ -934,7 +1264,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OC3fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mC3fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_c3c_array: {
@@ -944,7 +1274,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OC3cArrayProperty::sample_type(&values.front(), values.size());
-      prop->mC3cArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_c4h_array: {
@@ -953,7 +1283,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OC4hArrayProperty::sample_type(&values.front(), values.size());
-      prop->mC4hArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_c4f_array: {
@@ -962,7 +1292,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OC4fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mC4fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_c4c_array: {
@@ -972,7 +1302,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::OC4cArrayProperty::sample_type(&values.front(), values.size());
-      prop->mC4cArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_n2f_array: {
@@ -981,7 +1311,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::ON2fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mN2fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_n2d_array: {
@@ -990,7 +1320,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::ON2dArrayProperty::sample_type(&values.front(), values.size());
-      prop->mN2dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_n3f_array: {
@@ -999,7 +1329,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::ON3fArrayProperty::sample_type(&values.front(), values.size());
-      prop->mN3fArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     case propertyTP_n3d_array: {
@@ -1008,7 +1338,7 @@ static PyObject *oProperty_setValues(PyObject *self, PyObject *args)
       if (values.size() > 0)
         sample =
             Abc::ON3dArrayProperty::sample_type(&values.front(), values.size());
-      prop->mN3dArrayProperty->set(sample);
+      oProperty_setSample(prop, sample);
       break;
     }
     default: {
@@ -1035,7 +1365,9 @@ static PyMethodDef oProperty_methods[] = {
      "Appends a new sample to the property, given the values provided. The "
      "values have to be a flat list of components, matching the count of the "
      "property. For example if this is a vector3farray property the tuple has "
-     "to contain a multiple of 3 float values."},
+     "to contain a multiple of 3 float values. Array properties also accept "
+     "any object exposing a contiguous buffer (numpy array, array.array, "
+     "string), which is written directly without a conversion."},
     {"isCompound", (PyCFunction)oProperty_isCompound, METH_NOARGS,
      "To distinguish between an oProperty and an oCompoundProperty, always "
      "returns false for oProperty."},
@@ -1592,64 +1924,16 @@ static PyTypeObject oProperty_Type = {
 #define _IF_CREATE_PROP_(tp, base, str) \
   _IF_CREATE_PROP_IMPL_(tp, base, str, Property, ArrayProperty)
 
-PyObject *oProperty_new(Abc::OCompoundProperty compound,
-                        std::string compoundFullName, char *in_propName,
-                        char *in_propType, int tsIndex, void *in_Archive)
+// creates the Alembic property of prop or wraps the existing one, called with
+// the archive locked. Returns false if prop isn't needed, because the property
+// is a compound or has no type. Other errors return true, prop is registered
+// anyway.
+static bool oProperty_create(oProperty *prop, oArchive *archive,
+                             Abc::OCompoundProperty &compound,
+                             const std::string &identifier, char *in_propName,
+                             char *in_propType, std::string propType,
+                             int tsIndex, bool &isCompound, std::string &error)
 {
-  ALEMBIC_TRY_STATEMENT
-
-  // check if we already have this property somewhere
-  // Abc::OCompoundProperty compound = getCompoundFromOObject(in_casted);
-  std::string identifier = compoundFullName;
-  identifier.append("/");
-  identifier.append(in_propName);
-
-  // INFO_MSG("propType = " << in_propType);
-  oArchive *archive = (oArchive *)in_Archive;
-
-  // check if it's an iCompoundProperty, they shouldn't have similar names to
-  // avoid confusion when reading it!
-  {
-    oCompoundProperty *cprop = oArchive_getCompPropElement(archive, identifier);
-    if (cprop) {
-      Py_INCREF(cprop);
-      return (PyObject *)cprop;
-    }
-  }
-
-  oProperty *prop = oArchive_getPropElement(archive, identifier);
-  if (prop) {
-    Py_INCREF(prop);
-    return (PyObject *)prop;
-  }
-
-  // if we don't have it yet, create a new one and insert it into our map
-  prop = PyObject_NEW(oProperty, &oProperty_Type);
-  prop->mBaseScalarProperty = NULL;
-  prop->mBoolProperty = NULL;
-  prop->mArchive = in_Archive;
-
-  std::string propType(in_propType ? in_propType : "");
-
-  // NEW check for intent! and assign it if necessary
-  {
-    string::size_type i_pos = propType.find('[');
-    if (i_pos != string::npos) {
-      string sz_intent =
-          propType.substr(i_pos + 1, propType.length() - i_pos - 2);
-      sscanf(sz_intent.c_str(), "%d", &(prop->intent));
-
-      // remove intent information from the property type
-      propType = propType.substr(0, i_pos).c_str();
-
-      // INFO_MSG("propType = " << propType << " with intent = " <<
-      // (prop->intent));
-    }
-    else {
-      prop->intent = 1;
-    }
-  }
-
   // get the compound property writer
   Abc::CompoundPropertyWriterPtr compoundWriter =
       GetCompoundPropertyWriterPtr(compound);  // this variable is unused!
@@ -1665,9 +1949,8 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
     if (baseProp.isCompound()) {
       // is a compound, must return an oCompoundProperty
       // INFO_MSG("It's a compound");
-      PyObject_FREE(prop);
-      return oCompoundProperty_new(compound, compoundFullName, in_propName,
-                                   tsIndex, in_Archive);
+      isCompound = true;
+      return false;
     }
     else if (baseProp.isArray()) {
       prop->mIsArray = true;
@@ -1684,8 +1967,6 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
           prop->mBaseScalarProperty->getMetaData().get("interpretation");
     }
 
-    oArchive_registerPropElement(archive, identifier, prop);
-
     // check for custom structs
     if (interpretation.empty())
       if (prop->intent > 1) {
@@ -1735,8 +2016,8 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
         }
       }
       else {
-        PyErr_SetString(getError(), "Invalid extend for vector property.");
-        return NULL;
+        error = "Invalid extend for vector property.";
+        return true;
       }
     }
     else if (interpretation == "point") {
@@ -1761,8 +2042,8 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
         }
       }
       else {
-        PyErr_SetString(getError(), "Invalid extend for point property.");
-        return NULL;
+        error = "Invalid extend for point property.";
+        return true;
       }
     }
     else if (interpretation == "box") {
@@ -1787,8 +2068,8 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
         }
       }
       else {
-        PyErr_SetString(getError(), "Invalid extend for box property.");
-        return NULL;
+        error = "Invalid extend for box property.";
+        return true;
       }
     }
     else if (interpretation == "matrix") {
@@ -1809,8 +2090,8 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
         }
       }
       else {
-        PyErr_SetString(getError(), "Invalid extend for matrix property.");
-        return NULL;
+        error = "Invalid extend for matrix property.";
+        return true;
       }
     }
     else if (interpretation == "quat") {
@@ -1857,8 +2138,8 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
         }
       }
       else {
-        PyErr_SetString(getError(), "Invalid extend for normal property.");
-        return NULL;
+        error = "Invalid extend for normal property.";
+        return true;
       }
     }
     else if (interpretation == "unknown") {
@@ -1868,18 +2149,14 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
   else {
     // here we need the property type
     if (in_propType == NULL) {
-      PyErr_SetString(getError(), "No property type specified!");
-      PyObject_FREE(prop);
-      return NULL;
+      error = "No property type specified!";
+      return false;
     }
     else if (strcmp(in_propType, "compound") == 0) {
-      PyObject_FREE(prop);
-      return oCompoundProperty_new(compound, compoundFullName, in_propName,
-                                   tsIndex, in_Archive);
+      isCompound = true;
+      return false;
     }
 
-    oArchive_registerPropElement(archive, identifier, prop);
-
     // check if this is an array
     if (propType.length() > 5) {
       prop->mIsArray = propType.substr(propType.length() - 5, 5) == "array";
@@ -2005,17 +2282,100 @@ PyObject *oProperty_new(Abc::OCompoundProperty compound,
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                    N3d,
                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                    "normal3d") else
     {
-      std::string error;
       error.append("Invalid property type '");
       error.append(in_propType);
       error.append("' for property '");
       error.append(identifier);
       error.append("'!");
-      PyErr_SetString(getError(), error.c_str());
-      return NULL;
     }
   }
 
+  return true;
+}
+
+PyObject *oProperty_new(Abc::OCompoundProperty compound,
+                        std::string compoundFullName, char *in_propName,
+                        char *in_propType, int tsIndex, void *in_Archive)
+{
+  ALEMBIC_TRY_STATEMENT
+
+  // check if we already have this property somewhere
+  // Abc::OCompoundProperty compound = getCompoundFromOObject(in_casted);
+  std::string identifier = compoundFullName;
+  identifier.append("/");
+  identifier.append(in_propName);
+
+  // INFO_MSG("propType = " << in_propType);
+  oArchive *archive = (oArchive *)in_Archive;
+
+  // check if it's an iCompoundProperty, they shouldn't have similar names to
+  // avoid confusion when reading it!
+  {
+    oCompoundProperty *cprop = oArchive_getCompPropElement(archive, identifier);
+    if (cprop) {
+      Py_INCREF(cprop);
+      return (PyObject *)cprop;
+    }
+  }
+
+  oProperty *prop = oArchive_getPropElement(archive, identifier);
+  if (prop) {
+    Py_INCREF(prop);
+    return (PyObject *)prop;
+  }
+
+  // if we don't have it yet, create a new one and insert it into our map
+  prop = PyObject_NEW(oProperty, &oProperty_Type);
+  prop->mBaseScalarProperty = NULL;
+  prop->mBoolProperty = NULL;
+  prop->mArchive = in_Archive;
+
+  std::string propType(in_propType ? in_propType : "");
+
+  // NEW check for intent! and assign it if necessary
+  {
+    string::size_type i_pos = propType.find('[');
+    if (i_pos != string::npos) {
+      string sz_intent =
+          propType.substr(i_pos + 1, propType.length() - i_pos - 2);
+      sscanf(sz_intent.c_str(), "%d", &(prop->intent));
+
+      // remove intent information from the property type
+      propType = propType.substr(0, i_pos).c_str();
+
+      // INFO_MSG("propType = " << propType << " with intent = " <<
+      // (prop->intent));
+    }
+    else {
+      prop->intent = 1;
+    }
+  }
+
+  bool isCompound = false;
+  std::string error;
+  bool created = false;
+  {
+    // another thread might be writing a sample of this archive
+    oArchiveLock lock(archive);
+    created = oProperty_create(prop, archive, compound, identifier, in_propName,
+                               in_propType, propType, tsIndex, isCompound,
+                               error);
+  }
+  if (!created) {
+    PyObject_FREE(prop);
+    if (isCompound) {
+      return oCompoundProperty_new(compound, compoundFullName, in_propName,
+                                   tsIndex, in_Archive);
+    }
+    PyErr_SetString(getError(), error.c_str());
+    return NULL;
+  }
+
+  oArchive_registerPropElement(archive, identifier, prop);
+  if (!error.empty()) {
+    PyErr_SetString(getError(), error.c_str());
+    return NULL;
+  }
   return (PyObject *)prop;
   ALEMBIC_PYOBJECT_CATCH_STATEMENT
 }
@@ -74,11 +74,16 @@ static PyObject *oXformProperty_setValues(PyObject *self, PyObject *args)
                      values[5], values[6], values[7], values[8], values[9],
                      values[10], values[11], values[12], values[13], values[14],
                      values[15]);
-  prop->mMembers->mSample.setInheritsXforms(true);
-  prop->mMembers->mSample.setMatrix(matrix);
-  prop->mMembers->mXformSchema.set(prop->mMembers->mSample);
+  size_t numSamples = 0;
+  {
+    oArchiveLock lock(prop->mArchive);
+    prop->mMembers->mSample.setInheritsXforms(true);
+    prop->mMembers->mSample.setMatrix(matrix);
+    prop->mMembers->mXformSchema.set(prop->mMembers->mSample);
+    numSamples = prop->mMembers->mXformSchema.getNumSamples();
+  }
 
-  return Py_BuildValue("I", prop->mMembers->mXformSchema.getNumSamples());
+  return Py_BuildValue("I", (unsigned int)numSamples);
   ALEMBIC_PYOBJECT_CATCH_STATEMENT
 }
 
@@ -177,12 +182,15 @@ PyObject *oXformProperty_new(oObjectPtr in_casted, void *in_Archive,
 
   // if we don't have it yet, create a new one and insert it into our map
   prop = PyObject_NEW(oXformProperty, &oXformProperty_Type);
-  prop->mMaxNbSamples =
-      archive->mArchive->getTimeSampling(tsIndex)->getNumStoredTimes();
-  prop->mMembers = new oXformMembers();
-  prop->mMembers->mXformSchema = in_casted.mXform->getSchema();
-  prop->mMembers->mXformSchema.setTimeSampling(
-      archive->mArchive->getTimeSampling(tsIndex));
+  {
+    oArchiveLock lock(archive);
+    prop->mMaxNbSamples =
+        archive->mArchive->getTimeSampling(tsIndex)->getNumStoredTimes();
+    prop->mMembers = new oXformMembers();
+    prop->mMembers->mXformSchema = in_casted.mXform->getSchema();
+    prop->mMembers->mXformSchema.setTimeSampling(
+        archive->mArchive->getTimeSampling(tsIndex));
+  }
 
   // prop->mXformSchema = new
   // AbcG::OXformSchema(in_casted.mXform->getSchema().getPtr(),Abc::kWrapExisting);
@@ -0,0 +1,84 @@
+import _ExocortexAlembicPython as alembic
+import sys
+import os
+import argparse
+import array
+import tempfile
+
+# Checks the time samplings written by copyArchive when retiming: every time t
+# becomes t * scale + t0 * (1 - scale) + offset, t0 being the first sample time
+# of its time sampling, and uniform and cyclic samplings keep their type.
+
+NB_SAMPLES = 6
+
+SAMPLINGS = [("uniform", (1.0 / 24.0, 1.0)),
+             ("cyclic",  ([0.5, 0.6, 0.8],)),
+             ("acyclic", ([2.0, 2.5, 4.0, 7.0, 7.25, 9.0],))]
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+def write_archive(path):
+   oa = alembic.getOArchive(path)
+   oa.createTimeSampling([alembic.createTimeSampling(ts_type, *ts_args) for ts_type, ts_args in SAMPLINGS])
+   for i in range(len(SAMPLINGS)):
+      mesh = oa.createObject("AbcGeom_PolyMesh_v1", "/mesh%d" % i, i + 1)
+      P = mesh.getProperty("P", "vector3farray")
+      for s in range(NB_SAMPLES):
+         P.setValues(array.array('f', [float(s)] * 3))
+      mesh.getProperty(".faceIndices", "int32array").setValues([0, 0, 0])
+
+def expected_times(times, scale, offset):
+   return [t * scale + times[0] * (1.0 - scale) + offset for t in times]
+
+def check_retime(src, dst, scale, offset, errors):
+   alembic.copyArchive(src, dst, scale=scale, offset=offset)
+   ia_src = alembic.getIArchive(src)
+   ia_dst = alembic.getIArchive(dst)
+   for i in range(len(SAMPLINGS)):
+      name = "/mesh%d" % i
+      ts_src = ia_src.getObject(name).getProperty("P").getSampleTimes()
+      ts_dst = ia_dst.getObject(name).getProperty("P").getSampleTimes()
+      label = "%s retimed by %g, %g" % (SAMPLINGS[i][0], scale, offset)
+
+      if ts_dst.getType() != SAMPLINGS[i][0]:
+         errors.append("%s: the type became %s" % (label, ts_dst.getType()))
+      expected = expected_times(ts_src.getTimeSamples(), scale, offset)
+      times = ts_dst.getTimeSamples()
+      if len(times) != len(expected) or max([abs(a - b) for a, b in zip(times, expected)]) > 1e-5:
+         errors.append("%s: got the times %s instead of %s" % (label, times, expected))
+      if ia_dst.getObject(name).getProperty("P").getNbStoredSamples() != NB_SAMPLES:
+         errors.append("%s: wrong number of samples" % label)
+   del ia_src
+   del ia_dst
+   os.remove(dst)
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+def main(args):
+   # parser args
+   parser = argparse.ArgumentParser(description="Check the uniform, cyclic and acyclic time samplings retimed by copyArchive.")
+   parser.add_argument("-d", "--dir", type=str, metavar="{folder}", help="folder for the archives, a temporary one by default")
+   ns = vars(parser.parse_args(args[1:]))
+
+   folder = ns["dir"] or tempfile.mkdtemp()
+   src = os.path.join(folder, "retime_in.abc")
+   dst = os.path.join(folder, "retime_out.abc")
+   errors = []
+
+   write_archive(src)
+   for scale, offset in [(1.0, 0.0), (2.0, 0.0), (0.5, 0.0), (1.0, 10.0), (3.0, -1.5)]:
+      check_retime(src, dst, scale, offset, errors)
+
+   os.remove(src)
+   if not ns["dir"]:
+      os.rmdir(folder)
+
+   for error in errors:
+      print("Error: " + error)
+   if errors:
+      print("FAILED, %d errors" % len(errors))
+      return 1
+   print("OK")
+   return 0
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+if __name__ == "__main__":
+   sys.exit(main(sys.argv))
@@ -0,0 +1,179 @@
+import _ExocortexAlembicPython as alembic
+import sys
+import os
+import argparse
+import array
+import struct
+import tempfile
+import threading
+import time
+
+# Stress test of the extension from several threads. Archives are written in
+# parallel (Ogawa and HDF5), read back in parallel, then one shared archive is
+# read by all the threads at once and another one is written by all of them.
+# Every value is checked, the exit code is 1 if anything went wrong.
+
+NB_MESHES = 4
+NB_SAMPLES = 5
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+# every value of a sample is the same, it identifies the archive, mesh and sample
+def sample_value(seed, mesh, sample):
+   return float(seed + mesh * NB_SAMPLES + sample)
+
+def write_archive(path, ogawa, seed, nb_points, errors):
+   try:
+      oa = alembic.getOArchive(path, ogawa)
+      oa.createTimeSampling([alembic.createTimeSampling("acyclic", [float(i) for i in range(NB_SAMPLES)])])
+      xf = oa.createObject("AbcGeom_Xform_v1", "/xf", 1)
+      for m in range(NB_MESHES):
+         mesh = oa.createObject("AbcGeom_PolyMesh_v1", "/xf/mesh%d" % m, 1)
+         P = mesh.getProperty("P", "vector3farray")
+         for s in range(NB_SAMPLES):
+            P.setValues(array.array('f', [sample_value(seed, m, s)] * (3 * nb_points)))
+         mesh.getProperty(".faceIndices", "int32array").setValues([0, 1, 2])
+   except Exception as e:
+      errors.append("writing " + path + ": " + str(e))
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+# reads a whole archive with getValues
+def check_archive(path, seed, nb_points, errors):
+   try:
+      ia = alembic.getIArchive(path)
+      for m in range(NB_MESHES):
+         P = ia.getObject("/xf/mesh%d" % m).getProperty("P")
+         for s in range(NB_SAMPLES):
+            vals = P.getValues(s)
+            expected = sample_value(seed, m, s)
+            if len(vals) != 3 * nb_points or vals[0] != expected or vals[-1] != expected:
+               errors.append("%s: wrong values for mesh %d sample %d" % (path, m, s))
+   except Exception as e:
+      errors.append("reading " + path + ": " + str(e))
+
+# reads one archive shared by all the threads, through getBuffer, and walks its hierarchy meanwhile
+def check_shared_archive(ia, seed, index, nb_points, nb_loops, errors):
+   try:
+      for loop in range(nb_loops):
+         for m in range(NB_MESHES):
+            P = ia.getObject("/xf/mesh%d" % m).getProperty("P")
+            for s in range(NB_SAMPLES):
+               data = buffer(P.getBuffer(s))
+               offset = 4 * ((index * 7919 + loop) % (3 * nb_points))
+               val = struct.unpack("f", data[offset:offset+4])[0]
+               if len(data) != 12 * nb_points or val != sample_value(seed, m, s):
+                  errors.append("shared archive: wrong value for mesh %d sample %d" % (m, s))
+               if len(ia.getIdentifiers()) != NB_MESHES + 1:
+                  errors.append("shared archive: wrong identifiers")
+   except Exception as e:
+      errors.append("reading the shared archive: " + str(e))
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+# a number which runs python code and lets other threads run when converted,
+# while the extension parses it
+class SlowNumber(object):
+   def __init__(self, value):
+      self.value = value
+   def __float__(self):
+      time.sleep(0)
+      return float(self.value)
+   def __int__(self):
+      time.sleep(0)
+      return int(self.value)
+
+# writes its own objects into an Ogawa archive shared by all the threads
+def write_shared_archive(oa, seed, index, nb_points, errors):
+   try:
+      ts = oa.createTimeSampling([alembic.createTimeSampling("acyclic", [float(i) for i in range(NB_SAMPLES)])])[0]
+      xf = oa.createObject("AbcGeom_Xform_v1", "/xf%d" % index, ts)
+      xf.setMetaData([str(index)] * 20)
+      mesh = oa.createObject("AbcGeom_PolyMesh_v1", "/xf%d/mesh" % index, ts)
+      P = mesh.getProperty("P", "vector3farray")
+      ids = mesh.getProperty("user", "compound").getProperty("id", "int32")
+      for s in range(NB_SAMPLES):
+         value = sample_value(seed, index, s)
+         xf.getProperty(".xform").setValues([SlowNumber(value)] + [0.0] * 15)
+         ids.setValues([SlowNumber(value)])
+         P.setValues(array.array('f', [value] * (3 * nb_points)))
+      mesh.getProperty(".faceIndices", "int32array").setValues([0, 1, 2])
+   except Exception as e:
+      errors.append("writing the shared archive: " + str(e))
+
+def check_shared_written_archive(path, seed, nb_threads, nb_points, errors):
+   try:
+      ia = alembic.getIArchive(path)
+      for i in range(nb_threads):
+         xf = ia.getObject("/xf%d" % i)
+         if list(xf.getMetaData()) != [str(i)] * 20:
+            errors.append("shared written archive: wrong metadata for /xf%d" % i)
+         mesh = ia.getObject("/xf%d/mesh" % i)
+         P = mesh.getProperty("P")
+         ids = mesh.getProperty("user").getProperty("id")
+         for s in range(NB_SAMPLES):
+            expected = sample_value(seed, i, s)
+            vals = P.getValues(s)
+            if len(vals) != 3 * nb_points or vals[0] != expected or vals[-1] != expected:
+               errors.append("shared written archive: wrong points for /xf%d sample %d" % (i, s))
+            if xf.getProperty(".xform").getValues(s)[0] != expected or list(ids.getValues(s)) != [int(expected)]:
+               errors.append("shared written archive: wrong scalars for /xf%d sample %d" % (i, s))
+   except Exception as e:
+      errors.append("reading the shared written archive: " + str(e))
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+def run_threads(target, args_list):
+   threads = [threading.Thread(target=target, args=args) for args in args_list]
+   for thread in threads:
+      thread.start()
+   for thread in threads:
+      thread.join()
+
+def main(args):
+   # parser args
+   parser = argparse.ArgumentParser(description="Read and write Alembic archives from several Python threads and check the values.")
+   parser.add_argument("-t", "--threads", type=int, metavar="{threads}", help="number of threads, default is 8", default=8)
+   parser.add_argument("-p", "--points", type=int, metavar="{points}", help="number of points per mesh, default is 100000", default=100000)
+   parser.add_argument("-l", "--loops", type=int, metavar="{loops}", help="number of passes over the shared archive, default is 3", default=3)
+   parser.add_argument("-d", "--dir", type=str, metavar="{folder}", help="folder for the archives, a temporary one by default")
+   ns = vars(parser.parse_args(args[1:]))
+
+   folder = ns["dir"] or tempfile.mkdtemp()
+   nb_threads = ns["threads"]
+   nb_points = ns["points"]
+   paths = [os.path.join(folder, "threaded%d.abc" % i) for i in range(nb_threads)]
+   seeds = [i * 1000 for i in range(nb_threads)]
+   errors = []
+
+   # one writer per archive, every other one is HDF5 which keeps the GIL
+   run_threads(write_archive, [(paths[i], i % 2 == 0, seeds[i], nb_points, errors) for i in range(nb_threads)])
+   if not errors:
+      run_threads(check_archive, [(paths[i], seeds[i], nb_points, errors) for i in range(nb_threads)])
+   if not errors:
+      ia = alembic.getIArchive(paths[0])
+      run_threads(check_shared_archive, [(ia, seeds[0], i, nb_points, ns["loops"], errors) for i in range(nb_threads)])
+      del ia
+
+   shared_path = os.path.join(folder, "threadedShared.abc")
+   paths.append(shared_path)
+   if not errors:
+      oa = alembic.getOArchive(shared_path, True)
+      run_threads(write_shared_archive, [(oa, seeds[0], i, nb_points, errors) for i in range(nb_threads)])
+      del oa
+   if not errors:
+      check_shared_written_archive(shared_path, seeds[0], nb_threads, nb_points, errors)
+
+   for path in paths:
+      if os.path.exists(path):
+         os.remove(path)
+   if not ns["dir"]:
+      os.rmdir(folder)
+
+   for error in errors[:20]:
+      print("Error: " + error)
+   if errors:
+      print("FAILED, %d errors" % len(errors))
+      return 1
+   print("OK")
+   return 0
+
+# ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
+if __name__ == "__main__":
+   sys.exit(main(sys.argv))
@@ -3,6 +3,12 @@
 #include "CommonMeshUtilities.h"
 #include "CommonUtilities.h"
 
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <memory>
+
 AbcObjectCache::AbcObjectCache(Alembic::Abc::IObject& objToCache)
     : obj(objToCache),
       isMeshTopoDynamic(false),
@@ -23,6 +29,18 @@ AbcObjectCache::AbcObjectCache(Alembic::Abc::IObject& objToCache)
   }
 }
 
+AbcObjectCache::AbcObjectCache(Alembic::Abc::IObject& objToCache,
+                               int numSamples, bool isConstant,
+                               bool isMeshPointCache, bool isMeshTopoDynamic)
+    : obj(objToCache),
+      numSamples(numSamples),
+      isConstant(isConstant),
+      isMeshPointCache(isMeshPointCache),
+      isMeshTopoDynamic(isMeshTopoDynamic),
+      fullName(objToCache.getFullName())
+{
+}
+
 AbcObjectCache::~AbcObjectCache() {}
 IXformPtr AbcObjectCache::getXform()
 {
@@ -52,32 +70,258 @@ Abc::M44d AbcObjectCache::getXformMatrix(int index)
   return iXformMap[index];
 }
 
-AbcObjectCache* addObjectToCache(AbcArchiveCache* fullNameToObjectCache,
-                                 Abc::IObject& obj,
-                                 std::string parentIdentifier,
-                                 CommonProgressBar* pBar)
+AbcArchiveCache::AbcArchiveCache() {}
+AbcArchiveCache::~AbcArchiveCache() { clear(); }
+AbcArchiveCache::shard& AbcArchiveCache::getShard(const std::string& fullName)
 {
-  ESS_PROFILE_SCOPE("addObjectToCache");
-  AbcObjectCache objectCache(obj);
-  objectCache.parentIdentifier = parentIdentifier;
-  for (int i = 0; i < obj.getNumChildren(); i++) {
-    if (pBar) {
-      pBar->incr(1);
-      if (!(i % 20) && pBar->isCancelled()) return 0;
-    }
+  return m_shards[boost::hash<std::string>()(fullName) % NUM_SHARDS];
+}
 
-    Abc::IObject child = obj.getChild(i);
-    AbcObjectCache* childObjectCache = addObjectToCache(
-        fullNameToObjectCache, child, objectCache.fullName, pBar);
-    if (childObjectCache == 0) return 0;
+AbcArchiveCache::iterator AbcArchiveCache::find(const std::string& fullName)
+{
+  shard& s = getShard(fullName);
+  boost::mutex::scoped_lock lock(s.lock);
+  boost::unordered_map<std::string, value_type*>::iterator it =
+      s.entries.find(fullName);
+  return it == s.entries.end() ? end() : it->second;
+}
 
-    objectCache.childIdentifiers.push_back(childObjectCache->fullName);
+size_t AbcArchiveCache::size()
+{
+  size_t result = 0;
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    boost::mutex::scoped_lock lock(m_shards[i].lock);
+    result += m_shards[i].entries.size();
   }
-  fullNameToObjectCache->insert(
-      AbcArchiveCache::value_type(objectCache.fullName, objectCache));
-  return &(fullNameToObjectCache->find(objectCache.fullName)->second);
+  return result;
 }
 
+void AbcArchiveCache::clear()
+{
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    boost::mutex::scoped_lock lock(m_shards[i].lock);
+    for (boost::unordered_map<std::string, value_type*>::iterator it =
+             m_shards[i].entries.begin();
+         it != m_shards[i].entries.end(); ++it) {
+      delete it->second;
+    }
+    m_shards[i].entries.clear();
+  }
+}
+
+AbcArchiveCache::iterator AbcArchiveCache::insert(value_type* entry)
+{
+  // still deleted if the table fails to grow
+  std::auto_ptr<value_type> owned(entry);
+  shard& s = getShard(entry->first);
+  boost::mutex::scoped_lock lock(s.lock);
+  std::pair<boost::unordered_map<std::string, value_type*>::iterator, bool>
+      result = s.entries.insert(std::make_pair(entry->first, entry));
+  if (result.second) {
+    owned.release();
+  }
+  return result.first->second;
+}
+
+/**
+ * Builds the cache entries of a hierarchy with a few threads. Every entry
+ * only needs the names of its children, so each object is an independent
+ * task. A thread walks its subtrees depth first on a private stack and
+ * hands the oldest pending subtrees over to the shared queue as soon as
+ * another thread runs out of work.
+ */
+class AbcArchiveCacheBuilder {
+ public:
+  AbcArchiveCacheBuilder(AbcArchiveCache* pCache, CommonProgressBar* pBar)
+      : m_pCache(pCache),
+        m_pBar(pBar),
+        m_busy(0),
+        m_waiting(0),
+        m_processed(0),
+        m_reported(0),
+        m_cancelled(false)
+  {
+  }
+
+  bool build(Abc::IObject& top, int numThreads)
+  {
+    m_shared.push_back(task(top, ""));
+    m_busy = numThreads;
+
+    boost::thread_group threads;
+    for (int i = 1; i < numThreads; i++) {
+      threads.create_thread(
+          boost::bind(&AbcArchiveCacheBuilder::work, this, false));
+    }
+    work(true);
+    threads.join_all();
+
+    if (m_pBar && m_processed > m_reported) {
+      m_pBar->incr((int)(m_processed - m_reported));
+    }
+
+    if (!m_error.empty()) {
+      throw Alembic::Util::Exception(m_error);
+    }
+    return !m_cancelled;
+  }
+
+ private:
+  struct task {
+    task(const Abc::IObject& o, const std::string& parent)
+        : obj(o), parentIdentifier(parent)
+    {
+    }
+    Abc::IObject obj;
+    std::string parentIdentifier;
+  };
+
+  // number of entries built between two looks at the shared state
+  enum { SYNC_INTERVAL = 20 };
+
+  void work(bool isCallingThread)
+  {
+    try {
+      run(isCallingThread);
+    }
+    catch (std::exception& e) {
+      fail(e.what());
+    }
+    catch (...) {
+      fail("unknown error while caching the archive");
+    }
+  }
+
+  // stops the other threads, the error is rethrown by build
+  void fail(const char* error)
+  {
+    boost::mutex::scoped_lock lock(m_lock);
+    if (m_error.empty()) {
+      m_error = error;
+    }
+    m_cancelled = true;
+    m_wake.notify_all();
+  }
+
+  void run(bool isCallingThread)
+  {
+    std::vector<task> local;
+    size_t built = 0;
+    for (;;) {
+      if (local.empty()) {
+        boost::mutex::scoped_lock lock(m_lock);
+        m_processed += built;
+        built = 0;
+        m_busy--;
+        while (m_shared.empty() && m_busy > 0 && !m_cancelled) {
+          m_waiting++;
+          if (isCallingThread) {
+            m_wake.timed_wait(lock, boost::posix_time::milliseconds(100));
+            lock.unlock();
+            reportProgress();
+            lock.lock();
+          }
+          else {
+            m_wake.wait(lock);
+          }
+          m_waiting--;
+        }
+        if (m_shared.empty() || m_cancelled) {
+          m_wake.notify_all();
+          return;
+        }
+        local.push_back(m_shared.front());
+        m_shared.pop_front();
+        m_busy++;
+      }
+
+      task current = local.back();
+      local.pop_back();
+      addEntry(current, local);
+
+      if (++built % SYNC_INTERVAL == 0) {
+        {
+          boost::mutex::scoped_lock lock(m_lock);
+          m_processed += built;
+          built = 0;
+          if (m_cancelled) {
+            return;
+          }
+          // the front of the stack holds the biggest pending subtrees
+          if (m_waiting > 0 && local.size() > 1) {
+            const size_t count = local.size() / 2;
+            m_shared.insert(m_shared.end(), local.begin(),
+                            local.begin() + count);
+            local.erase(local.begin(), local.begin() + count);
+            m_wake.notify_all();
+          }
+        }
+        if (isCallingThread) {
+          reportProgress();
+        }
+      }
+    }
+  }
+
+  void addEntry(task& current, std::vector<task>& local)
+  {
+    // owned until the cache takes it, reading the children can throw
+    std::auto_ptr<AbcArchiveCache::value_type> entry(
+        new AbcArchiveCache::value_type(current.obj));
+    AbcObjectCache& objectCache = entry->second;
+    objectCache.parentIdentifier = current.parentIdentifier;
+
+    const size_t numChildren = current.obj.getNumChildren();
+    objectCache.childIdentifiers.reserve(numChildren);
+    for (size_t i = 0; i < numChildren; i++) {
+      objectCache.childIdentifiers.push_back(
+          current.obj.getChildHeader(i).getFullName());
+    }
+    // reversed, so the children are popped in order
+    for (size_t i = numChildren; i > 0; i--) {
+      local.push_back(
+          task(current.obj.getChild(i - 1), objectCache.fullName));
+    }
+
+    m_pCache->insert(entry.release());
+  }
+
+  // only called from the thread that owns the progress bar
+  void reportProgress()
+  {
+    if (!m_pBar) {
+      return;
+    }
+    size_t processed;
+    {
+      boost::mutex::scoped_lock lock(m_lock);
+      processed = m_processed;
+    }
+    if (processed > m_reported) {
+      m_pBar->incr((int)(processed - m_reported));
+      m_reported = processed;
+    }
+    if (m_pBar->isCancelled()) {
+      boost::mutex::scoped_lock lock(m_lock);
+      m_cancelled = true;
+      m_wake.notify_all();
+    }
+  }
+
+  AbcArchiveCache* m_pCache;
+  CommonProgressBar* m_pBar;
+
+  boost::mutex m_lock;
+  boost::condition_variable m_wake;
+  std::deque<task> m_shared;
+  int m_busy;     // threads that are not waiting for work
+  int m_waiting;  // threads that are waiting for work
+  size_t m_processed;
+  size_t m_reported;
+  bool m_cancelled;
+  std::string m_error;
+};
+
 bool s_hasRunOnceRun = false;
 
 void runonce()
@@ -92,7 +336,7 @@ void runonce()
 
 bool createAbcArchiveCache(Abc::IArchive* pArchive,
                            AbcArchiveCache* fullNameToObjectCache,
-                           CommonProgressBar* pBar)
+                           CommonProgressBar* pBar, int numThreads)
 {
   ESS_PROFILE_SCOPE("createAbcArchiveCache");
   EC_LOG_INFO("Creating AbcArchiveCache for archive: " << pArchive->getName());
@@ -100,5 +344,6 @@ bool createAbcArchiveCache(Abc::IArchive* pArchive,
   runonce();
 
   Abc::IObject top = pArchive->getTop();
-  return addObjectToCache(fullNameToObjectCache, top, "", pBar) != 0;
+  AbcArchiveCacheBuilder builder(fullNameToObjectCache, pBar);
+  return builder.build(top, std::max(numThreads, 1));
 }
@@ -2,6 +2,9 @@
 #define __COMMON_ABC_CACHE_H__
 
 #include <boost/smart_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/utility.hpp>
 
 #include "CommonAlembic.h"
 #include "CommonPBar.h"
@@ -12,6 +15,10 @@ class AbcObjectCache {
  protected:
  public:
   AbcObjectCache(Alembic::Abc::IObject &objToCache);
+  // restores an entry from the sidecar index without probing the object
+  AbcObjectCache(Alembic::Abc::IObject &objToCache, int numSamples,
+                 bool isConstant, bool isMeshPointCache,
+                 bool isMeshTopoDynamic);
   ~AbcObjectCache();
 
   // AbcObjectCache(const AbcObjectCache& cache);
@@ -34,10 +41,59 @@ class AbcObjectCache {
   std::map<int, Abc::M44d> iXformMap;
 };
 
-typedef std::map<std::string, AbcObjectCache> AbcArchiveCache;
+/**
+ * Full name to AbcObjectCache table. Entries are built in place and never
+ * copied or moved, so the pointers returned by find stay valid until clear.
+ * The table is split in shards with their own lock, the threads building the
+ * cache rarely wait on each other.
+ */
+class AbcArchiveCache : boost::noncopyable {
+ public:
+  struct value_type {
+    value_type(Abc::IObject &obj) : first(obj.getFullName()), second(obj) {}
+    value_type(Abc::IObject &obj, int numSamples, bool isConstant,
+               bool isMeshPointCache, bool isMeshTopoDynamic)
+        : first(obj.getFullName()),
+          second(obj, numSamples, isConstant, isMeshPointCache,
+                 isMeshTopoDynamic)
+    {
+    }
+    const std::string first;
+    AbcObjectCache second;
+  };
+  // used like a map iterator, end() is NULL
+  typedef value_type *iterator;
+
+  AbcArchiveCache();
+  ~AbcArchiveCache();
+
+  iterator find(const std::string &fullName);
+  iterator end() const { return NULL; }
+  size_t size();
+  void clear();
+
+  // takes ownership of the entry, returns the one already in the table if
+  // the name is taken
+  iterator insert(value_type *entry);
+
+ private:
+  enum { NUM_SHARDS = 64 };
+
+  struct shard {
+    boost::mutex lock;
+    boost::unordered_map<std::string, value_type *> entries;
+  };
+
+  shard &getShard(const std::string &fullName);
+
+  shard m_shards[NUM_SHARDS];
+};
 
+// numThreads > 1 builds sibling subtrees concurrently, only use it with
+// archives that support concurrent reads (Ogawa). The progress bar is only
+// touched from the calling thread.
 bool createAbcArchiveCache(Abc::IArchive *pArchive,
                            AbcArchiveCache *fullNameToObjectCache,
-                           CommonProgressBar *pBar = 0);
+                           CommonProgressBar *pBar = 0, int numThreads = 1);
 
 #endif  // __COMMON_ABC_CACHE_H__
@@ -0,0 +1,313 @@
+#include "CommonAbcCacheIndex.h"
+#include "CommonAlembic.h"
+#include "CommonUtilities.h"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+namespace {
+
+const char INDEX_MAGIC[8] = {'E', 'X', 'O', 'C', 'I', 'D', 'X', '\0'};
+// also tells apart indices written on a machine with another byte order
+const AbcA::uint32_t INDEX_VERSION = 2;
+
+enum {
+  ENTRY_CONSTANT = 1 << 0,
+  ENTRY_MESH_POINT_CACHE = 1 << 1,
+  ENTRY_MESH_TOPO_DYNAMIC = 1 << 2
+};
+
+struct IndexHeader {
+  char magic[8];
+  AbcA::uint32_t version;
+  AbcA::uint32_t numEntries;
+  AbcA::uint64_t archiveSize;
+  AbcA::int64_t archiveTime;
+  AbcA::uint64_t archiveHash[2];
+  AbcA::uint64_t stringsSize;
+};
+
+// entries are stored breadth first, so the children of an entry are
+// consecutive and come after their parent
+struct IndexEntry {
+  AbcA::uint32_t name;  // offsets in the string block
+  AbcA::uint32_t nameLength;
+  AbcA::uint32_t schema;
+  AbcA::uint32_t schemaLength;
+  AbcA::int32_t parent;
+  AbcA::uint32_t firstChild;
+  AbcA::uint32_t numChildren;
+  AbcA::int32_t numSamples;
+  AbcA::uint32_t flags;
+};
+
+// bytes hashed at each end of the archive
+enum { SIGNATURE_BYTES = 4096 };
+
+// size, time and a hash of both ends of the archive. The head holds the
+// position of the root group for Ogawa archives but is mostly constant for
+// HDF5 ones, whose latest metadata is written at the end.
+bool getArchiveSignature(const std::string& path, IndexHeader& header)
+{
+  try {
+    header.archiveSize = (AbcA::uint64_t)boost::filesystem::file_size(path);
+    header.archiveTime =
+        (AbcA::int64_t)boost::filesystem::last_write_time(path);
+  }
+  catch (boost::filesystem::filesystem_error&) {
+    return false;
+  }
+
+  std::vector<char> bytes(2 * SIGNATURE_BYTES, 0);
+  std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  file.read(&bytes[0], SIGNATURE_BYTES);
+  if (header.archiveSize > SIGNATURE_BYTES) {
+    file.clear();
+    file.seekg(-(std::streamoff)std::min<AbcA::uint64_t>(
+                   header.archiveSize - SIGNATURE_BYTES, SIGNATURE_BYTES),
+               std::ios::end);
+    file.read(&bytes[SIGNATURE_BYTES], SIGNATURE_BYTES);
+  }
+  Alembic::Util::MurmurHash3_x64_128(&bytes[0], bytes.size(), 1,
+                                     header.archiveHash);
+  return true;
+}
+
+// unique to the writer, sessions on other machines may share the folder
+std::string getTempIndexPath(const std::string& indexPath)
+{
+  const boost::uuids::uuid id = boost::uuids::random_generator()();
+  return indexPath + "." + boost::lexical_cast<std::string>(id) + ".tmp";
+}
+
+std::string getSchema(const Abc::IObject& obj)
+{
+  return obj.getMetaData().get("schema");
+}
+
+}  // namespace
+
+bool isAbcArchiveCacheIndexEnabled()
+{
+  const char* value = getenv("EXOCORTEX_ALEMBIC_CACHE_INDEX");
+  return value != NULL && atoi(value) != 0;
+}
+
+std::string getAbcArchiveCacheIndexPath(const std::string& archivePath)
+{
+  return archivePath + ".idx";
+}
+
+bool loadAbcArchiveCacheIndex(Abc::IArchive* pArchive,
+                              AbcArchiveCache* fullNameToObjectCache)
+{
+  ESS_PROFILE_SCOPE("loadAbcArchiveCacheIndex");
+  const std::string archivePath = pArchive->getName();
+  const std::string indexPath = getAbcArchiveCacheIndexPath(archivePath);
+  if (!boost::filesystem::exists(indexPath)) {
+    return false;
+  }
+
+  boost::iostreams::mapped_file_source file;
+  try {
+    file.open(indexPath);
+  }
+  catch (std::exception& e) {
+    EC_LOG_WARNING("Can't map Abc cache index " << indexPath << ": "
+                                                << e.what());
+    return false;
+  }
+
+  const char* data = file.data();
+  const size_t size = file.size();
+  if (size < sizeof(IndexHeader)) {
+    return false;
+  }
+
+  IndexHeader header;
+  memcpy(&header, data, sizeof(header));
+  IndexHeader current;
+  if (memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+      header.version != INDEX_VERSION ||
+      !getArchiveSignature(archivePath, current) ||
+      header.archiveSize != current.archiveSize ||
+      header.archiveTime != current.archiveTime ||
+      header.archiveHash[0] != current.archiveHash[0] ||
+      header.archiveHash[1] != current.archiveHash[1]) {
+    EC_LOG_INFO("Abc cache index is out of date: " << indexPath);
+    return false;
+  }
+
+  const size_t entriesSize = header.numEntries * sizeof(IndexEntry);
+  if (header.numEntries == 0 ||
+      size != sizeof(IndexHeader) + entriesSize + header.stringsSize) {
+    return false;
+  }
+  const IndexEntry* entries =
+      reinterpret_cast<const IndexEntry*>(data + sizeof(IndexHeader));
+  const char* strings = data + sizeof(IndexHeader) + entriesSize;
+
+  // the entries still need their IObject, they are resolved through the
+  // parents which only reads the object headers
+  std::vector<AbcArchiveCache::value_type*> loaded(header.numEntries);
+  bool valid = true;
+  for (AbcA::uint32_t i = 0; i < header.numEntries && valid; i++) {
+    const IndexEntry& entry = entries[i];
+    if ((AbcA::uint64_t)entry.name + entry.nameLength > header.stringsSize ||
+        (AbcA::uint64_t)entry.schema + entry.schemaLength >
+            header.stringsSize ||
+        entry.parent >= (AbcA::int32_t)i ||
+        (AbcA::uint64_t)entry.firstChild + entry.numChildren >
+            header.numEntries) {
+      valid = false;
+      break;
+    }
+
+    Abc::IObject obj;
+    if (entry.parent < 0) {
+      obj = pArchive->getTop();
+    }
+    else {
+      const IndexEntry& parent = entries[entry.parent];
+      if (i < parent.firstChild || i >= parent.firstChild + parent.numChildren) {
+        valid = false;
+        break;
+      }
+      obj = loaded[entry.parent]->second.obj.getChild(i - parent.firstChild);
+    }
+
+    const std::string name(strings + entry.name, entry.nameLength);
+    const std::string schema(strings + entry.schema, entry.schemaLength);
+    if (!obj.valid() || obj.getFullName() != name || getSchema(obj) != schema) {
+      valid = false;
+      break;
+    }
+
+    AbcArchiveCache::value_type* cacheEntry = new AbcArchiveCache::value_type(
+        obj, entry.numSamples, (entry.flags & ENTRY_CONSTANT) != 0,
+        (entry.flags & ENTRY_MESH_POINT_CACHE) != 0,
+        (entry.flags & ENTRY_MESH_TOPO_DYNAMIC) != 0);
+    AbcObjectCache& objectCache = cacheEntry->second;
+    if (entry.parent >= 0) {
+      objectCache.parentIdentifier = loaded[entry.parent]->first;
+    }
+    objectCache.childIdentifiers.reserve(entry.numChildren);
+    for (AbcA::uint32_t c = 0; c < entry.numChildren; c++) {
+      const IndexEntry& child = entries[entry.firstChild + c];
+      objectCache.childIdentifiers.push_back(
+          std::string(strings + child.name, child.nameLength));
+    }
+    loaded[i] = fullNameToObjectCache->insert(cacheEntry);
+  }
+
+  if (!valid) {
+    EC_LOG_WARNING("Abc cache index doesn't match the archive: " << indexPath);
+    fullNameToObjectCache->clear();
+    return false;
+  }
+
+  EC_LOG_INFO("Loaded Abc cache index: " << indexPath);
+  return true;
+}
+
+bool saveAbcArchiveCacheIndex(Abc::IArchive* pArchive,
+                              AbcArchiveCache* fullNameToObjectCache)
+{
+  ESS_PROFILE_SCOPE("saveAbcArchiveCacheIndex");
+  const std::string archivePath = pArchive->getName();
+  const std::string indexPath = getAbcArchiveCacheIndexPath(archivePath);
+
+  IndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  header.version = INDEX_VERSION;
+  if (!getArchiveSignature(archivePath, header)) {
+    return false;
+  }
+
+  // flatten breadth first from the root
+  std::vector<AbcArchiveCache::value_type*> order;
+  std::vector<IndexEntry> entries;
+  std::string strings;
+  AbcArchiveCache::iterator root = fullNameToObjectCache->find("/");
+  if (root == fullNameToObjectCache->end()) {
+    return false;
+  }
+  order.push_back(root);
+  entries.resize(1);
+  entries[0].parent = -1;
+  for (size_t i = 0; i < order.size(); i++) {
+    const AbcObjectCache& objectCache = order[i]->second;
+    IndexEntry& entry = entries[i];
+    entry.name = (AbcA::uint32_t)strings.size();
+    entry.nameLength = (AbcA::uint32_t)objectCache.fullName.size();
+    strings += objectCache.fullName;
+    const std::string schema = getSchema(objectCache.obj);
+    entry.schema = (AbcA::uint32_t)strings.size();
+    entry.schemaLength = (AbcA::uint32_t)schema.size();
+    strings += schema;
+    entry.numSamples = objectCache.numSamples;
+    entry.flags = (objectCache.isConstant ? ENTRY_CONSTANT : 0) |
+                  (objectCache.isMeshPointCache ? ENTRY_MESH_POINT_CACHE : 0) |
+                  (objectCache.isMeshTopoDynamic ? ENTRY_MESH_TOPO_DYNAMIC : 0);
+    entry.firstChild = (AbcA::uint32_t)order.size();
+    entry.numChildren = (AbcA::uint32_t)objectCache.childIdentifiers.size();
+
+    for (size_t c = 0; c < objectCache.childIdentifiers.size(); c++) {
+      AbcArchiveCache::iterator child =
+          fullNameToObjectCache->find(objectCache.childIdentifiers[c]);
+      if (child == fullNameToObjectCache->end()) {
+        return false;
+      }
+      order.push_back(child);
+      IndexEntry childEntry;
+      childEntry.parent = (AbcA::int32_t)i;
+      // entries may move, don't keep the reference across the push_back
+      entries.push_back(childEntry);
+    }
+  }
+  header.numEntries = (AbcA::uint32_t)entries.size();
+  header.stringsSize = strings.size();
+
+  // written next to the final file and renamed, so other sessions never map
+  // a partial index
+  const std::string tempPath = getTempIndexPath(indexPath);
+  {
+    std::ofstream file(tempPath.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&entries[0]),
+               entries.size() * sizeof(IndexEntry));
+    file.write(strings.data(), strings.size());
+    if (!file) {
+      file.close();
+      boost::filesystem::remove(tempPath);
+      return false;
+    }
+  }
+
+  try {
+    if (boost::filesystem::exists(indexPath)) {
+      boost::filesystem::remove(indexPath);
+    }
+    boost::filesystem::rename(tempPath, indexPath);
+  }
+  catch (boost::filesystem::filesystem_error& e) {
+    EC_LOG_WARNING("Can't write Abc cache index " << indexPath << ": "
+                                                  << e.what());
+    boost::system::error_code ec;
+    boost::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  EC_LOG_INFO("Wrote Abc cache index: " << indexPath);
+  return true;
+}
@@ -0,0 +1,28 @@
+#ifndef __COMMON_ABC_CACHE_INDEX_H__
+#define __COMMON_ABC_CACHE_INDEX_H__
+
+#include "CommonAbcCache.h"
+
+/**
+ * Optional sidecar index next to an archive ("foo.abc.idx") that stores the
+ * flattened hierarchy of its AbcArchiveCache: names, schemas, sample counts,
+ * constant/topology flags and children. Loading it skips the property probes
+ * done when the cache is built from the archive.
+ *
+ * The index is only trusted if the size, modification time and a hash of the
+ * first and last 4KB of the archive still match. It is enabled by setting the
+ * EXOCORTEX_ALEMBIC_CACHE_INDEX environment variable to 1.
+ */
+bool isAbcArchiveCacheIndexEnabled();
+
+std::string getAbcArchiveCacheIndexPath(const std::string &archivePath);
+
+// returns false if there is no valid index for the archive, the cache is left
+// empty in that case
+bool loadAbcArchiveCacheIndex(Abc::IArchive *pArchive,
+                              AbcArchiveCache *fullNameToObjectCache);
+
+bool saveAbcArchiveCacheIndex(Abc::IArchive *pArchive,
+                              AbcArchiveCache *fullNameToObjectCache);
+
+#endif  // __COMMON_ABC_CACHE_INDEX_H__
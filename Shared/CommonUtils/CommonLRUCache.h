@@ -0,0 +1,185 @@
+#ifndef __COMMON_LRU_CACHE_H__
+#define __COMMON_LRU_CACHE_H__
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/utility.hpp>
+
+#include <list>
+
+// every entry costs 1, the budget of the cache is a number of entries
+struct LRUCacheEntryCount {
+  template <class Data>
+  size_t operator()(const Data&) const
+  {
+    return 1;
+  }
+};
+
+// the budget of the cache is a number of bytes, for shared pointers to
+// array samples
+struct LRUCacheArraySampleBytes {
+  template <class SamplePtr>
+  size_t operator()(const SamplePtr& sample) const
+  {
+    return sample ? sample->size() * sample->getDataType().getNumBytes() : 0;
+  }
+};
+
+/**
+ * Least recently used cache. The entries are kept in a list ordered by use
+ * and found through a hash table, so lookups, inserts and evictions don't
+ * depend on the number of entries.
+ *
+ * SizeOf tells what an entry costs, the least recently used entries are
+ * evicted until the total cost fits the budget. Data is copied in and out,
+ * so it should be cheap to copy, a shared pointer usually.
+ *
+ * All the methods lock, one cache can be shared by the nodes reading the same
+ * archive.
+ */
+template <class Key, class Data, class SizeOf = LRUCacheEntryCount,
+          class Hash = boost::hash<Key> >
+class LRUCache : boost::noncopyable {
+ private:
+  struct Entry {
+    Entry(const Key& k, const Data& d, size_t s) : key(k), data(d), size(s) {}
+    Key key;
+    Data data;
+    size_t size;
+  };
+  typedef std::list<Entry> EntryList;
+  typedef boost::unordered_map<Key, typename EntryList::iterator, Hash>
+      EntryMap;
+
+  mutable boost::mutex lock;
+  // most recently used first
+  EntryList entries;
+  EntryMap lookup;
+  SizeOf sizeOf;
+  size_t budget;
+  size_t usage;
+  boost::uint64_t hits;
+  boost::uint64_t misses;
+  boost::uint64_t evictions;
+
+  // expects the lock to be held
+  void evict(size_t target)
+  {
+    while (usage > target && !entries.empty()) {
+      Entry& oldest = entries.back();
+      usage -= oldest.size;
+      lookup.erase(oldest.key);
+      entries.pop_back();
+      ++evictions;
+    }
+  }
+
+ public:
+  struct Stats {
+    size_t entries;
+    size_t usage;
+    size_t budget;
+    boost::uint64_t hits;
+    boost::uint64_t misses;
+    boost::uint64_t evictions;
+  };
+
+  explicit LRUCache(size_t _budget = 2, const SizeOf& _sizeOf = SizeOf())
+      : sizeOf(_sizeOf),
+        budget(_budget),
+        usage(0),
+        hits(0),
+        misses(0),
+        evictions(0)
+  {
+  }
+
+  bool contains(Key const& key) const
+  {
+    boost::mutex::scoped_lock l(lock);
+    return lookup.find(key) != lookup.end();
+  }
+
+  // copies the entry to data and marks it as the most recently used, returns
+  // false and leaves data alone if the key isn't cached
+  bool get(Key const& key, Data& data)
+  {
+    boost::mutex::scoped_lock l(lock);
+    typename EntryMap::iterator it = lookup.find(key);
+    if (it == lookup.end()) {
+      ++misses;
+      return false;
+    }
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    data = it->second->data;
+    return true;
+  }
+
+  // replaces the entry if the key is cached already. An entry which costs
+  // more than the whole budget is not cached.
+  void insert(Key const& key, Data const& data)
+  {
+    const size_t size = sizeOf(data);
+    boost::mutex::scoped_lock l(lock);
+    typename EntryMap::iterator it = lookup.find(key);
+    if (it != lookup.end()) {
+      usage -= it->second->size;
+      entries.erase(it->second);
+      lookup.erase(it);
+    }
+    if (size > budget) {
+      return;
+    }
+    evict(budget - size);
+    entries.push_front(Entry(key, data, size));
+    lookup[key] = entries.begin();
+    usage += size;
+  }
+
+  void erase(Key const& key)
+  {
+    boost::mutex::scoped_lock l(lock);
+    typename EntryMap::iterator it = lookup.find(key);
+    if (it != lookup.end()) {
+      usage -= it->second->size;
+      entries.erase(it->second);
+      lookup.erase(it);
+    }
+  }
+
+  // evicts right away if the cache is over the new budget
+  void setBudget(size_t _budget)
+  {
+    boost::mutex::scoped_lock l(lock);
+    budget = _budget;
+    evict(budget);
+  }
+
+  Stats getStats() const
+  {
+    boost::mutex::scoped_lock l(lock);
+    Stats stats;
+    stats.entries = lookup.size();
+    stats.usage = usage;
+    stats.budget = budget;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    return stats;
+  }
+
+  // the counters are kept
+  void clear(void)
+  {
+    boost::mutex::scoped_lock l(lock);
+    lookup.clear();
+    entries.clear();
+    usage = 0;
+  }
+};
+
+#endif  // __COMMON_LRU_CACHE_H__
@@ -4,6 +4,12 @@
 #include "CommonProfiler.h"
 #include "CommonUtilities.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EXOCORTEX_USE_SSE
+#include <emmintrin.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
@@ -459,8 +465,8 @@ bool getIndexAndValues(Alembic::Abc::Int32ArraySamplePtr faceIndices,
     //   ESS_LOG_WARNING("valueSampler->size() != tempIndices.size()");
     //}
 
-    createIndexedArray<Imath::V2f, SortableV2f>(tempIndices, tempValues,
-                                                outputValues, outputIndices);
+    createIndexedArray<Imath::V2f>(tempIndices, tempValues, outputValues,
+                                   outputIndices);
     return true;
   }
   return false;
@@ -514,8 +520,8 @@ bool getIndexAndValues(Alembic::Abc::Int32ArraySamplePtr faceIndices,
     for (int i = 0; i < faceIndices->size(); i++) {
       tempIndices.push_back((*faceIndices)[i]);
     }
-    createIndexedArray<Imath::V3f, SortableV3f>(tempIndices, tempValues,
-                                                outputValues, outputIndices);
+    createIndexedArray<Imath::V3f>(tempIndices, tempValues, outputValues,
+                                   outputIndices);
     return true;
   }
   return false;
@@ -731,4 +737,64 @@ void dynamicTopoVelocityCalc::calcVelocities(
   faceIndicesVec = nextFaceIndicesVec;
   prevTime = time;
   bInitialized = true;
-}
\ No newline at end of file
+}
+
+void reverseFaceWinding(const AbcA::int32_t* faceCounts, size_t numFaces,
+                        const AbcA::int32_t* faceIndices,
+                        AbcA::uint32_t* reversedFaceIndices,
+                        AbcA::uint32_t* reversedOrder)
+{
+  size_t offset = 0;
+  for (size_t i = 0; i < numFaces; ++i) {
+    const size_t count = (size_t)faceCounts[i];
+    const size_t last = offset + count - 1;
+    for (size_t j = 0; j < count; ++j) {
+      reversedFaceIndices[offset + j] = (AbcA::uint32_t)faceIndices[last - j];
+      reversedOrder[offset + j] = (AbcA::uint32_t)(last - j);
+    }
+    offset += count;
+  }
+}
+
+void lerpPoints(Abc::V3f* dst, const Abc::V3f* a, const Abc::V3f* b,
+                size_t count, float alpha)
+{
+  const float ialpha = 1.0f - alpha;
+  float* fdst = &dst->x;
+  const float* fa = &a->x;
+  const float* fb = &b->x;
+  const size_t n = count * 3;
+  size_t i = 0;
+#ifdef EXOCORTEX_USE_SSE
+  const __m128 va = _mm_set1_ps(alpha);
+  const __m128 via = _mm_set1_ps(ialpha);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(fdst + i,
+                  _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(fa + i), via),
+                             _mm_mul_ps(_mm_loadu_ps(fb + i), va)));
+  }
+#endif
+  for (; i < n; ++i) {
+    fdst[i] = fa[i] * ialpha + fb[i] * alpha;
+  }
+}
+
+void extrapolatePoints(Abc::V3f* dst, const Abc::V3f* p, const Abc::V3f* v,
+                       size_t count, float alpha)
+{
+  float* fdst = &dst->x;
+  const float* fp = &p->x;
+  const float* fv = &v->x;
+  const size_t n = count * 3;
+  size_t i = 0;
+#ifdef EXOCORTEX_USE_SSE
+  const __m128 va = _mm_set1_ps(alpha);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(fdst + i, _mm_add_ps(_mm_loadu_ps(fp + i),
+                                       _mm_mul_ps(_mm_loadu_ps(fv + i), va)));
+  }
+#endif
+  for (; i < n; ++i) {
+    fdst[i] = fp[i] + fv[i] * alpha;
+  }
+}
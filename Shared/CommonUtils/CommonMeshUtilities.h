@@ -85,4 +85,23 @@ class dynamicTopoVelocityCalc {
                       std::vector<Abc::V3f>& velocities, double time);
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Flips the winding of every face. reversedFaceIndices receives the vertices
+// of each face in reverse order and reversedOrder the position in faceIndices
+// each of them was taken from. Both hold as many values as faceIndices.
+void reverseFaceWinding(const AbcA::int32_t* faceCounts, size_t numFaces,
+                        const AbcA::int32_t* faceIndices,
+                        AbcA::uint32_t* reversedFaceIndices,
+                        AbcA::uint32_t* reversedOrder);
+
+// dst = a * (1 - alpha) + b * alpha, the SSE2 path gives the same results as
+// the scalar one since both round after each operation
+void lerpPoints(Abc::V3f* dst, const Abc::V3f* a, const Abc::V3f* b,
+                size_t count, float alpha);
+
+// dst = p + v * alpha
+void extrapolatePoints(Abc::V3f* dst, const Abc::V3f* p, const Abc::V3f* v,
+                       size_t count, float alpha);
+
 #endif  // __MESH_UTILITIES_H
\ No newline at end of file
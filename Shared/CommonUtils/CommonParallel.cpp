@@ -0,0 +1,144 @@
+#include "CommonParallel.h"
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+
+namespace {
+
+// chunks per thread, so threads which start late still get a share
+enum { CHUNKS_PER_THREAD = 4 };
+
+// held by the call using the pool
+boost::mutex gSubmitLock;
+
+boost::mutex gLock;
+boost::condition_variable gWorkAvailable;
+boost::condition_variable gWorkDone;
+boost::thread_group* gWorkers = NULL;
+bool gStopping = false;
+
+// the loop being run, guarded by gLock
+ParallelRange* gBody = NULL;
+size_t gCount = 0;
+size_t gChunkSize = 0;
+size_t gNumChunks = 0;
+size_t gNextChunk = 0;
+size_t gPendingChunks = 0;
+
+int getNumWorkers()
+{
+  const int cores = (int)boost::thread::hardware_concurrency();
+  return std::max(0, std::min(cores - 1, 15));
+}
+
+// claims and runs the next chunk, expects lock to hold gLock
+void runChunk(boost::mutex::scoped_lock& lock)
+{
+  ParallelRange* body = gBody;
+  const size_t begin = gNextChunk * gChunkSize;
+  const size_t end = std::min(gCount, begin + gChunkSize);
+  ++gNextChunk;
+
+  lock.unlock();
+  body->run(begin, end);
+  lock.lock();
+
+  if (--gPendingChunks == 0) {
+    gWorkDone.notify_all();
+  }
+}
+
+void runWorker()
+{
+  boost::mutex::scoped_lock lock(gLock);
+  for (;;) {
+    while (!gStopping && (gBody == NULL || gNextChunk >= gNumChunks)) {
+      gWorkAvailable.wait(lock);
+    }
+    if (gStopping) {
+      return;
+    }
+    runChunk(lock);
+  }
+}
+
+// expects gLock to be held
+void startWorkers()
+{
+  if (gWorkers) {
+    return;
+  }
+  gWorkers = new boost::thread_group();
+  const int numWorkers = getNumWorkers();
+  for (int i = 0; i < numWorkers; ++i) {
+    gWorkers->create_thread(runWorker);
+  }
+}
+
+}  // namespace
+
+void parallelFor(size_t count, size_t grainSize, ParallelRange& body)
+{
+  if (count == 0) {
+    return;
+  }
+  const size_t numThreads = (size_t)getParallelThreadCount();
+  grainSize = std::max((size_t)1, grainSize);
+  if (numThreads == 1 || count <= grainSize) {
+    body.run(0, count);
+    return;
+  }
+
+  boost::mutex::scoped_try_lock submitLock(gSubmitLock);
+  if (!submitLock.owns_lock()) {
+    body.run(0, count);
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(gLock);
+  startWorkers();
+
+  const size_t maxChunks = numThreads * CHUNKS_PER_THREAD;
+  const size_t chunkSize =
+      std::max(grainSize, (count + maxChunks - 1) / maxChunks);
+  gBody = &body;
+  gCount = count;
+  gChunkSize = chunkSize;
+  gNumChunks = (count + chunkSize - 1) / chunkSize;
+  gNextChunk = 0;
+  gPendingChunks = gNumChunks;
+  gWorkAvailable.notify_all();
+
+  while (gNextChunk < gNumChunks) {
+    runChunk(lock);
+  }
+  while (gPendingChunks > 0) {
+    gWorkDone.wait(lock);
+  }
+  gBody = NULL;
+}
+
+int getParallelThreadCount() { return getNumWorkers() + 1; }
+
+void shutdownParallelPool()
+{
+  // lets a loop in progress finish
+  boost::mutex::scoped_lock submitLock(gSubmitLock);
+  boost::thread_group* workers = NULL;
+  {
+    boost::mutex::scoped_lock lock(gLock);
+    gStopping = true;
+    workers = gWorkers;
+    gWorkers = NULL;
+  }
+  gWorkAvailable.notify_all();
+  if (workers) {
+    workers->join_all();
+    delete workers;
+  }
+  boost::mutex::scoped_lock lock(gLock);
+  gStopping = false;
+}
@@ -0,0 +1,31 @@
+#ifndef __COMMON_PARALLEL_H__
+#define __COMMON_PARALLEL_H__
+
+#include <stddef.h>
+
+// a loop body for parallelFor, it must not throw
+class ParallelRange {
+ public:
+  virtual ~ParallelRange() {}
+  virtual void run(size_t begin, size_t end) = 0;
+};
+
+/**
+ * Splits [0, count) in chunks of at least grainSize items and runs them on a
+ * pool of worker threads and the calling thread, returns once they are all
+ * done. The pool is started on first use and kept for the next calls.
+ *
+ * One loop runs on the pool at a time. A call made while the pool is busy,
+ * from another node evaluated in parallel or from inside a body, runs its
+ * whole range on the calling thread instead of waiting.
+ */
+void parallelFor(size_t count, size_t grainSize, ParallelRange& body);
+
+// worker threads plus the calling thread
+int getParallelThreadCount();
+
+// waits for the worker threads to exit, they are started again when needed.
+// Call before the module is unloaded.
+void shutdownParallelPool();
+
+#endif  // __COMMON_PARALLEL_H__
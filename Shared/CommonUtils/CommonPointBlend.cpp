@@ -0,0 +1,75 @@
+#include "CommonPointBlend.h"
+#include "CommonAlembic.h"
+#include "CommonParallel.h"
+
+namespace {
+
+// smaller arrays are not worth waking the pool for
+enum { BLEND_GRAIN_SIZE = 16 * 1024 };
+
+// plain loop, it is bound by memory traffic and hand written SSE2 was no
+// faster
+void blendRange(double (*points)[4], size_t begin, size_t end,
+                const float* weights, float envelope, const Abc::V3f* floorPos,
+                const Abc::V3f* ceilPos, float alpha)
+{
+  for (size_t i = begin; i < end; ++i) {
+    const double w = (weights ? weights[i] : 1.0f) * envelope;
+    const double iw = 1.0 - w;
+
+    double tx = floorPos[i].x;
+    double ty = floorPos[i].y;
+    double tz = floorPos[i].z;
+    if (ceilPos) {
+      tx += (ceilPos[i].x - tx) * alpha;
+      ty += (ceilPos[i].y - ty) * alpha;
+      tz += (ceilPos[i].z - tz) * alpha;
+    }
+
+    double* p = points[i];
+    p[0] = p[0] * iw + tx * w;
+    p[1] = p[1] * iw + ty * w;
+    p[2] = p[2] * iw + tz * w;
+  }
+}
+
+class BlendPointsRange : public ParallelRange {
+ public:
+  BlendPointsRange(double (*points)[4], const float* weights, float envelope,
+                   const Abc::V3f* floorPos, const Abc::V3f* ceilPos,
+                   float alpha)
+      : m_points(points),
+        m_weights(weights),
+        m_envelope(envelope),
+        m_floor(floorPos),
+        m_ceil(ceilPos),
+        m_alpha(alpha)
+  {
+  }
+
+  virtual void run(size_t begin, size_t end)
+  {
+    blendRange(m_points, begin, end, m_weights, m_envelope, m_floor, m_ceil,
+               m_alpha);
+  }
+
+ private:
+  double (*m_points)[4];
+  const float* m_weights;
+  float m_envelope;
+  const Abc::V3f* m_floor;
+  const Abc::V3f* m_ceil;
+  float m_alpha;
+};
+
+}  // namespace
+
+void blendPoints(double (*points)[4], size_t count, const float* weights,
+                 float envelope, const Abc::V3f* floorPositions,
+                 const Abc::V3f* ceilPositions, float alpha)
+{
+  ESS_PROFILE_SCOPE("blendPoints");
+  BlendPointsRange body(points, weights, envelope, floorPositions,
+                        ceilPositions, alpha);
+  parallelFor(count, BLEND_GRAIN_SIZE, body);
+}
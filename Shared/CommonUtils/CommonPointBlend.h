@@ -0,0 +1,22 @@
+#ifndef __COMMON_POINT_BLEND_H__
+#define __COMMON_POINT_BLEND_H__
+
+#include "CommonAlembic.h"
+
+/**
+ * Moves points towards cached positions, the work of a point cache deformer:
+ *
+ *   target = floor + (ceil - floor) * alpha
+ *   point = point * (1 - weight) + target * weight
+ *
+ * with weight = weights[i] * envelope. points are x, y, z, w doubles, the
+ * layout of MPointArray::get, w is left alone. weights is NULL when all the
+ * weights are 1, ceilPositions is NULL when there is nothing to interpolate.
+ *
+ * Large arrays are split across the threads of parallelFor.
+ */
+void blendPoints(double (*points)[4], size_t count, const float* weights,
+                 float envelope, const Abc::V3f* floorPositions,
+                 const Abc::V3f* ceilPositions, float alpha);
+
+#endif  // __COMMON_POINT_BLEND_H__
@@ -0,0 +1,457 @@
+#include "CommonAlembic.h"
+
+#ifdef ESS_PROFILING
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+
+#ifdef _MSC_VER
+#include <process.h>
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// durations are bucketed in quarter powers of two, for percentiles
+enum { SUB_BUCKETS = 4, NUM_BUCKETS = 64 * SUB_BUCKETS };
+
+// while tracing, each thread keeps at most this many spans, the rest are
+// only counted
+enum { MAX_THREAD_EVENTS = 256 * 1024 };
+
+int bucketIndex(Profiling::nanoseconds ns)
+{
+  if (ns < SUB_BUCKETS) {
+    return (int)ns;
+  }
+  int exponent = 0;
+  for (Profiling::nanoseconds v = ns; v > 1; v >>= 1) {
+    ++exponent;
+  }
+  int sub = (int)(ns >> (exponent - 2)) & (SUB_BUCKETS - 1);
+  return exponent * SUB_BUCKETS + sub;
+}
+
+// the middle of the durations which land in bucket i
+double bucketValue(int i)
+{
+  if (i < SUB_BUCKETS) {
+    return i;
+  }
+  int exponent = i / SUB_BUCKETS;
+  int sub = i % SUB_BUCKETS;
+  double low = (double)(SUB_BUCKETS + sub) * (double)(1ULL << (exponent - 2));
+  double high = low + (double)(1ULL << (exponent - 2));
+  return (low + high) * 0.5;
+}
+
+struct ScopeStats {
+  ScopeStats() : count(0), total(0), min(0), max(0), last(0)
+  {
+    std::fill(buckets, buckets + NUM_BUCKETS, 0);
+  }
+
+  void add(Profiling::nanoseconds ns)
+  {
+    min = count == 0 ? ns : std::min(min, ns);
+    max = std::max(max, ns);
+    ++count;
+    total += ns;
+    last = ns;
+    ++buckets[bucketIndex(ns)];
+  }
+
+  void merge(const ScopeStats& other)
+  {
+    if (other.count == 0) {
+      return;
+    }
+    min = count == 0 ? other.min : std::min(min, other.min);
+    max = std::max(max, other.max);
+    count += other.count;
+    total += other.total;
+    last = other.last;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+      buckets[i] += other.buckets[i];
+    }
+  }
+
+  // in nanoseconds, clamped to what was actually measured
+  double percentile(double p) const
+  {
+    boost::uint64_t rank = (boost::uint64_t)(p * (count - 1)) + 1;
+    boost::uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return std::min((double)max, std::max((double)min, bucketValue(i)));
+      }
+    }
+    return (double)max;
+  }
+
+  boost::uint64_t count;
+  Profiling::nanoseconds total;
+  Profiling::nanoseconds min;
+  Profiling::nanoseconds max;
+  Profiling::nanoseconds last;
+  boost::uint32_t buckets[NUM_BUCKETS];
+};
+
+struct TraceEvent {
+  const char* name;
+  Profiling::nanoseconds start;
+  Profiling::nanoseconds end;
+};
+
+typedef std::map<const char*, ScopeStats> StatsMap;
+
+// what one thread recorded, only the report, the export and the trace switch
+// look at it from another thread, so the lock is practically never contended
+struct ThreadRecord {
+  ThreadRecord(int id, bool trace)
+      : threadId(id), traceEnabled(trace), droppedEvents(0)
+  {
+  }
+
+  boost::mutex lock;
+  int threadId;
+  bool traceEnabled;
+  StatsMap stats;
+  std::vector<TraceEvent> events;
+  size_t droppedEvents;
+};
+
+bool traceEnabledByEnvironment()
+{
+  const char* value = getenv("EXOCORTEX_ALEMBIC_PROFILE_TRACE");
+  return value != NULL && atoi(value) != 0;
+}
+
+void mergeStats(StatsMap& dst, const StatsMap& src)
+{
+  for (StatsMap::const_iterator it = src.begin(); it != src.end(); ++it) {
+    dst[it->first].merge(it->second);
+  }
+}
+
+// the records of the running threads, the stats of the threads which exited
+// since the last report, and the records of the ones which left spans behind
+// for the next export. All under gRecordsLock
+boost::mutex gRecordsLock;
+std::vector<ThreadRecord*> gRecords;
+StatsMap gExitedStats;
+std::vector<ThreadRecord*> gExitedRecords;
+int gNextThreadId = 1;
+bool gTraceEnabled = traceEnabledByEnvironment();
+
+// called when a thread exits, its stats are kept and the record is freed
+// unless it holds spans which were not exported yet
+void releaseRecord(ThreadRecord* record)
+{
+  boost::mutex::scoped_lock recordsLock(gRecordsLock);
+  gRecords.erase(std::find(gRecords.begin(), gRecords.end(), record));
+  mergeStats(gExitedStats, record->stats);
+  record->stats.clear();
+  if (record->events.empty() && record->droppedEvents == 0) {
+    delete record;
+  }
+  else {
+    gExitedRecords.push_back(record);
+  }
+}
+
+boost::thread_specific_ptr<ThreadRecord> gThreadRecord(releaseRecord);
+
+boost::mutex gNamesLock;
+std::set<std::string> gNames;
+
+const Profiling::nanoseconds gEpoch = Profiling::now();
+
+ThreadRecord& getThreadRecord()
+{
+  ThreadRecord* record = gThreadRecord.get();
+  if (!record) {
+    boost::mutex::scoped_lock lock(gRecordsLock);
+    record = new ThreadRecord(gNextThreadId++, gTraceEnabled);
+    gRecords.push_back(record);
+    gThreadRecord.reset(record);
+  }
+  return *record;
+}
+
+void addEvent(ThreadRecord& record, const char* name,
+              Profiling::nanoseconds start, Profiling::nanoseconds end)
+{
+  if (!record.traceEnabled) {
+    return;
+  }
+  if (record.events.size() < MAX_THREAD_EVENTS) {
+    TraceEvent event = {name, start, end};
+    record.events.push_back(event);
+  }
+  else {
+    ++record.droppedEvents;
+  }
+}
+
+std::string escapeJson(const char* s)
+{
+  std::string escaped;
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') {
+      escaped += '\\';
+      escaped += *s;
+    }
+    else if ((unsigned char)*s < 0x20) {
+      escaped += ' ';
+    }
+    else {
+      escaped += *s;
+    }
+  }
+  return escaped;
+}
+
+int getProcessId()
+{
+#ifdef _MSC_VER
+  return _getpid();
+#else
+  return (int)getpid();
+#endif
+}
+
+struct ReportRecord {
+  std::string name;
+  ScopeStats stats;
+};
+
+bool reportSortFunction(const ReportRecord* r1, const ReportRecord* r2)
+{
+  return r1->stats.total > r2->stats.total;
+}
+
+}  // namespace
+
+namespace Profiling {
+
+nanoseconds now()
+{
+#ifdef _MSC_VER
+  static LARGE_INTEGER frequency = {0};
+  if (frequency.QuadPart == 0) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  // split up so the multiplication doesn't overflow
+  const boost::uint64_t ticks = counter.QuadPart;
+  const boost::uint64_t freq = frequency.QuadPart;
+  return (ticks / freq) * 1000000000ULL +
+         ((ticks % freq) * 1000000000ULL) / freq;
+#elif defined(__APPLE__)
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return (nanoseconds)tv.tv_sec * 1000000000ULL +
+         (nanoseconds)tv.tv_usec * 1000ULL;
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (nanoseconds)ts.tv_sec * 1000000000ULL + (nanoseconds)ts.tv_nsec;
+#endif
+}
+
+void recordScope(const char* name, nanoseconds start, nanoseconds end)
+{
+  ThreadRecord& record = getThreadRecord();
+  boost::mutex::scoped_lock lock(record.lock);
+  record.stats[name].add(end - start);
+  addEvent(record, name, start, end);
+}
+
+void recordEvent(const char* name, nanoseconds start, nanoseconds end)
+{
+  ThreadRecord& record = getThreadRecord();
+  boost::mutex::scoped_lock lock(record.lock);
+  addEvent(record, name, start, end);
+}
+
+void recordStats(const char* name, nanoseconds elapsed)
+{
+  ThreadRecord& record = getThreadRecord();
+  boost::mutex::scoped_lock lock(record.lock);
+  record.stats[name].add(elapsed);
+}
+
+const char* internName(const std::string& name)
+{
+  boost::mutex::scoped_lock lock(gNamesLock);
+  return gNames.insert(name).first->c_str();
+}
+
+void generateReport()
+{
+  // the same name can have a different address in each module
+  std::map<std::string, ReportRecord> merged;
+  {
+    boost::mutex::scoped_lock recordsLock(gRecordsLock);
+    StatsMap stats;
+    stats.swap(gExitedStats);
+    for (size_t i = 0; i < gRecords.size(); ++i) {
+      boost::mutex::scoped_lock lock(gRecords[i]->lock);
+      mergeStats(stats, gRecords[i]->stats);
+      gRecords[i]->stats.clear();
+    }
+    for (StatsMap::iterator it = stats.begin(); it != stats.end(); ++it) {
+      ReportRecord& rec = merged[it->first];
+      rec.name = it->first;
+      rec.stats.merge(it->second);
+    }
+  }
+
+  std::vector<const ReportRecord*> records;
+  records.reserve(merged.size());
+  for (std::map<std::string, ReportRecord>::iterator it = merged.begin();
+       it != merged.end(); ++it) {
+    records.push_back(&it->second);
+  }
+  std::sort(records.begin(), records.end(), reportSortFunction);
+
+  ESS_LOG_WARNING(
+      "PROFILER REPORT "
+      ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>"
+      ">>>>>>>>>>>>>>>>");
+  ESS_LOG_WARNING("profile name, total elapsed, entry count, average, min, "
+                  "p50, p90, p99, max, last (seconds)");
+
+  const double toSeconds = 1.0e-9;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const ScopeStats& s = records[i]->stats;
+    std::stringstream line;
+    line << std::setprecision(6) << records[i]->name << ", "
+         << s.total * toSeconds << ", " << s.count << ", "
+         << (double)s.total / s.count * toSeconds << ", " << s.min * toSeconds
+         << ", " << s.percentile(0.5) * toSeconds << ", "
+         << s.percentile(0.9) * toSeconds << ", "
+         << s.percentile(0.99) * toSeconds << ", " << s.max * toSeconds
+         << ", " << s.last * toSeconds;
+    ESS_LOG_WARNING(line.str().c_str());
+  }
+
+  ESS_LOG_WARNING(
+      "PROFILER REPORT "
+      "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<"
+      "<<<<<<<<<<<<<<<<");
+}
+
+bool exportTrace(const std::string& fileName)
+{
+  std::ofstream file(fileName.c_str());
+  if (!file) {
+    ESS_LOG_ERROR("Could not write the profiler trace to " << fileName);
+    return false;
+  }
+
+  const int pid = getProcessId();
+  size_t droppedEvents = 0;
+  bool first = true;
+
+  // times are in microseconds
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  // swapped out so the threads can carry on, and start or exit, while this
+  // is written
+  std::vector<std::pair<int, std::vector<TraceEvent> > > records;
+  bool traceEnabled = false;
+  {
+    boost::mutex::scoped_lock recordsLock(gRecordsLock);
+    traceEnabled = gTraceEnabled;
+    std::vector<ThreadRecord*> all = gExitedRecords;
+    all.insert(all.end(), gRecords.begin(), gRecords.end());
+    records.resize(all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+      boost::mutex::scoped_lock lock(all[i]->lock);
+      records[i].first = all[i]->threadId;
+      records[i].second.swap(all[i]->events);
+      droppedEvents += all[i]->droppedEvents;
+      all[i]->droppedEvents = 0;
+    }
+    for (size_t i = 0; i < gExitedRecords.size(); ++i) {
+      delete gExitedRecords[i];
+    }
+    gExitedRecords.clear();
+  }
+
+  for (size_t i = 0; i < records.size(); ++i) {
+    const std::vector<TraceEvent>& events = records[i].second;
+
+    for (size_t j = 0; j < events.size(); ++j) {
+      const TraceEvent& e = events[j];
+      file << (first ? "\n" : ",\n") << "{\"name\":\""
+           << escapeJson(e.name) << "\",\"ph\":\"X\",\"pid\":" << pid
+           << ",\"tid\":" << records[i].first
+           << ",\"ts\":" << (e.start - gEpoch) * 1.0e-3
+           << ",\"dur\":" << (e.end - e.start) * 1.0e-3 << "}";
+      first = false;
+    }
+  }
+  file << "\n]}\n";
+
+  if (!traceEnabled) {
+    ESS_LOG_WARNING("The profiler is not recording a trace, set "
+                    "EXOCORTEX_ALEMBIC_PROFILE_TRACE=1 to record one.");
+  }
+  if (droppedEvents > 0) {
+    ESS_LOG_WARNING("The profiler trace is missing "
+                    << droppedEvents << " spans, threads keep at most "
+                    << MAX_THREAD_EVENTS << " between exports.");
+  }
+  return file.good();
+}
+
+void setTraceEnabled(bool enabled)
+{
+  boost::mutex::scoped_lock recordsLock(gRecordsLock);
+  gTraceEnabled = enabled;
+  for (size_t i = 0; i < gRecords.size(); ++i) {
+    boost::mutex::scoped_lock lock(gRecords[i]->lock);
+    gRecords[i]->traceEnabled = enabled;
+  }
+}
+
+bool isTraceEnabled()
+{
+  boost::mutex::scoped_lock recordsLock(gRecordsLock);
+  return gTraceEnabled;
+}
+
+void reset()
+{
+  boost::mutex::scoped_lock recordsLock(gRecordsLock);
+  gExitedStats.clear();
+  for (size_t i = 0; i < gExitedRecords.size(); ++i) {
+    delete gExitedRecords[i];
+  }
+  gExitedRecords.clear();
+  for (size_t i = 0; i < gRecords.size(); ++i) {
+    boost::mutex::scoped_lock lock(gRecords[i]->lock);
+    gRecords[i]->stats.clear();
+    gRecords[i]->events.clear();
+    gRecords[i]->droppedEvents = 0;
+  }
+}
+
+}  // namespace Profiling
+
+#endif  // ESS_PROFILING
@@ -5,181 +5,89 @@
 #error "Must include CommonAlembic.h before CommonProfiler.h"
 #endif
 
-#ifdef _MSC_VER
-
-#include <windows.h>
-#include <algorithm>
-
-class HighResolutionTimer {
- public:
-  // ctor
-  HighResolutionTimer()
-  {
-    start_time.QuadPart = 0;
-    frequency.QuadPart = 0;
-
-    if (!QueryPerformanceFrequency(&frequency))
-      throw std::runtime_error("Couldn't acquire frequency");
-
-    restart();
-  }
-
-  // restart timer
-  void restart()
-  {
-    if (!QueryPerformanceCounter(&start_time))
-      throw std::runtime_error("Couldn't initialize start_time");
-  }
-
-  // return elapsed time in seconds
-  double elapsed() const
-  {
-    LARGE_INTEGER now;
-    if (!QueryPerformanceCounter(&now))
-      throw std::runtime_error("Couldn't get current time");
+#include <boost/cstdint.hpp>
 
-    // QueryPerformanceCounter() workaround
-    // http://support.microsoft.com/default.aspx?scid=kb;EN-US;q274323
-    double d1 = double(now.QuadPart - start_time.QuadPart) / frequency.QuadPart;
-    return d1;
-  }
+#ifndef PROFILING_OFF
+#define ESS_PROFILING
+#endif
 
-  // return estimated maximum value for elapsed()
-  double elapsed_max() const
-  {
-    return (double((std::numeric_limits<LONGLONG>::max)()) -
-            double(start_time.QuadPart)) /
-           double(frequency.QuadPart);
-  }
+#ifdef ESS_PROFILING
 
-  // return minimum value for elapsed()
-  double elapsed_min() const { return 1.0 / frequency.QuadPart; }
+/**
+ * Scopes are timed with the monotonic clock (QueryPerformanceCounter on
+ * Windows, clock_gettime elsewhere) and recorded into a buffer owned by the
+ * timing thread, so threads never wait on each other. The buffers are merged
+ * when a report or trace is asked for, the buffer of a thread is freed when
+ * it exits.
+ *
+ * Only the stats are kept by default. The spans for the trace are recorded
+ * once setTraceEnabled(true) is called, or from the start if the
+ * EXOCORTEX_ALEMBIC_PROFILE_TRACE environment variable is 1.
+ *
+ * Scope names are not copied: the pointer is the key, and names are only
+ * compared when merging. Hence ESS_PROFILE_SCOPE only takes string literals.
+ */
+namespace Profiling {
+typedef boost::uint64_t nanoseconds;
+
+// monotonic time in nanoseconds
+nanoseconds now();
+
+// records one timed span, name has to live as long as the process
+void recordScope(const char* name, nanoseconds start, nanoseconds end);
+
+// only adds the span to the trace, if it is recorded, or only updates the
+// stats
+void recordEvent(const char* name, nanoseconds start, nanoseconds end);
+void recordStats(const char* name, nanoseconds elapsed);
+
+// returns a copy of name which stays valid for the lifetime of the process
+const char* internName(const std::string& name);
+
+// logs count, total, average, min, percentiles and max for every scope,
+// sorted by total time, then clears the stats
+void generateReport();
+
+// starts or stops recording the spans for the trace
+void setTraceEnabled(bool enabled);
+bool isTraceEnabled();
+
+// writes every span recorded since the last export in the Chrome trace
+// event format (chrome://tracing, Perfetto), then clears them
+bool exportTrace(const std::string& fileName);
+
+// clears the stats and the trace
+void reset();
+}
+
+// times its own lifetime
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char* s) : name(s), start(Profiling::now()) {}
+  ~ProfileScope() { Profiling::recordScope(name, start, Profiling::now()); }
  private:
-  LARGE_INTEGER start_time;
-  LARGE_INTEGER frequency;
-};
-
-struct empty_logging_policy {
-  static void on_start(std::string){};
-  static void on_resume(std::string){};
-  static void on_pause(std::string, double){};
-  static void on_stop(std::string, double, bool, bool){};
-};
-
-struct default_logging_policy {
-  static void on_start(std::string name)
-  {
-    // cerr << "starting profile " << name << endl;
-  }
-  static void on_resume(std::string name)
-  {
-    //   cerr << "resuming profile " << name << endl;
-  }
-  static void on_pause(std::string name)
-  {
-    //   cerr << "pausing profile " << name << endl;
-  }
-  static void on_stop(std::string name, double sec, bool underflow,
-                      bool overflow)
-  {
-    //   cerr << "stopping profile " << name;
-    //   cerr << " time elapsed = " << sec;
-    //    if (underflow) cerr << " underflow occurred";
-    //    if (overflow) cerr << " overflow occurred";
-    //    cerr << endl;
-  }
-};
-
-struct counted_sum : std::pair<int, double> {
-  counted_sum() : std::pair<int, double>(0, 0) {}
-  counted_sum(int x, double y) : std::pair<int, double>(x, y) {}
-  double last;
-
-  void operator+=(double x)
-  {
-    first++;
-    second += x;
-    last = x;
-  }
-};
-
-typedef std::map<std::string, counted_sum> stats_map;
-
-struct empty_stats_policy {
-  static void on_stop(std::string name, double sec, bool underflow,
-                      bool overflow)
-  {
-  }
-  static void on_report() {}
-};
-
-struct default_stats_policy {
-  static stats_map stats;
-
-  static void on_stop(std::string name, double sec, bool underflow,
-                      bool overflow)
-  {
-    // underflow and overflow are sticky.
-    if (underflow) {
-      stats[name] = counted_sum(-1, -1);
-    }
-    else if (overflow) {
-      stats[name] = counted_sum(-2, -2);
-    }
-    else {
-      stats[name] += sec;
-    }
-  }
-  static void on_report()
-  {
-    ESS_LOG_WARNING(
-        "PROFILER REPORT "
-        ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>"
-        ">>>>>>>>>>>>>>>>");
-    ESS_LOG_WARNING("profile name," << '\t' << "total elapsed," << '\t'
-                                    << "entry count," << '\t' << "average");
-
-    for (stats_map::iterator i = stats.begin(); i != stats.end(); i++) {
-      std::string sName = i->first;
-      int nCount = i->second.first;
-      double dTotal = i->second.second;
-      double dAvg = dTotal / nCount;
-      ESS_LOG_WARNING(sName << ",\t" << dTotal << ",\t" << nCount << ",\t"
-                            << dAvg);
-    }
-
-    ESS_LOG_WARNING(
-        "PROFILER REPORT "
-        "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<"
-        "<<<<<<<<<<<<<<<<");
-  }
+  const char* name;
+  Profiling::nanoseconds start;
 };
 
-#ifndef PROFILING_OFF
-template <typename logging_policy, typename stats_policy, typename timer_type>
-class BasicProfiler {
+// a timer which can be paused, resumed and stopped by hand, the total time
+// is added to the stats when it stops and each timed span to the trace
+class Profiler {
  private:
-  bool underflow;
-  bool overflow;
   bool timing;
-  std::string name;
-  double elapsed;
-  timer_type t;
+  const char* name;
+  Profiling::nanoseconds elapsed;
+  Profiling::nanoseconds start;
 
  public:
-  BasicProfiler(char const* s = "", bool autoStart = true)
-      : underflow(false),
-        overflow(false),
-        timing(autoStart),
-        name(s),
-        elapsed(0.0)
+  Profiler(char const* s = "", bool autoStart = true)
+      : timing(autoStart),
+        name(Profiling::internName(s)),
+        elapsed(0),
+        start(Profiling::now())
   {
-    logging_policy::on_start(name);
-    if (autoStart) {
-      t.restart();
-    }
   }
-  ~BasicProfiler()
+  ~Profiler()
   {
     if (timing) {
       stop();
@@ -189,168 +97,65 @@ class BasicProfiler {
   void stop()
   {
     if (timing) {
-      double tmp = t.elapsed();
-      if (tmp <= t.elapsed_min()) {
-        underflow = true;
-      }
-      if (tmp >= t.elapsed_max()) {
-        overflow = true;
-      }
-      tmp += elapsed;
-      elapsed = 0.0;
-      timing = false;
-      logging_policy::on_stop(name, tmp, underflow, overflow);
-      stats_policy::on_stop(name, tmp, underflow, overflow);
+      pause();
     }
+    else if (elapsed == 0) {
+      return;
+    }
+    Profiling::recordStats(name, elapsed);
+    elapsed = 0;
   }
   void restart()
   {
     timing = true;
-    elapsed = 0.0;
-    // logging_policy::on_restart(name);
-    t.restart();
+    elapsed = 0;
+    start = Profiling::now();
   }
   void resume()
   {
-    timing = true;
-    // logging_policy::on_resume(name);
-    t.restart();
-  }
-  void pause()
-  {
-    double tmp = t.elapsed();
-    if (tmp <= t.elapsed_min()) {
-      underflow = true;
-    }
-    if (tmp >= t.elapsed_max()) {
-      overflow = true;
+    if (!timing) {
+      timing = true;
+      start = Profiling::now();
     }
-    elapsed += tmp;
-    timing = false;
-    logging_policy::on_pause(name);
-    t.pause();
   }
-  static void generate_report() { stats_policy::on_report(); }
-};
-#else
-template <typename logging_policy, typename stats_policy, typename timer_t>
-class BasicProfiler {
- public:
-  BasicProfiler(char const* s = "") {}
-  void stop() {}
-  void restart() {}
-  void resume() {}
-  void pause() {}
-  static void generate_report() {}
-};
-#endif
-
-struct sortableStatRecord {
-  std::string sName;
-  int nCount;
-  double dTotal;
-  double dAvg;
-  double last;
-};
-
-class logging_stats_policy {
- public:
-  stats_map stats;
-
-  static void on_stop(std::string name, double sec, bool underflow,
-                      bool overflow)
-  {
-    // underflow and overflow are sticky.
-    if (underflow) {
-      default_stats_policy::stats[name] = counted_sum(-1, -1);
-    }
-    else if (overflow) {
-      default_stats_policy::stats[name] = counted_sum(-2, -2);
-    }
-    else {
-      // Intel Parallel Studio says that the following line causes a memory leak
-      default_stats_policy::stats[name] += sec;
-    }
-  }
-  static void on_report() { generateReport(); }
-  static bool statSortFunction(const sortableStatRecord& r1,
-                               const sortableStatRecord& r2)
-  {
-    return r1.dTotal > r2.dTotal;
-  }
-
-  static void generateReport()
+  void pause()
   {
-    int padding = 14;
-    ESS_LOG_WARNING(
-        "PROFILER REPORT "
-        ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>"
-        ">>>>>>>>>>>>>>>>");
-    std::stringstream strstream;
-    strstream << std::setw(padding + 6) << std::setiosflags(std::ios::left)
-              << "profile name," << std::setw(padding)
-              << std::setiosflags(std::ios::right) << "average,"
-              << std::setw(padding) << "last," << std::setw(padding)
-              << "total elapsed," << std::setw(padding) << "entry count"
-              << std::setw(padding);
-
-    ESS_LOG_WARNING(strstream.str().c_str());
-
-    std::vector<sortableStatRecord> records;
-    records.reserve(default_stats_policy::stats.size());
-
-    for (stats_map::iterator i = default_stats_policy::stats.begin();
-         i != default_stats_policy::stats.end(); i++) {
-      sortableStatRecord rec;
-      rec.sName = i->first;
-      rec.nCount = i->second.first;
-      rec.dTotal = i->second.second;
-      rec.dAvg = rec.dTotal / rec.nCount;
-      rec.last = i->second.last;
-
-      records.push_back(rec);
-    }
-
-    std::sort(records.begin(), records.end(), statSortFunction);
-
-    for (int i = 0; i < records.size(); i++) {
-      std::stringstream strstream2;
-      strstream2 << std::setw(padding + 6) << std::setiosflags(std::ios::left)
-                 << records[i].sName << "," << std::setw(50)
-                 << std::setiosflags(std::ios::right) << records[i].dAvg << ","
-                 << std::setw(padding) << records[i].last << ","
-                 << std::setw(padding) << records[i].dTotal << ","
-                 << std::setw(padding) << records[i].nCount
-                 << std::setw(padding);
-
-      ESS_LOG_WARNING(strstream2.str().c_str());
+    if (timing) {
+      Profiling::nanoseconds end = Profiling::now();
+      Profiling::recordEvent(name, start, end);
+      elapsed += end - start;
+      timing = false;
     }
-    ESS_LOG_WARNING(
-        "PROFILER REPORT "
-        "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<"
-        "<<<<<<<<<<<<<<<<");
-    default_stats_policy::stats.clear();
   }
+  static void generate_report() { Profiling::generateReport(); }
 };
 
-typedef BasicProfiler<empty_logging_policy,  // don't log events
-                      logging_stats_policy, HighResolutionTimer>
-    Profiler;
-
-#define ESS_PROFILING
+#define ESS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ESS_PROFILE_CONCAT(a, b) ESS_PROFILE_CONCAT_IMPL(a, b)
 
-#endif  // _MSC_VER
+// "" a only compiles for string literals, which live as long as the process
+#define ESS_PROFILE_SCOPE(a) \
+  ProfileScope ESS_PROFILE_CONCAT(essProfileScope, __LINE__)("" a);
+#define ESS_PROFILE_FUNC() \
+  ProfileScope ESS_PROFILE_CONCAT(essProfileScope, __LINE__)(__FUNCTION__);
+#define ESS_PROFILE_REPORT() Profiling::generateReport();
+#define ESS_PROFILE_EXPORT_TRACE(a) Profiling::exportTrace(a);
 
-#ifdef ESS_PROFILING
+#ifdef _MSC_VER
 #pragma message("EXOCORTEX: ESS_PROFILING defined, profiling enabled.")
-#define ESS_PROFILE_SCOPE(a) Profiler profiler(a);
-#define ESS_PROFILE_REPORT() logging_stats_policy::generateReport();
+#endif
+
 #else
-#pragma message("EXOCORTEX: ESS_PROFILING not defined, profiling disabled.")
+
 #define ESS_PROFILE_SCOPE(a)
+#define ESS_PROFILE_FUNC()
 #define ESS_PROFILE_REPORT()
+#define ESS_PROFILE_EXPORT_TRACE(a)
+
+#ifdef _MSC_VER
+#pragma message("EXOCORTEX: ESS_PROFILING not defined, profiling disabled.")
 #endif
 
-#define ESS_PROFILE_FUNC() ESS_PROFILE_SCOPE(__FUNCTION__)
+#endif  // ESS_PROFILING
 
-#endif  // __COMMON_PROFILER_H
\ No newline at end of file
+#endif  // __COMMON_PROFILER_H
@@ -0,0 +1,228 @@
+#include "CommonSamplePrefetcher.h"
+#include "CommonAlembic.h"
+#include "CommonUtilities.h"
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace {
+
+typedef Alembic::AbcCoreAbstract::index_t index_t;
+typedef std::pair<const P3fArraySampleCache*, std::string> StreamKey;
+
+struct Stream {
+  Stream() : lastIndex(0), step(1), generation(0) {}
+
+  boost::shared_ptr<P3fArraySampleCache> cache;
+  Abc::IP3fArrayProperty positions;
+  index_t lastIndex;
+  index_t step;
+  unsigned int generation;
+};
+
+struct Job {
+  StreamKey stream;
+  unsigned int generation;
+  index_t index;
+};
+
+boost::mutex gLock;
+boost::condition_variable gJobsChanged;
+std::map<StreamKey, Stream> gStreams;
+std::deque<Job> gJobs;
+boost::thread_group* gWorkers = NULL;
+bool gStopping = false;
+
+int getMaxPrefetchSamples()
+{
+  static int maxSamples = -1;
+  if (maxSamples < 0) {
+    const char* value = getenv("EXOCORTEX_ALEMBIC_PREFETCH_SAMPLES");
+    maxSamples = value != NULL ? std::max(0, atoi(value)) : 8;
+  }
+  return maxSamples;
+}
+
+// expects gLock to be held
+void dropJobs(const StreamKey& stream)
+{
+  std::deque<Job> kept;
+  for (size_t i = 0; i < gJobs.size(); ++i) {
+    if (gJobs[i].stream != stream) {
+      kept.push_back(gJobs[i]);
+    }
+  }
+  gJobs.swap(kept);
+}
+
+// expects gLock to be held
+size_t countStreams(const P3fArraySampleCache* cache)
+{
+  size_t count = 0;
+  for (std::map<StreamKey, Stream>::iterator it = gStreams.begin();
+       it != gStreams.end(); ++it) {
+    if (it->first.first == cache) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void runWorker()
+{
+  for (;;) {
+    boost::shared_ptr<P3fArraySampleCache> cache;
+    Abc::IP3fArrayProperty positions;
+    SampleCacheKey key;
+    {
+      boost::mutex::scoped_lock lock(gLock);
+      while (gJobs.empty() && !gStopping) {
+        gJobsChanged.wait(lock);
+      }
+      if (gStopping) {
+        return;
+      }
+      Job job = gJobs.front();
+      gJobs.pop_front();
+
+      std::map<StreamKey, Stream>::iterator it = gStreams.find(job.stream);
+      if (it == gStreams.end() || it->second.generation != job.generation) {
+        continue;
+      }
+      cache = it->second.cache;
+      positions = it->second.positions;
+      key = SampleCacheKey(job.stream.second, job.index);
+    }
+
+    if (cache->contains(key)) {
+      continue;
+    }
+    ESS_PROFILE_SCOPE("SamplePrefetcher read positions");
+    try {
+      Abc::P3fArraySamplePtr sample;
+      positions.get(sample, Abc::ISampleSelector(key.second));
+      cache->insert(key, sample);
+    }
+    catch (std::exception& e) {
+      ESS_LOG_WARNING("Could not prefetch sample "
+                      << key.second << " of " << key.first << ": "
+                      << e.what());
+    }
+  }
+}
+
+// expects gLock to be held
+void startWorkers()
+{
+  if (gWorkers) {
+    return;
+  }
+  const int cores = (int)boost::thread::hardware_concurrency();
+  const int numWorkers = std::max(1, std::min(cores - 1, 4));
+  gWorkers = new boost::thread_group();
+  for (int i = 0; i < numWorkers; ++i) {
+    gWorkers->create_thread(runWorker);
+  }
+}
+
+}  // namespace
+
+namespace SamplePrefetcher {
+
+void prefetchPositions(boost::shared_ptr<P3fArraySampleCache> const& cache,
+                       std::string const& fullName,
+                       Abc::IP3fArrayProperty const& positions,
+                       Alembic::AbcCoreAbstract::index_t index,
+                       size_t sampleBytes)
+{
+  ESS_PROFILE_SCOPE("SamplePrefetcher::prefetchPositions");
+  const int maxSamples = getMaxPrefetchSamples();
+  if (!cache || maxSamples == 0 || sampleBytes == 0) {
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(gLock);
+  if (gStopping) {
+    return;
+  }
+  const StreamKey key(cache.get(), fullName);
+  std::map<StreamKey, Stream>::iterator it = gStreams.find(key);
+  if (it == gStreams.end()) {
+    it = gStreams.insert(std::make_pair(key, Stream())).first;
+    it->second.cache = cache;
+    it->second.positions = positions;
+  }
+  else {
+    const index_t delta = index - it->second.lastIndex;
+    if (delta == 0) {
+      // same sample, what was queued for it still applies
+      return;
+    }
+    if (delta >= -maxSamples && delta <= maxSamples) {
+      it->second.step = delta;
+    }
+  }
+  Stream& stream = it->second;
+  stream.lastIndex = index;
+  stream.generation++;
+  dropJobs(key);
+
+  const size_t budget = cache->getStats().budget / 2 /
+                        std::max((size_t)1, countStreams(cache.get()));
+  const index_t count =
+      (index_t)std::min((size_t)maxSamples, budget / sampleBytes);
+  const index_t numSamples = (index_t)positions.getNumSamples();
+  for (index_t i = 1; i <= count; ++i) {
+    const index_t next = index + stream.step * i;
+    if (next < 0 || next >= numSamples) {
+      break;
+    }
+    if (cache->contains(SampleCacheKey(fullName, next))) {
+      continue;
+    }
+    Job job = {key, stream.generation, next};
+    gJobs.push_back(job);
+  }
+
+  if (!gJobs.empty()) {
+    startWorkers();
+    gJobsChanged.notify_all();
+  }
+}
+
+void cancel(P3fArraySampleCache const* cache, std::string const& fullName)
+{
+  boost::mutex::scoped_lock lock(gLock);
+  const StreamKey key(cache, fullName);
+  gStreams.erase(key);
+  dropJobs(key);
+}
+
+void cancelAll()
+{
+  boost::mutex::scoped_lock lock(gLock);
+  gStreams.clear();
+  gJobs.clear();
+}
+
+void shutdown()
+{
+  boost::thread_group* workers = NULL;
+  {
+    boost::mutex::scoped_lock lock(gLock);
+    gStreams.clear();
+    gJobs.clear();
+    gStopping = true;
+    workers = gWorkers;
+    gWorkers = NULL;
+  }
+  gJobsChanged.notify_all();
+  if (workers) {
+    workers->join_all();
+    delete workers;
+  }
+  boost::mutex::scoped_lock lock(gLock);
+  gStopping = false;
+}
+
+}  // namespace SamplePrefetcher
@@ -0,0 +1,43 @@
+#ifndef __COMMON_SAMPLE_PREFETCHER_H__
+#define __COMMON_SAMPLE_PREFETCHER_H__
+
+#include "CommonAlembic.h"
+#include "CommonUtilities.h"
+
+/**
+ * Reads position samples ahead of playback on worker threads, into the
+ * sample cache of the archive, so a node evaluating the next frame finds its
+ * samples in memory.
+ *
+ * A stream is the positions of one object read through one cache. Each time
+ * a node reads a sample, the step from the previous one gives the direction
+ * and speed of playback, and the next samples along that step are queued.
+ * Jumps further than the prefetch distance are taken as scrubbing and keep
+ * the previous step. Queued reads of a stream are dropped when it moves on.
+ *
+ * At most EXOCORTEX_ALEMBIC_PREFETCH_SAMPLES samples (8 by default, 0 turns
+ * prefetching off) are read ahead per stream, and the streams sharing a cache
+ * never prefetch more than half of its budget.
+ *
+ * Only use it with archives which can be read from several threads (Ogawa).
+ */
+namespace SamplePrefetcher {
+
+// call with the sample a node is about to read, sampleBytes is the size of
+// one sample
+void prefetchPositions(boost::shared_ptr<P3fArraySampleCache> const& cache,
+                       std::string const& fullName,
+                       Abc::IP3fArrayProperty const& positions,
+                       Alembic::AbcCoreAbstract::index_t index,
+                       size_t sampleBytes);
+
+// drops the stream and its queued reads, a read in progress still finishes
+void cancel(P3fArraySampleCache const* cache, std::string const& fullName);
+void cancelAll();
+
+// cancels everything and waits for the worker threads to exit, they are
+// started again when needed. Call before the module is unloaded.
+void shutdown();
+}
+
+#endif  // __COMMON_SAMPLE_PREFETCHER_H__
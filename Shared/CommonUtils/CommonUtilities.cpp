@@ -1,28 +1,61 @@
 #include "CommonUtilities.h"
 #include "CommonAbcCache.h"
+#include "CommonAbcCacheIndex.h"
 #include "CommonAlembic.h"
 #include "CommonLicensing.h"
 #include "CommonRegex.h"
 
-#ifdef ESS_PROFILING
-stats_map default_stats_policy::stats;
-#endif  // ESS_PROFILER
+#include <boost/thread/thread.hpp>
 
 #include "CommonPBar.h"
 
 struct AlembicArchiveInfo {
   Alembic::Abc::IArchive* archive;
   int refCount;
+  bool isOgawa;
 
-  AlembicArchiveInfo()
+  AlembicArchiveInfo() : archiveCache(new AbcArchiveCache())
   {
     archive = NULL;
     refCount = 0;
+    isOgawa = false;
   }
 
-  AbcArchiveCache archiveCache;
+  boost::shared_ptr<AbcArchiveCache> archiveCache;
+  // created on first use, nodes hold on to it so it can outlive the archive
+  boost::shared_ptr<P3fArraySampleCache> positionCache;
 };
 
+// threads used to build the cache of an Ogawa archive, each of them reads
+// through its own stream
+static int getNumCacheThreads()
+{
+  const int cores = (int)boost::thread::hardware_concurrency();
+  return std::max(1, std::min(cores, 8));
+}
+
+static size_t getSampleCacheBudget()
+{
+  size_t megabytes = 1024;
+  const char* value = getenv("EXOCORTEX_ALEMBIC_SAMPLE_CACHE_MB");
+  if (value != NULL) {
+    megabytes = (size_t)std::max(0, atoi(value));
+  }
+  return megabytes * 1024 * 1024;
+}
+
+static void logSampleCacheStats(const AlembicArchiveInfo& info)
+{
+  if (!info.positionCache) {
+    return;
+  }
+  P3fArraySampleCache::Stats stats = info.positionCache->getStats();
+  EC_LOG_INFO("Position sample cache of " << info.archive->getName() << ": "
+              << stats.hits << " hits, " << stats.misses << " misses, "
+              << stats.evictions << " evictions, " << stats.entries
+              << " samples in " << stats.usage / (1024 * 1024) << " MB");
+}
+
 void replaceString(std::string& str, const std::string& oldStr,
                    const std::string& newStr)
 {
@@ -125,12 +158,15 @@ Alembic::Abc::IArchive* getArchiveFromID(std::string const& path)
 
       AbcF::IFactory iFactory;
       AbcF::IFactory::CoreType oType;
+      iFactory.setOgawaNumStreams(getNumCacheThreads());
       addArchive(new Abc::IArchive(iFactory.getArchive(resolvedPath, oType)));
 
       // addArchive(new Abc::IArchive( Alembic::AbcCoreHDF5::ReadArchive(),
       // resolvedPath));
 
-      Abc::IArchive* pArchive = gArchives.find(resolvedPath)->second.archive;
+      AlembicArchiveInfo& info = gArchives.find(resolvedPath)->second;
+      info.isOgawa = oType == AbcF::IFactory::kOgawa;
+      Abc::IArchive* pArchive = info.archive;
       EC_LOG_INFO("Opening Abc Archive: " << pArchive->getName());
       return pArchive;
     }
@@ -158,14 +194,24 @@ AbcArchiveCache* getArchiveCache(std::string const& path,
   if (it == gArchives.end()) return NULL;
 
   // compute cache if required.
-  if (it->second.archiveCache.size() == 0) {
-    if (!createAbcArchiveCache(it->second.archive, &(it->second.archiveCache),
-                               pBar)) {
-      it->second.archiveCache.clear();
-      return 0;
+  AbcArchiveCache* pArchiveCache = it->second.archiveCache.get();
+  if (pArchiveCache->size() == 0) {
+    const bool useIndex = isAbcArchiveCacheIndexEnabled();
+    if (!useIndex || !loadAbcArchiveCacheIndex(it->second.archive,
+                                               pArchiveCache)) {
+      // the HDF5 core can't be read from several threads
+      const int numThreads = it->second.isOgawa ? getNumCacheThreads() : 1;
+      if (!createAbcArchiveCache(it->second.archive, pArchiveCache, pBar,
+                                 numThreads)) {
+        pArchiveCache->clear();
+        return 0;
+      }
+      if (useIndex) {
+        saveAbcArchiveCacheIndex(it->second.archive, pArchiveCache);
+      }
     }
   }
-  return &(it->second.archiveCache);
+  return pArchiveCache;
 }
 
 std::string addArchive(Alembic::Abc::IArchive* archive)
@@ -187,6 +233,7 @@ void deleteArchive(std::string const& path)
   if (it == gArchives.end()) return;
 
   EC_LOG_INFO("Closing Abc Archive: " << it->second.archive->getName());
+  logSampleCacheStats(it->second);
   it->second.archive->reset();
   delete (it->second.archive);
   gArchives.erase(it);
@@ -198,6 +245,7 @@ void deleteAllArchives()
   for (std::map<std::string, AlembicArchiveInfo>::iterator it =
            gArchives.begin();
        it != gArchives.end(); ++it) {
+    logSampleCacheStats(it->second);
     it->second.archive->reset();
     delete (it->second.archive);
   }
@@ -281,6 +329,30 @@ int delRefArchive(std::string const& path)
   return it->second.refCount;
 }
 
+boost::shared_ptr<P3fArraySampleCache> getPositionSampleCache(
+    std::string const& path)
+{
+  ESS_PROFILE_SCOPE("getPositionSampleCache");
+  getArchiveFromID(path);
+  std::map<std::string, AlembicArchiveInfo>::iterator it =
+      gArchives.find(resolvePath(path));
+  if (it == gArchives.end()) {
+    return boost::shared_ptr<P3fArraySampleCache>();
+  }
+  if (!it->second.positionCache) {
+    it->second.positionCache.reset(
+        new P3fArraySampleCache(getSampleCacheBudget()));
+  }
+  return it->second.positionCache;
+}
+
+bool archiveSupportsConcurrentReads(std::string const& path)
+{
+  std::map<std::string, AlembicArchiveInfo>::iterator it =
+      gArchives.find(resolvePath(path));
+  return it != gArchives.end() && it->second.isOgawa;
+}
+
 int getRefArchive(std::string const& path)
 {
   ESS_PROFILE_SCOPE("getRefArchive");
@@ -316,8 +388,10 @@ SampleInfo getSampleInfo(double iFrame,
   SampleInfo result;
   if (numSamps == 0) numSamps = 1;
 
-  std::pair<Alembic::AbcCoreAbstract::index_t, double> floorIndex =
-      iTime->getFloorIndex(iFrame, numSamps);
+  // one search for both, the ceiling is needed most of the time
+  std::pair<Alembic::AbcCoreAbstract::index_t, double> floorIndex;
+  std::pair<Alembic::AbcCoreAbstract::index_t, double> ceilIndex;
+  iTime->getFloorAndCeilIndex(iFrame, numSamps, floorIndex, ceilIndex);
 
   result.floorIndex = floorIndex.first;
   result.ceilIndex = result.floorIndex;
@@ -327,9 +401,6 @@ SampleInfo getSampleInfo(double iFrame,
     return result;
   }
 
-  std::pair<Alembic::AbcCoreAbstract::index_t, double> ceilIndex =
-      iTime->getCeilIndex(iFrame, numSamps);
-
   if (fabs(iFrame - ceilIndex.second) < 0.0001) {
     result.floorIndex = ceilIndex.first;
     result.ceilIndex = result.floorIndex;
@@ -3,6 +3,7 @@
 
 #include "CommonAbcCache.h"
 #include "CommonAlembic.h"
+#include "CommonLRUCache.h"
 
 #include "CommonPBar.h"
 
@@ -20,77 +21,13 @@ struct SampleInfo {
 typedef boost::uint64_t uint64_t;
 #endif
 
-template <class Key, class Data>
-class MRUCache {
- private:
-  struct MRUCacheEntry {
-    Key key;
-    Data data;
-    Abc::uint64_t lastAccess;
-  };
-  std::vector<MRUCacheEntry> entries;
-  Abc::uint64_t nextAccess;
-  int maxEntries;
-
- public:
-  MRUCache(int _maxEntries = 2) : maxEntries(_maxEntries), nextAccess(0) {}
-  bool contains(Key const& key) const
-  {
-    for (int i = 0; i < entries.size(); i++) {
-      if (entries[i].key == key) {
-        return true;
-      }
-    }
-    return false;
-  }
-  void touch(Key const& key)
-  {
-    for (int i = 0; i < entries.size(); i++) {
-      if (entries[i].key == key) {
-        entries[i].lastAccess = nextAccess;
-        nextAccess++;
-      }
-    }
-  }
-  Data& get(Key const& key)
-  {
-    for (int i = 0; i < entries.size(); i++) {
-      if (entries[i].key == key) {
-        entries[i].lastAccess = nextAccess;
-        return entries[i].data;
-      }
-    }
-  }
-  void insert(Key const& key, Data& data)
-  {
-    if (entries.size() >= maxEntries) {
-      int oldestIndex = -1;
-      uint64_t oldestLastAccess;
-      for (int i = 0; i < entries.size(); i++) {
-        uint64_t lastAccess = entries[i].lastAccess;
-        if (oldestIndex == -1 || lastAccess < oldestLastAccess) {
-          oldestLastAccess = lastAccess;
-          oldestIndex = i;
-        }
-      }
-      if (oldestIndex >= 0) {
-        entries.erase(entries.begin() + oldestIndex);
-      }
-    }
-    MRUCacheEntry entry;
-    entry.key = key;
-    entry.data = data;
-    entry.lastAccess = nextAccess;
-    entries.push_back(entry);
-    nextAccess++;
-  }
-
-  void clear(void)
-  {
-    this->nextAccess = 0;
-    this->entries.clear();
-  }
-};
+// position samples read from an archive, keyed by the full name of the
+// object and the sample index
+typedef std::pair<std::string, Alembic::AbcCoreAbstract::index_t>
+    SampleCacheKey;
+typedef LRUCache<SampleCacheKey, Abc::P3fArraySamplePtr,
+                 LRUCacheArraySampleBytes>
+    P3fArraySampleCache;
 
 std::string getExporterName(std::string const& shortName);
 std::string getExporterFileName(std::string const& fileName);
@@ -121,6 +58,15 @@ int decRefArchive(std::string const& path);  // IMPORTANT: be extremely careful!
 int delRefArchive(std::string const& path);
 int getRefArchive(std::string const& path);
 
+// one cache per open archive, shared by everything reading positions from
+// it. The budget is EXOCORTEX_ALEMBIC_SAMPLE_CACHE_MB megabytes (1024 by
+// default). Returns NULL if the archive can't be opened.
+boost::shared_ptr<P3fArraySampleCache> getPositionSampleCache(
+    std::string const& path);
+
+// true for Ogawa archives, the HDF5 core can't be read from several threads
+bool archiveSupportsConcurrentReads(std::string const& path);
+
 void getPaths(std::vector<std::string>& paths);
 
 bool parseTrailingNumber(std::string const& text,
@@ -365,50 +311,141 @@ int prescanAlembicHierarchy(AbcArchiveCache* pArchiveCache,
                             std::map<std::string, bool>& map,
                             bool bIncludeChildren = false);
 
-template <class S>
-struct cia_map_key {
-  Alembic::Abc::int32_t vid;
-  S data;
+// Assigns consecutive indices to (vertex id, N floats) keys in the order they
+// are first seen, using an open addressing hash table over flat arrays.
+//
+// With epsilon == 0 the values are compared bit for bit (+0 and -0 are the
+// same), otherwise they are quantized to a grid of that size before being
+// compared. The values stored for an index are always the ones of the first
+// occurrence.
+template <size_t N>
+class DedupTable {
+ public:
+  DedupTable(size_t expectedKeys = 0, float epsilon = 0.0f)
+      : m_invEpsilon(epsilon > 0.0f ? 1.0f / epsilon : 0.0f)
+  {
+    size_t capacity = 16;
+    while (capacity < expectedKeys * 2) {
+      capacity <<= 1;
+    }
+    m_slots.resize(capacity, 0);
+    m_mask = capacity - 1;
+    m_vertexIds.reserve(expectedKeys);
+    m_hashes.reserve(expectedKeys);
+    m_words.reserve(expectedKeys * N);
+    m_values.reserve(expectedKeys * N);
+  }
 
-  cia_map_key(const Alembic::Abc::int32_t& _vid, const S& _data)
-      : vid(_vid), data(_data)
+  // returns the index of the key, adding it if it was not seen yet
+  Abc::uint32_t insert(Abc::int32_t vertexId, const float* values)
   {
+    Abc::uint32_t words[N];
+    Abc::uint32_t hash = 2166136261u ^ (Abc::uint32_t)vertexId;
+    for (size_t c = 0; c < N; ++c) {
+      words[c] = toWord(values[c]);
+      hash = (hash ^ words[c]) * 16777619u;
+    }
+    hash ^= hash >> 15;
+
+    for (size_t slot = hash & m_mask;; slot = (slot + 1) & m_mask) {
+      const Abc::uint32_t entry = m_slots[slot];
+      if (entry == 0) {
+        const Abc::uint32_t index = (Abc::uint32_t)m_vertexIds.size();
+        m_slots[slot] = index + 1;
+        m_vertexIds.push_back(vertexId);
+        m_hashes.push_back(hash);
+        m_words.insert(m_words.end(), words, words + N);
+        m_values.insert(m_values.end(), values, values + N);
+        if (m_vertexIds.size() * 2 > m_slots.size()) {
+          grow();
+        }
+        return index;
+      }
+      const Abc::uint32_t index = entry - 1;
+      if (m_hashes[index] == hash && m_vertexIds[index] == vertexId &&
+          memcmp(&m_words[index * N], words, sizeof(words)) == 0) {
+        return index;
+      }
+    }
   }
 
-  bool operator<(const cia_map_key& other) const
+  size_t size() const { return m_vertexIds.size(); }
+
+  // size() * N floats, in index order
+  const std::vector<float>& getValues() const { return m_values; }
+
+ private:
+  Abc::uint32_t toWord(float value) const
   {
-    if (vid == other.vid) return data < other.data;
-    return vid < other.vid;
+    if (m_invEpsilon > 0.0f) {
+      // cells past the int32 range are clamped to its ends and NaN goes to
+      // the lowest one, so the conversion to int32 is always defined
+      const double cell = floor((double)value * m_invEpsilon + 0.5);
+      if (!(cell > -2147483648.0)) {
+        return 0x80000000u;
+      }
+      if (cell > 2147483647.0) {
+        return 0x7fffffffu;
+      }
+      return (Abc::uint32_t)(Abc::int32_t)cell;
+    }
+    if (value == 0.0f) {
+      return 0;
+    }
+    Abc::uint32_t word;
+    memcpy(&word, &value, sizeof(word));
+    return word;
   }
+
+  void grow()
+  {
+    std::vector<Abc::uint32_t> slots(m_slots.size() * 2, 0);
+    m_mask = slots.size() - 1;
+    for (size_t i = 0; i < m_hashes.size(); ++i) {
+      size_t slot = m_hashes[i] & m_mask;
+      while (slots[slot] != 0) {
+        slot = (slot + 1) & m_mask;
+      }
+      slots[slot] = (Abc::uint32_t)i + 1;
+    }
+    m_slots.swap(slots);
+  }
+
+  std::vector<Abc::uint32_t> m_slots;  // entry index + 1, 0 when empty
+  size_t m_mask;
+  float m_invEpsilon;
+  std::vector<Abc::int32_t> m_vertexIds;
+  std::vector<Abc::uint32_t> m_hashes;
+  std::vector<Abc::uint32_t> m_words;
+  std::vector<float> m_values;
 };
 
-// Alembic::Abc::N3f
-// SortableV3f
-template <class T, class S>
+// T must be made of floats only (V2f, V3f, N3f...)
+template <class T>
 void createIndexedArray(
     const std::vector<Alembic::Abc::int32_t>& faceIndicesVec,
     const std::vector<T>& inputVec, std::vector<T>& outputVec,
-    std::vector<Alembic::Abc::uint32_t>& outputIndices)
+    std::vector<Alembic::Abc::uint32_t>& outputIndices, float epsilon = 0.0f)
 {
-  std::map<cia_map_key<S>, size_t> normalMap;
+  const size_t numComponents = sizeof(T) / sizeof(float);
+  const size_t count = std::min(inputVec.size(), faceIndicesVec.size());
+  DedupTable<numComponents> table(count, epsilon);
 
   outputIndices.resize(inputVec.size());
   outputVec.clear();
+  if (count == 0) {
+    return;
+  }
 
   // loop over all data
-  for (size_t i = 0; i < inputVec.size() && i < faceIndicesVec.size(); ++i) {
-    cia_map_key<S> mkey(faceIndicesVec[i], inputVec[i]);
-    if (normalMap.find(mkey) !=
-        normalMap
-            .end())  // the pair <vertexId, S> was found, let reuse it's index!
-      outputIndices[i] = (Alembic::Abc::uint32_t)normalMap.find(mkey)->second;
-    else {
-      const int map_size = (int)normalMap.size();
-      outputVec.push_back(inputVec[i]);
-      outputIndices[i] = map_size;
-      normalMap[mkey] = map_size;
-    }
+  const float* input = reinterpret_cast<const float*>(&inputVec[0]);
+  for (size_t i = 0; i < count; ++i) {
+    outputIndices[i] =
+        table.insert(faceIndicesVec[i], input + i * numComponents);
   }
+
+  outputVec.resize(table.size());
+  memcpy(&outputVec[0], &table.getValues()[0], table.size() * sizeof(T));
 }
 
 namespace ObjectPrint {
@@ -0,0 +1,182 @@
+#include "CommonAlembic.h"
+#include "CommonParallel.h"
+#include "CommonPointBlend.h"
+#include "TestUtils.h"
+
+// the per point loop the Maya deformer runs on the points its iterator gives,
+// blendPoints has to match it up to float rounding
+void blendPointsPerPoint(std::vector<double>& points,
+                         const std::vector<float>& weights, float envelope,
+                         const std::vector<Abc::V3f>& floorPositions,
+                         const std::vector<Abc::V3f>& ceilPositions,
+                         float alpha)
+{
+  for (size_t i = 0; i < floorPositions.size(); ++i) {
+    const float weight = (weights.empty() ? 1.0f : weights[i]) * envelope;
+    const float iweight = 1.0f - weight;
+    double* pt = &points[i * 4];
+    pt[0] *= iweight;
+    pt[1] *= iweight;
+    pt[2] *= iweight;
+
+    const Abc::V3f& pos1 = floorPositions[i];
+    if (!ceilPositions.empty()) {
+      const Abc::V3f& pos2 = ceilPositions[i];
+      pt[0] += weight * (pos1.x + (pos2.x - pos1.x) * alpha);
+      pt[1] += weight * (pos1.y + (pos2.y - pos1.y) * alpha);
+      pt[2] += weight * (pos1.z + (pos2.z - pos1.z) * alpha);
+    }
+    else {
+      pt[0] += weight * pos1.x;
+      pt[1] += weight * pos1.y;
+      pt[2] += weight * pos1.z;
+    }
+  }
+}
+
+float randomFloat(float range)
+{
+  return ((float)rand() / RAND_MAX - 0.5f) * range;
+}
+
+struct BlendInput {
+  std::vector<double> points;
+  std::vector<float> weights;
+  std::vector<Abc::V3f> floorPositions;
+  std::vector<Abc::V3f> ceilPositions;
+};
+
+// w is set to something the blend must not touch
+void makeInput(size_t count, bool withWeights, bool withCeil, BlendInput& in)
+{
+  in.points.resize(count * 4);
+  for (size_t i = 0; i < count; ++i) {
+    in.points[i * 4] = randomFloat(100.0f);
+    in.points[i * 4 + 1] = randomFloat(100.0f);
+    in.points[i * 4 + 2] = randomFloat(100.0f);
+    in.points[i * 4 + 3] = 1.0 + (double)i;
+  }
+  in.weights.clear();
+  if (withWeights) {
+    for (size_t i = 0; i < count; ++i) {
+      in.weights.push_back(i % 5 == 0 ? 0.0f : (float)rand() / RAND_MAX);
+    }
+  }
+  in.floorPositions.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    in.floorPositions[i] =
+        Abc::V3f(randomFloat(100.0f), randomFloat(100.0f), randomFloat(100.0f));
+  }
+  in.ceilPositions.clear();
+  if (withCeil) {
+    for (size_t i = 0; i < count; ++i) {
+      in.ceilPositions.push_back(in.floorPositions[i] +
+                                 Abc::V3f(randomFloat(1.0f), randomFloat(1.0f),
+                                          randomFloat(1.0f)));
+    }
+  }
+}
+
+// blends points, a copy of in.points, in place
+void runBlendPoints(BlendInput& in, std::vector<double>& points,
+                    float envelope, float alpha)
+{
+  if (in.floorPositions.empty()) {
+    return;
+  }
+  blendPoints(reinterpret_cast<double(*)[4]>(&points[0]),
+              in.floorPositions.size(),
+              in.weights.empty() ? NULL : &in.weights[0], envelope,
+              &in.floorPositions[0],
+              in.ceilPositions.empty() ? NULL : &in.ceilPositions[0], alpha);
+}
+
+bool closeEnough(const std::vector<double>& a, const std::vector<double>& b)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (fabs(a[i] - b[i]) > 1e-4 * (1.0 + fabs(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void testMatchesPerPoint()
+{
+  const float envelopes[] = {1.0f, 0.5f, 0.0f};
+  const float alphas[] = {0.0f, 0.25f, 1.0f};
+
+  // below and above the size where the work is split across threads
+  const size_t counts[] = {0, 1, 7, 1000, 100000};
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+    for (int flags = 0; flags < 4; ++flags) {
+      BlendInput in;
+      makeInput(counts[c], (flags & 1) != 0, (flags & 2) != 0, in);
+
+      for (size_t e = 0; e < sizeof(envelopes) / sizeof(envelopes[0]); ++e) {
+        for (size_t a = 0; a < sizeof(alphas) / sizeof(alphas[0]); ++a) {
+          std::vector<double> expected = in.points, result = in.points;
+          blendPointsPerPoint(expected, in.weights, envelopes[e],
+                              in.floorPositions, in.ceilPositions, alphas[a]);
+          runBlendPoints(in, result, envelopes[e], alphas[a]);
+          TESTING_ASSERT(closeEnough(result, expected));
+
+          // w is left alone
+          for (size_t i = 0; i < counts[c]; ++i) {
+            TESTING_ASSERT(result[i * 4 + 3] == in.points[i * 4 + 3]);
+          }
+        }
+      }
+    }
+  }
+}
+
+void testFullWeightReachesTarget()
+{
+  BlendInput in;
+  makeInput(50000, false, false, in);
+  std::vector<double> result = in.points;
+  runBlendPoints(in, result, 1.0f, 0.0f);
+  for (size_t i = 0; i < in.floorPositions.size(); ++i) {
+    TESTING_ASSERT(result[i * 4] == in.floorPositions[i].x);
+    TESTING_ASSERT(result[i * 4 + 1] == in.floorPositions[i].y);
+    TESTING_ASSERT(result[i * 4 + 2] == in.floorPositions[i].z);
+  }
+}
+
+void benchmark(size_t count)
+{
+  BlendInput in;
+  makeInput(count, true, true, in);
+
+  std::vector<double> result = in.points, expected = in.points;
+  double start = getTestTime();
+  runBlendPoints(in, result, 0.8f, 0.3f);
+  const double blendTime = getTestTime() - start;
+
+  start = getTestTime();
+  blendPointsPerPoint(expected, in.weights, 0.8f, in.floorPositions,
+                      in.ceilPositions, 0.3f);
+  const double loopTime = getTestTime() - start;
+
+  TESTING_ASSERT(closeEnough(result, expected));
+  printf("blendPoints on %d points: %.4fs, per point loop %.4fs\n",
+         (int)count, blendTime, loopTime);
+}
+
+int main(int argc, char* argv[])
+{
+  srand(1);
+  testMatchesPerPoint();
+  testFullWeightReachesTarget();
+
+  // the number of points to time can be given on the command line
+  benchmark(argc > 1 ? (size_t)atoi(argv[1]) : 1000000);
+
+  // the workers have to be gone before the statics they wait on
+  shutdownParallelPool();
+  return 0;
+}
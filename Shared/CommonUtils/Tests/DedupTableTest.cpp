@@ -0,0 +1,147 @@
+#include "CommonAlembic.h"
+#include "CommonUtilities.h"
+#include "TestUtils.h"
+
+#include <limits>
+
+// the std::map de-duplication createIndexedArray used before DedupTable
+void createIndexedArrayWithMap(const std::vector<Abc::int32_t>& faceIndices,
+                               const std::vector<Abc::V3f>& input,
+                               std::vector<Abc::V3f>& output,
+                               std::vector<Abc::uint32_t>& outputIndices)
+{
+  typedef std::map<std::pair<Abc::int32_t, SortableV3f>, size_t> KeyMap;
+  KeyMap keys;
+  outputIndices.resize(input.size());
+  output.clear();
+  for (size_t i = 0; i < input.size() && i < faceIndices.size(); ++i) {
+    const std::pair<Abc::int32_t, SortableV3f> key(faceIndices[i], input[i]);
+    KeyMap::const_iterator it = keys.find(key);
+    if (it != keys.end()) {
+      outputIndices[i] = (Abc::uint32_t)it->second;
+    }
+    else {
+      outputIndices[i] = (Abc::uint32_t)output.size();
+      keys[key] = output.size();
+      output.push_back(input[i]);
+    }
+  }
+}
+
+// face-vertices of a grid of quads sharing vertices, with one normal per
+// vertex plus a hard edge every few faces
+void makeMeshNormals(size_t numFaces, std::vector<Abc::int32_t>& faceIndices,
+                     std::vector<Abc::V3f>& normals)
+{
+  faceIndices.clear();
+  normals.clear();
+  const size_t width = 1024;
+  for (size_t f = 0; f < numFaces; ++f) {
+    const Abc::int32_t v = (Abc::int32_t)(f / width * (width + 1) + f % width);
+    const Abc::int32_t corners[4] = {v, v + 1, v + (Abc::int32_t)width + 2,
+                                     v + (Abc::int32_t)width + 1};
+    for (size_t c = 0; c < 4; ++c) {
+      faceIndices.push_back(corners[c]);
+      Abc::V3f n(sinf((float)corners[c]), cosf((float)corners[c]), 0.5f);
+      if (f % 7 == 0) {
+        n = Abc::V3f(0.0f, 0.0f, 1.0f);
+      }
+      normals.push_back(n.normalized());
+    }
+  }
+}
+
+void testExactMatchesMap()
+{
+  std::vector<Abc::int32_t> faceIndices;
+  std::vector<Abc::V3f> normals;
+  makeMeshNormals(10000, faceIndices, normals);
+  normals[5] = Abc::V3f(-0.0f, 0.0f, 1.0f);
+  normals[9] = Abc::V3f(0.0f, -0.0f, 1.0f);
+
+  std::vector<Abc::V3f> values, mapValues;
+  std::vector<Abc::uint32_t> indices, mapIndices;
+  createIndexedArray<Abc::V3f>(faceIndices, normals, values, indices);
+  createIndexedArrayWithMap(faceIndices, normals, mapValues, mapIndices);
+
+  TESTING_ASSERT(indices == mapIndices);
+  TESTING_ASSERT(values.size() == mapValues.size());
+  TESTING_ASSERT(memcmp(&values[0], &mapValues[0],
+                        values.size() * sizeof(Abc::V3f)) == 0);
+}
+
+void testEpsilon()
+{
+  std::vector<Abc::int32_t> faceIndices(4, 3);
+  std::vector<Abc::V2f> uvs;
+  uvs.push_back(Abc::V2f(0.5f, 0.25f));
+  uvs.push_back(Abc::V2f(0.5f + 1e-6f, 0.25f));
+  uvs.push_back(Abc::V2f(0.5f, 0.25f + 0.01f));
+  uvs.push_back(Abc::V2f(0.5f, 0.25f - 1e-6f));
+
+  std::vector<Abc::V2f> values;
+  std::vector<Abc::uint32_t> indices;
+  createIndexedArray<Abc::V2f>(faceIndices, uvs, values, indices, 1e-4f);
+  TESTING_ASSERT(values.size() == 2);
+  TESTING_ASSERT(indices[0] == 0 && indices[1] == 0 && indices[3] == 0);
+  TESTING_ASSERT(indices[2] == 1);
+  // the first value seen is the one kept
+  TESTING_ASSERT(values[0] == uvs[0]);
+}
+
+void testEpsilonOutOfRange()
+{
+  // these land far outside the int32 grid, they must still quantize to
+  // something well defined and stay apart from values inside the grid
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<Abc::int32_t> faceIndices(8, 0);
+  std::vector<Abc::V2f> uvs;
+  uvs.push_back(Abc::V2f(1e30f, 0.0f));
+  uvs.push_back(Abc::V2f(2e30f, 0.0f));
+  uvs.push_back(Abc::V2f(inf, 0.0f));
+  uvs.push_back(Abc::V2f(-1e30f, 0.0f));
+  uvs.push_back(Abc::V2f(-inf, 0.0f));
+  uvs.push_back(Abc::V2f(nan, 0.0f));
+  uvs.push_back(Abc::V2f(nan, 0.0f));
+  uvs.push_back(Abc::V2f(1.0f, 0.0f));
+
+  std::vector<Abc::V2f> values;
+  std::vector<Abc::uint32_t> indices;
+  createIndexedArray<Abc::V2f>(faceIndices, uvs, values, indices, 1e-6f);
+  TESTING_ASSERT(indices[1] == indices[0] && indices[2] == indices[0]);
+  TESTING_ASSERT(indices[4] == indices[3] && indices[3] != indices[0]);
+  TESTING_ASSERT(indices[6] == indices[5]);
+  TESTING_ASSERT(indices[7] != indices[0] && indices[7] != indices[3]);
+}
+
+void benchmark(size_t numFaces)
+{
+  std::vector<Abc::int32_t> faceIndices;
+  std::vector<Abc::V3f> normals;
+  makeMeshNormals(numFaces, faceIndices, normals);
+
+  std::vector<Abc::V3f> values;
+  std::vector<Abc::uint32_t> indices;
+  double start = getTestTime();
+  createIndexedArray<Abc::V3f>(faceIndices, normals, values, indices);
+  const double tableTime = getTestTime() - start;
+
+  start = getTestTime();
+  createIndexedArrayWithMap(faceIndices, normals, values, indices);
+  const double mapTime = getTestTime() - start;
+
+  printf("createIndexedArray on %d face-vertices: %.3fs, std::map %.3fs\n",
+         (int)faceIndices.size(), tableTime, mapTime);
+}
+
+int main(int argc, char* argv[])
+{
+  testExactMatchesMap();
+  testEpsilon();
+  testEpsilonOutOfRange();
+
+  // the number of faces to time can be given on the command line
+  benchmark(argc > 1 ? (size_t)atoi(argv[1]) : 250000);
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include "CommonAlembic.h"
+#include "CommonLRUCache.h"
+#include "TestUtils.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+typedef LRUCache<int, int> CountCache;
+
+// the cost of an entry is the length of the string
+struct StringBytes {
+  size_t operator()(const std::string& s) const { return s.size(); }
+};
+typedef LRUCache<int, std::string, StringBytes> ByteCache;
+
+void checkStats(const CountCache::Stats& stats, size_t entries, size_t usage,
+                boost::uint64_t hits, boost::uint64_t misses,
+                boost::uint64_t evictions)
+{
+  TESTING_ASSERT(stats.entries == entries);
+  TESTING_ASSERT(stats.usage == usage);
+  TESTING_ASSERT(stats.hits == hits);
+  TESTING_ASSERT(stats.misses == misses);
+  TESTING_ASSERT(stats.evictions == evictions);
+}
+
+void testEvictsLeastRecentlyUsed()
+{
+  CountCache cache(3);
+  cache.insert(1, 10);
+  cache.insert(2, 20);
+  cache.insert(3, 30);
+  checkStats(cache.getStats(), 3, 3, 0, 0, 0);
+  TESTING_ASSERT(cache.getStats().budget == 3);
+
+  // 1 becomes the most recently used, so 2 goes first
+  int value = 0;
+  TESTING_ASSERT(cache.get(1, value) && value == 10);
+  cache.insert(4, 40);
+  TESTING_ASSERT(!cache.contains(2));
+  TESTING_ASSERT(cache.contains(1) && cache.contains(3) && cache.contains(4));
+  checkStats(cache.getStats(), 3, 3, 1, 0, 1);
+
+  // a miss leaves the value alone
+  value = -1;
+  TESTING_ASSERT(!cache.get(2, value) && value == -1);
+  checkStats(cache.getStats(), 3, 3, 1, 1, 1);
+
+  // replacing an entry doesn't evict anything and makes it the newest
+  cache.insert(3, 31);
+  TESTING_ASSERT(cache.get(3, value) && value == 31);
+  checkStats(cache.getStats(), 3, 3, 2, 1, 1);
+  cache.insert(5, 50);
+  TESTING_ASSERT(!cache.contains(1) && cache.contains(3));
+  checkStats(cache.getStats(), 3, 3, 2, 1, 2);
+}
+
+void testBudgetAndErase()
+{
+  CountCache cache(4);
+  for (int i = 0; i < 4; ++i) {
+    cache.insert(i, i);
+  }
+
+  // the oldest ones go when the budget shrinks
+  cache.setBudget(2);
+  TESTING_ASSERT(!cache.contains(0) && !cache.contains(1));
+  TESTING_ASSERT(cache.contains(2) && cache.contains(3));
+  checkStats(cache.getStats(), 2, 2, 0, 0, 2);
+
+  cache.erase(2);
+  cache.erase(42);
+  checkStats(cache.getStats(), 1, 1, 0, 0, 2);
+
+  // clear keeps the counters
+  int value = 0;
+  cache.get(3, value);
+  cache.clear();
+  TESTING_ASSERT(!cache.contains(3));
+  checkStats(cache.getStats(), 0, 0, 1, 0, 2);
+}
+
+void testSizedEntries()
+{
+  ByteCache cache(10);
+  cache.insert(1, "aaaa");
+  cache.insert(2, "bbbb");
+  TESTING_ASSERT(cache.getStats().usage == 8);
+
+  // 3 bytes don't fit with the 8 already used, the oldest entry goes
+  cache.insert(3, "ccc");
+  TESTING_ASSERT(!cache.contains(1) && cache.contains(2) && cache.contains(3));
+  TESTING_ASSERT(cache.getStats().usage == 7);
+  TESTING_ASSERT(cache.getStats().evictions == 1);
+
+  // growing an entry is accounted for
+  cache.insert(3, "cccccc");
+  TESTING_ASSERT(cache.getStats().usage == 10);
+
+  // an entry larger than the budget isn't cached, and replaces nothing
+  cache.insert(2, "this is too long");
+  TESTING_ASSERT(!cache.contains(2));
+  TESTING_ASSERT(cache.getStats().usage == 6);
+  TESTING_ASSERT(cache.getStats().entries == 1);
+}
+
+// threads share one cache, the accounting has to stay consistent
+void hammer(CountCache* cache, int seed)
+{
+  for (int i = 0; i < 20000; ++i) {
+    const int key = (seed * 7919 + i * 31) % 200;
+    int value = 0;
+    if (cache->get(key, value)) {
+      TESTING_ASSERT(value == key * 3);
+    }
+    else {
+      cache->insert(key, key * 3);
+    }
+    if (i % 97 == 0) {
+      cache->erase(key);
+    }
+  }
+}
+
+void testThreads()
+{
+  CountCache cache(64);
+  boost::thread_group threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.create_thread(boost::bind(hammer, &cache, i));
+  }
+  threads.join_all();
+
+  CountCache::Stats stats = cache.getStats();
+  TESTING_ASSERT(stats.entries == stats.usage);
+  TESTING_ASSERT(stats.usage <= stats.budget);
+  TESTING_ASSERT(stats.hits + stats.misses == 4 * 20000);
+}
+
+void benchmark(int count)
+{
+  CountCache cache(count / 2);
+  const double start = getTestTime();
+  for (int i = 0; i < count; ++i) {
+    int value = 0;
+    const int key = (i * 7) % count;
+    if (!cache.get(key, value)) {
+      cache.insert(key, i);
+    }
+  }
+  const double elapsed = getTestTime() - start;
+  printf("%d lookups and inserts: %.4fs, %.0fns each\n", count, elapsed,
+         elapsed / count * 1e9);
+}
+
+int main(int argc, char* argv[])
+{
+  testEvictsLeastRecentlyUsed();
+  testBudgetAndErase();
+  testSizedEntries();
+  testThreads();
+
+  // the number of lookups to time can be given on the command line
+  benchmark(argc > 1 ? atoi(argv[1]) : 1000000);
+  return 0;
+}
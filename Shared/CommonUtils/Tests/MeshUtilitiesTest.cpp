@@ -0,0 +1,159 @@
+#include "CommonAlembic.h"
+#include "CommonMeshUtilities.h"
+#include "TestUtils.h"
+
+// the per element loops the Arnold plugin used before the kernels, they are
+// the reference the kernels must match bit for bit
+
+void reverseFaceWindingPerElement(const std::vector<AbcA::int32_t>& faceCounts,
+                                  const std::vector<AbcA::int32_t>& faceIndices,
+                                  std::vector<AbcA::uint32_t>& reversed,
+                                  std::vector<AbcA::uint32_t>& order)
+{
+  reversed.resize(faceIndices.size());
+  order.resize(faceIndices.size());
+  unsigned int offset = 0;
+  for (size_t i = 0; i < faceCounts.size(); ++i) {
+    const int count = faceCounts[i];
+    for (int j = 0; j < count; ++j) {
+      const int offFaceCounts = offset + count - (j + 1);
+      reversed[offset + j] = faceIndices[offFaceCounts];
+      order[offset + j] = offFaceCounts;
+    }
+    offset += count;
+  }
+}
+
+void lerpPointsPerElement(std::vector<Abc::V3f>& dst,
+                          const std::vector<Abc::V3f>& a,
+                          const std::vector<Abc::V3f>& b, float alpha)
+{
+  const float ialpha = 1.0f - alpha;
+  dst.resize(a.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    dst[i].x = a[i].x * ialpha + b[i].x * alpha;
+    dst[i].y = a[i].y * ialpha + b[i].y * alpha;
+    dst[i].z = a[i].z * ialpha + b[i].z * alpha;
+  }
+}
+
+void extrapolatePointsPerElement(std::vector<Abc::V3f>& dst,
+                                 const std::vector<Abc::V3f>& p,
+                                 const std::vector<Abc::V3f>& v, float alpha)
+{
+  dst.resize(p.size());
+  for (size_t i = 0; i < p.size(); i++) {
+    dst[i].x = p[i].x + (v[i].x * alpha);
+    dst[i].y = p[i].y + (v[i].y * alpha);
+    dst[i].z = p[i].z + (v[i].z * alpha);
+  }
+}
+
+float randomFloat()
+{
+  // spans several orders of magnitude, with some denormals and signed zeros
+  const int r = rand();
+  switch (r % 16) {
+    case 0:
+      return 1e-40f;
+    case 1:
+      return -0.0f;
+    default:
+      return ((float)rand() / RAND_MAX - 0.5f) *
+             powf(10.0f, (float)(r % 13 - 6));
+  }
+}
+
+void makePoints(size_t count, std::vector<Abc::V3f>& points)
+{
+  points.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    points[i] = Abc::V3f(randomFloat(), randomFloat(), randomFloat());
+  }
+}
+
+bool sameBits(const std::vector<Abc::V3f>& a, const std::vector<Abc::V3f>& b)
+{
+  return a.size() == b.size() &&
+         (a.empty() || memcmp(&a[0], &b[0], a.size() * sizeof(Abc::V3f)) == 0);
+}
+
+void testReverseFaceWinding()
+{
+  std::vector<AbcA::int32_t> faceCounts, faceIndices;
+  for (int f = 0; f < 1000; ++f) {
+    const int count = 3 + rand() % 6;
+    faceCounts.push_back(count);
+    for (int j = 0; j < count; ++j) {
+      faceIndices.push_back(rand() % 5000);
+    }
+  }
+
+  std::vector<AbcA::uint32_t> expectedIndices, expectedOrder;
+  reverseFaceWindingPerElement(faceCounts, faceIndices, expectedIndices,
+                               expectedOrder);
+
+  std::vector<AbcA::uint32_t> indices(faceIndices.size());
+  std::vector<AbcA::uint32_t> order(faceIndices.size());
+  reverseFaceWinding(&faceCounts[0], faceCounts.size(), &faceIndices[0],
+                     &indices[0], &order[0]);
+  TESTING_ASSERT(indices == expectedIndices);
+  TESTING_ASSERT(order == expectedOrder);
+}
+
+void testPointKernels()
+{
+  const float alphas[] = {0.0f, 0.25f, 0.3333333f, 0.5f, 0.9f, 1.0f, -0.2f};
+
+  // counts with every remainder of the SSE loop
+  for (size_t count = 0; count < 40; ++count) {
+    std::vector<Abc::V3f> a, b;
+    makePoints(count, a);
+    makePoints(count, b);
+
+    for (size_t k = 0; k < sizeof(alphas) / sizeof(alphas[0]); ++k) {
+      std::vector<Abc::V3f> expected, result(count);
+      lerpPointsPerElement(expected, a, b, alphas[k]);
+      if (count > 0) {
+        lerpPoints(&result[0], &a[0], &b[0], count, alphas[k]);
+      }
+      TESTING_ASSERT(sameBits(result, expected));
+
+      extrapolatePointsPerElement(expected, a, b, alphas[k]);
+      if (count > 0) {
+        extrapolatePoints(&result[0], &a[0], &b[0], count, alphas[k]);
+      }
+      TESTING_ASSERT(sameBits(result, expected));
+    }
+  }
+}
+
+void benchmark(size_t count)
+{
+  std::vector<Abc::V3f> a, b, expected, result(count);
+  makePoints(count, a);
+  makePoints(count, b);
+
+  double start = getTestTime();
+  lerpPoints(&result[0], &a[0], &b[0], count, 0.3f);
+  const double kernelTime = getTestTime() - start;
+
+  start = getTestTime();
+  lerpPointsPerElement(expected, a, b, 0.3f);
+  const double loopTime = getTestTime() - start;
+
+  TESTING_ASSERT(sameBits(result, expected));
+  printf("lerpPoints on %d points: %.4fs, per element loop %.4fs\n",
+         (int)count, kernelTime, loopTime);
+}
+
+int main(int argc, char* argv[])
+{
+  srand(1);
+  testReverseFaceWinding();
+  testPointKernels();
+
+  // the number of points to time can be given on the command line
+  benchmark(argc > 1 ? (size_t)atoi(argv[1]) : 1000000);
+  return 0;
+}
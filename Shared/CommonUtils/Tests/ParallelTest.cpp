@@ -0,0 +1,180 @@
+#include "CommonAlembic.h"
+#include "CommonParallel.h"
+#include "TestUtils.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+// counts the visits of every index and keeps the chunks it was given
+class CountRange : public ParallelRange {
+ public:
+  CountRange(size_t count) : visits(count, 0) {}
+
+  virtual void run(size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i) {
+      ++visits[i];
+    }
+    boost::mutex::scoped_lock l(lock);
+    chunks.push_back(std::make_pair(begin, end));
+  }
+
+  std::vector<int> visits;
+  boost::mutex lock;
+  std::vector<std::pair<size_t, size_t> > chunks;
+};
+
+void checkVisitedOnce(const CountRange& range)
+{
+  for (size_t i = 0; i < range.visits.size(); ++i) {
+    TESTING_ASSERT(range.visits[i] == 1);
+  }
+}
+
+void testCoversEveryIndex()
+{
+  const size_t counts[] = {0, 1, 2, 15, 16, 17, 1000, 123457};
+  const size_t grains[] = {0, 1, 16, 1000, 1000000};
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+    for (size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); ++g) {
+      CountRange range(counts[c]);
+      parallelFor(counts[c], grains[g], range);
+      checkVisitedOnce(range);
+
+      // only the last chunk can be smaller than the grain size
+      for (size_t i = 0; i < range.chunks.size(); ++i) {
+        const size_t size = range.chunks[i].second - range.chunks[i].first;
+        TESTING_ASSERT(size > 0);
+        TESTING_ASSERT(size >= grains[g] ||
+                       range.chunks[i].second == counts[c]);
+      }
+    }
+  }
+}
+
+// runs a whole loop from inside each chunk, which has to fall back to the
+// calling thread instead of waiting on the busy pool
+class NestedRange : public ParallelRange {
+ public:
+  NestedRange(size_t count, size_t innerCount)
+      : inner(count * innerCount), innerCount(innerCount)
+  {
+  }
+
+  virtual void run(size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i) {
+      CountRange range(innerCount);
+      parallelFor(innerCount, 1, range);
+      checkVisitedOnce(range);
+      for (size_t j = 0; j < innerCount; ++j) {
+        inner[i * innerCount + j] = range.visits[j];
+      }
+    }
+  }
+
+  std::vector<int> inner;
+  size_t innerCount;
+};
+
+void testNested()
+{
+  NestedRange range(64, 100);
+  parallelFor(64, 1, range);
+  for (size_t i = 0; i < range.inner.size(); ++i) {
+    TESTING_ASSERT(range.inner[i] == 1);
+  }
+}
+
+// several threads submitting at once, the ones finding the pool busy run
+// their loop themselves
+void submitLoops(int* failures)
+{
+  for (int i = 0; i < 50; ++i) {
+    CountRange range(10000);
+    parallelFor(10000, 100, range);
+    for (size_t j = 0; j < range.visits.size(); ++j) {
+      if (range.visits[j] != 1) {
+        ++*failures;
+        break;
+      }
+    }
+  }
+}
+
+void testConcurrentCallers()
+{
+  int failures[4] = {0, 0, 0, 0};
+  boost::thread_group threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.create_thread(boost::bind(submitLoops, &failures[i]));
+  }
+  threads.join_all();
+  for (int i = 0; i < 4; ++i) {
+    TESTING_ASSERT(failures[i] == 0);
+  }
+}
+
+void testShutdownAndRestart()
+{
+  TESTING_ASSERT(getParallelThreadCount() >= 1);
+  shutdownParallelPool();
+  shutdownParallelPool();
+
+  // the workers come back on the next loop
+  CountRange range(50000);
+  parallelFor(50000, 16, range);
+  checkVisitedOnce(range);
+  shutdownParallelPool();
+}
+
+class SumRange : public ParallelRange {
+ public:
+  SumRange(const std::vector<double>& v) : values(v), sums(v.size(), 0.0) {}
+
+  virtual void run(size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i) {
+      sums[i] = sqrt(values[i]) * sin(values[i]);
+    }
+  }
+
+  const std::vector<double>& values;
+  std::vector<double> sums;
+};
+
+void benchmark(size_t count)
+{
+  std::vector<double> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = (double)i;
+  }
+
+  SumRange serial(values);
+  double start = getTestTime();
+  serial.run(0, count);
+  const double serialTime = getTestTime() - start;
+
+  SumRange parallel(values);
+  start = getTestTime();
+  parallelFor(count, 1024, parallel);
+  const double parallelTime = getTestTime() - start;
+
+  TESTING_ASSERT(parallel.sums == serial.sums);
+  printf("parallelFor on %d items with %d threads: %.4fs, serial %.4fs\n",
+         (int)count, getParallelThreadCount(), parallelTime, serialTime);
+}
+
+int main(int argc, char* argv[])
+{
+  testCoversEveryIndex();
+  testNested();
+  testConcurrentCallers();
+
+  // the number of items to time can be given on the command line
+  benchmark(argc > 1 ? (size_t)atoi(argv[1]) : 4000000);
+
+  testShutdownAndRestart();
+  return 0;
+}
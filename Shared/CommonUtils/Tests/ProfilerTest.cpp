@@ -0,0 +1,109 @@
+#include "CommonAlembic.h"
+#include "CommonProfiler.h"
+#include "TestUtils.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <fstream>
+#include <sstream>
+
+enum { NUM_THREADS = 4, SCOPES_PER_THREAD = 1000 };
+
+void timeScopes()
+{
+  for (int i = 0; i < SCOPES_PER_THREAD; ++i) {
+    ESS_PROFILE_SCOPE("ProfilerTest outer");
+    ESS_PROFILE_SCOPE("ProfilerTest inner");
+  }
+}
+
+// every thread exits before the report and the export look at its record
+void runThreads()
+{
+  boost::thread_group threads;
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    threads.create_thread(timeScopes);
+  }
+  threads.join_all();
+}
+
+// the number of spans in an exported trace
+size_t exportedSpans()
+{
+  const char* fileName = "ProfilerTest.json";
+  TESTING_ASSERT(Profiling::exportTrace(fileName));
+
+  std::ifstream file(fileName);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string json = contents.str();
+  TESTING_ASSERT(json.find("\"traceEvents\"") != std::string::npos);
+
+  size_t count = 0;
+  for (size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos;
+       pos = json.find("\"ph\":\"X\"", pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+void testTraceIsOptIn()
+{
+  Profiling::setTraceEnabled(false);
+  runThreads();
+  TESTING_ASSERT(exportedSpans() == 0);
+}
+
+void testExitedThreadsAreExported()
+{
+  Profiling::setTraceEnabled(true);
+  TESTING_ASSERT(Profiling::isTraceEnabled());
+  runThreads();
+  Profiling::setTraceEnabled(false);
+
+  // the spans of the exited threads are kept until the next export only
+  TESTING_ASSERT(exportedSpans() == 2 * NUM_THREADS * SCOPES_PER_THREAD);
+  TESTING_ASSERT(exportedSpans() == 0);
+}
+
+void testReportAfterExit()
+{
+  // the stats of the exited threads are merged into the report, which logs
+  // them, and cleared by it
+  runThreads();
+  Profiling::generateReport();
+  Profiling::reset();
+}
+
+void benchmark(int count)
+{
+  double start = getTestTime();
+  for (int i = 0; i < count; ++i) {
+    ESS_PROFILE_SCOPE("ProfilerTest benchmark");
+  }
+  const double statsTime = getTestTime() - start;
+
+  Profiling::setTraceEnabled(true);
+  start = getTestTime();
+  for (int i = 0; i < count; ++i) {
+    ESS_PROFILE_SCOPE("ProfilerTest benchmark");
+  }
+  const double traceTime = getTestTime() - start;
+  Profiling::setTraceEnabled(false);
+  Profiling::reset();
+
+  printf("%d scopes: %.1fns each, %.1fns each while tracing\n", count,
+         statsTime / count * 1e9, traceTime / count * 1e9);
+}
+
+int main(int argc, char* argv[])
+{
+  testTraceIsOptIn();
+  testExitedThreadsAreExported();
+  testReportAfterExit();
+
+  // the number of scopes to time can be given on the command line
+  benchmark(argc > 1 ? atoi(argv[1]) : 100000);
+  return 0;
+}
@@ -0,0 +1,216 @@
+#include "CommonAlembic.h"
+#include "CommonSamplePrefetcher.h"
+#include "CommonUtilities.h"
+#include "TestUtils.h"
+
+#include <boost/thread/thread.hpp>
+
+// the default of EXOCORTEX_ALEMBIC_PREFETCH_SAMPLES
+const int kMaxSamples = 8;
+const int kNumSamples = 64;
+const int kNumPoints = 100;
+const size_t kSampleBytes = kNumPoints * sizeof(Imath::V3f);
+const char* kArchiveName = "samplePrefetcherTest.abc";
+
+// every point of sample i is (i, i, i)
+void writeArchive()
+{
+  Abc::OArchive archive(Alembic::AbcCoreOgawa::WriteArchive(), kArchiveName);
+  Abc::OP3fArrayProperty positions(archive.getTop().getProperties(), "P");
+  std::vector<Imath::V3f> points(kNumPoints);
+  for (int i = 0; i < kNumSamples; ++i) {
+    std::fill(points.begin(), points.end(), Imath::V3f((float)i));
+    positions.set(Abc::P3fArraySample(points));
+  }
+}
+
+boost::shared_ptr<P3fArraySampleCache> newCache(size_t numSamples)
+{
+  return boost::shared_ptr<P3fArraySampleCache>(
+      new P3fArraySampleCache(numSamples * kSampleBytes));
+}
+
+bool isCached(boost::shared_ptr<P3fArraySampleCache> const& cache,
+              std::string const& name, int index)
+{
+  return cache->contains(SampleCacheKey(name, index));
+}
+
+// the reads happen on other threads, gives them a few seconds
+void waitForSamples(boost::shared_ptr<P3fArraySampleCache> const& cache,
+                    std::string const& name, int first, int step, int count)
+{
+  for (int tries = 0; tries < 500; ++tries) {
+    bool done = true;
+    for (int i = 0; i < count && done; ++i) {
+      done = isCached(cache, name, first + step * i);
+    }
+    if (done) {
+      break;
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  }
+  for (int i = 0; i < count; ++i) {
+    TESTING_ASSERT(isCached(cache, name, first + step * i));
+  }
+  // whatever else was queued would have been read meanwhile
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+}
+
+void checkSample(boost::shared_ptr<P3fArraySampleCache> const& cache,
+                 std::string const& name, int index)
+{
+  Abc::P3fArraySamplePtr sample;
+  TESTING_ASSERT(cache->get(SampleCacheKey(name, index), sample));
+  TESTING_ASSERT(sample->size() == (size_t)kNumPoints);
+  TESTING_ASSERT((*sample)[kNumPoints - 1] == Imath::V3f((float)index));
+}
+
+void prefetch(boost::shared_ptr<P3fArraySampleCache> const& cache,
+              std::string const& name, Abc::IP3fArrayProperty const& positions,
+              int index)
+{
+  SamplePrefetcher::prefetchPositions(cache, name, positions, index,
+                                      kSampleBytes);
+}
+
+void testForward(Abc::IP3fArrayProperty const& positions)
+{
+  boost::shared_ptr<P3fArraySampleCache> cache = newCache(64);
+  prefetch(cache, "/forward", positions, 0);
+  waitForSamples(cache, "/forward", 1, 1, kMaxSamples);
+  TESTING_ASSERT(!isCached(cache, "/forward", kMaxSamples + 1));
+  TESTING_ASSERT(!isCached(cache, "/forward", 0));
+  checkSample(cache, "/forward", kMaxSamples);
+
+  // stops at the last sample
+  prefetch(cache, "/forward", positions, kNumSamples - 3);
+  waitForSamples(cache, "/forward", kNumSamples - 2, 1, 2);
+}
+
+void testDirectionChanges(Abc::IP3fArrayProperty const& positions)
+{
+  // playing backwards
+  boost::shared_ptr<P3fArraySampleCache> cache = newCache(64);
+  prefetch(cache, "/backward", positions, 40);
+  prefetch(cache, "/backward", positions, 39);
+  waitForSamples(cache, "/backward", 38, -1, kMaxSamples);
+  TESTING_ASSERT(!isCached(cache, "/backward", 38 - kMaxSamples));
+  checkSample(cache, "/backward", 31);
+
+  // every other sample
+  cache = newCache(64);
+  prefetch(cache, "/fast", positions, 0);
+  prefetch(cache, "/fast", positions, 2);
+  waitForSamples(cache, "/fast", 4, 2, kMaxSamples);
+  TESTING_ASSERT(!isCached(cache, "/fast", 9));
+  TESTING_ASSERT(!isCached(cache, "/fast", 4 + 2 * kMaxSamples));
+
+  // and forward again
+  prefetch(cache, "/fast", positions, 30);
+  prefetch(cache, "/fast", positions, 31);
+  waitForSamples(cache, "/fast", 32, 1, kMaxSamples);
+}
+
+void testScrubbing(Abc::IP3fArrayProperty const& positions)
+{
+  boost::shared_ptr<P3fArraySampleCache> cache = newCache(64);
+  prefetch(cache, "/scrub", positions, 20);
+  prefetch(cache, "/scrub", positions, 19);
+  waitForSamples(cache, "/scrub", 18, -1, kMaxSamples);
+
+  // a jump further than the prefetch distance keeps playing backwards
+  prefetch(cache, "/scrub", positions, 50);
+  waitForSamples(cache, "/scrub", 49, -1, kMaxSamples);
+  TESTING_ASSERT(!isCached(cache, "/scrub", 51));
+
+  // and so does a jump back to an earlier frame
+  prefetch(cache, "/scrub", positions, 5);
+  waitForSamples(cache, "/scrub", 4, -1, 5);
+  TESTING_ASSERT(!isCached(cache, "/scrub", 6));
+}
+
+void testBudget(Abc::IP3fArrayProperty const& positions)
+{
+  // half of the budget is for prefetching, split between the streams
+  boost::shared_ptr<P3fArraySampleCache> cache = newCache(6);
+  prefetch(cache, "/budget", positions, 0);
+  waitForSamples(cache, "/budget", 1, 1, 3);
+  TESTING_ASSERT(!isCached(cache, "/budget", 4));
+
+  prefetch(cache, "/budget2", positions, 10);
+  waitForSamples(cache, "/budget2", 11, 1, 1);
+  TESTING_ASSERT(!isCached(cache, "/budget2", 12));
+  TESTING_ASSERT(cache->getStats().usage <= cache->getStats().budget);
+
+  // with room for a single sample nothing is prefetched
+  cache = newCache(1);
+  prefetch(cache, "/small", positions, 0);
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+  TESTING_ASSERT(cache->getStats().entries == 0);
+
+  SamplePrefetcher::cancelAll();
+}
+
+void testCancel(Abc::IP3fArrayProperty const& positions)
+{
+  boost::shared_ptr<P3fArraySampleCache> cache = newCache(64);
+  prefetch(cache, "/cancel", positions, 30);
+  prefetch(cache, "/cancel", positions, 29);
+  waitForSamples(cache, "/cancel", 28, -1, kMaxSamples);
+
+  // the stream is forgotten, it starts again playing forward
+  SamplePrefetcher::cancel(cache.get(), "/cancel");
+  prefetch(cache, "/cancel", positions, 10);
+  waitForSamples(cache, "/cancel", 11, 1, kMaxSamples);
+  TESTING_ASSERT(!isCached(cache, "/cancel", 9));
+
+  // other caches and names are separate streams
+  boost::shared_ptr<P3fArraySampleCache> other = newCache(64);
+  prefetch(cache, "/cancel", positions, 50);
+  prefetch(cache, "/cancel", positions, 49);
+  prefetch(other, "/cancel", positions, 40);
+  SamplePrefetcher::cancel(other.get(), "/cancel");
+  prefetch(cache, "/cancel", positions, 48);
+  waitForSamples(cache, "/cancel", 47, -1, kMaxSamples);
+}
+
+void testShutdown(Abc::IP3fArrayProperty const& positions)
+{
+  boost::shared_ptr<P3fArraySampleCache> cache = newCache(64);
+  for (int i = 0; i < 3; ++i) {
+    prefetch(cache, "/shutdown", positions, 0);
+    SamplePrefetcher::shutdown();
+
+    // the workers are gone, nothing gets read any more
+    const size_t entries = cache->getStats().entries;
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    TESTING_ASSERT(cache->getStats().entries == entries);
+    cache->clear();
+  }
+
+  // and they are started again
+  prefetch(cache, "/shutdown", positions, 0);
+  waitForSamples(cache, "/shutdown", 1, 1, kMaxSamples);
+}
+
+int main(int argc, char* argv[])
+{
+  writeArchive();
+  {
+    Abc::IArchive archive(Alembic::AbcCoreOgawa::ReadArchive(), kArchiveName);
+    Abc::IP3fArrayProperty positions(archive.getTop().getProperties(), "P");
+    TESTING_ASSERT(positions.getNumSamples() == (size_t)kNumSamples);
+
+    testForward(positions);
+    testDirectionChanges(positions);
+    testScrubbing(positions);
+    testBudget(positions);
+    testCancel(positions);
+    testShutdown(positions);
+    SamplePrefetcher::shutdown();
+  }
+  remove(kArchiveName);
+  printf("SamplePrefetcher tests passed\n");
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include "TestUtils.h"
+#include "CommonAlembic.h"
+#include "CommonUtilities.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+double getTestTime()
+{
+  static const boost::posix_time::ptime start =
+      boost::posix_time::microsec_clock::universal_time();
+  const boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - start;
+  return (double)elapsed.total_microseconds() * 1e-6;
+}
+
+// the logging and path hooks are normally provided by the host plugin
+
+void logError(const char* msg) { fprintf(stderr, "%s\n", msg); }
+void logWarning(const char* msg) { fprintf(stderr, "%s\n", msg); }
+void logInfo(const char* msg) {}
+
+std::string resolvePath_Internal(std::string const& path) { return path; }
@@ -0,0 +1,20 @@
+#ifndef __COMMON_UTILS_TEST_UTILS_H__
+#define __COMMON_UTILS_TEST_UTILS_H__
+
+#include <cstdio>
+#include <cstdlib>
+
+// the tests are also built in release, where assert() is compiled out
+#define TESTING_ASSERT(TEST)                                              \
+  do {                                                                    \
+    if (!(TEST)) {                                                        \
+      fprintf(stderr, "%s:%d: TESTING_ASSERT failed: %s\n", __FILE__,     \
+              __LINE__, #TEST);                                           \
+      exit(1);                                                            \
+    }                                                                     \
+  } while (0)
+
+// wall clock time in seconds, for the timings the tests print
+double getTestTime();
+
+#endif  // __COMMON_UTILS_TEST_UTILS_H__
@@ -42,7 +42,40 @@ namespace AbcCoreAbstract {
 namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
-ArraySample::Key ArraySample::getKey() const
+std::string GetArraySampleHashTypeName( ArraySampleHashType iHashType )
+{
+    return iHashType == kChunkedMurmur3Hash ? "ChunkedMurmur3" : "Murmur3";
+}
+
+//-*****************************************************************************
+ArraySampleHashType
+GetArraySampleHashType( const MetaData &iArchiveMetaData )
+{
+    if ( iArchiveMetaData.get( kArraySampleHashTypeKey ) ==
+         GetArraySampleHashTypeName( kChunkedMurmur3Hash ) )
+    {
+        return kChunkedMurmur3Hash;
+    }
+    return kMurmur3Hash;
+}
+
+//-*****************************************************************************
+static void HashBytes( const void * iData, size_t iNumBytes, size_t iPodSize,
+                       ArraySampleHashType iHashType, Util::Digest & oDigest )
+{
+    if ( iHashType == kChunkedMurmur3Hash )
+    {
+        ChunkedMurmurHash3_x64_128( iData, iNumBytes, iPodSize,
+                                    oDigest.words );
+    }
+    else
+    {
+        MurmurHash3_x64_128( iData, iNumBytes, iPodSize, oDigest.words );
+    }
+}
+
+//-*****************************************************************************
+ArraySample::Key ArraySample::getKey( ArraySampleHashType iHashType ) const
 {
 
     // Depending on data type, loop over everything.
@@ -70,61 +103,74 @@ ArraySample::Key ArraySample::getKey() const
     case kFloat32POD:
     case kFloat64POD:
     {
-        MurmurHash3_x64_128( m_data, numBytes, PODNumBytes(m_dataType.getPod()),
-            k.digest.words );
+        HashBytes( m_data, numBytes, PODNumBytes( m_dataType.getPod() ),
+                   iHashType, k.digest );
     }
     break;
 
     case kStringPOD:
     {
-        std::vector <int8_t> v;
+        const std::string * strs = static_cast<const std::string*>( m_data );
+
+        // size it up front, with a 0 for the NULL seperator character
+        size_t numChars = numPods;
         for ( size_t j = 0; j < numPods; ++j )
         {
-            const std::string &str =
-                static_cast<const std::string*>( m_data )[j];
+            numChars += strs[j].length();
+        }
 
-            size_t strLen = str.length();
-            for ( size_t k = 0; k < strLen; ++k )
+        std::vector <int8_t> v( numChars );
+        size_t pos = 0;
+        for ( size_t j = 0; j < numPods; ++j )
+        {
+            size_t strLen = strs[j].length();
+            if ( strLen > 0 )
             {
-                v.push_back(str[k]);
+                memcpy( &v[pos], strs[j].data(), strLen );
             }
-
-            // append a 0 for the NULL seperator character
-            v.push_back(0);
+            pos += strLen + 1;
         }
 
         int8_t * vptr = NULL;
         if ( !v.empty() )
             vptr = &(v.front());
 
-        MurmurHash3_x64_128( vptr, v.size(), sizeof(int8_t), k.digest.words );
+        HashBytes( vptr, v.size(), sizeof(int8_t), iHashType, k.digest );
     }
     break;
 
     case kWstringPOD:
     {
-        std::vector <int32_t> v;
+        const std::wstring * wstrs =
+            static_cast<const std::wstring*>( m_data );
+
+        // size it up front, with a 0 for the NULL seperator character
+        size_t numChars = numPods;
         for ( size_t j = 0; j < numPods; ++j )
         {
-            const std::wstring &wstr =
-                static_cast<const std::wstring*>( m_data )[j];
+            numChars += wstrs[j].length();
+        }
 
-            std::vector <int32_t> v(wstr.length());
+        // wchar_t differs in size between platforms, so widen to 32 bits
+        std::vector <int32_t> v( numChars );
+        size_t pos = 0;
+        for ( size_t j = 0; j < numPods; ++j )
+        {
+            const std::wstring &wstr = wstrs[j];
             size_t wlen = wstr.length();
-            for (size_t k = 0; k < wlen; ++k)
+            for ( size_t c = 0; c < wlen; ++c )
             {
-                v[k] = wstr[k];
+                v[pos++] = wstr[c];
             }
-
-            // append a 0 for the NULL seperator character
-            v.push_back(0);
+            ++pos;
         }
 
         int32_t * vptr = NULL;
         if ( !v.empty() )
             vptr = &(v.front());
 
-        MurmurHash3_x64_128( vptr, v.size(), sizeof(int32_t), k.digest.words );
+        HashBytes( vptr, v.size() * sizeof(int32_t), sizeof(int32_t),
+                   iHashType, k.digest );
     }
     break;
 
@@ -40,11 +40,41 @@
 #include <Alembic/AbcCoreAbstract/Foundation.h>
 #include <Alembic/AbcCoreAbstract/ArraySampleKey.h>
 #include <Alembic/AbcCoreAbstract/DataType.h>
+#include <Alembic/AbcCoreAbstract/MetaData.h>
 
 namespace Alembic {
 namespace AbcCoreAbstract {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+//! How ArraySample::getKey hashes the data.
+//! kMurmur3Hash is the single threaded MurmurHash3 Alembic has always used.
+//! kChunkedMurmur3Hash gives the same keys for samples up to 1 MB, larger
+//! ones are hashed in 1 MB pieces on multiple threads, which gives different
+//! keys for the same data.  Within an archive only one of them should be used
+//! so that identical samples are still shared.
+//! Keys of different hash types must not be compared: readers look up the
+//! hash type of an archive with GetArraySampleHashType.
+enum ArraySampleHashType
+{
+    kMurmur3Hash,
+    kChunkedMurmur3Hash
+};
+
+//-*****************************************************************************
+//! Ogawa archives written with kChunkedMurmur3Hash store "ChunkedMurmur3"
+//! under this key of their archive metadata.  Archives without it, including
+//! every archive written before the key existed, use kMurmur3Hash.
+static const char * kArraySampleHashTypeKey = "_ai_ArraySampleHashType";
+
+//! The value stored under kArraySampleHashTypeKey for iHashType,
+//! "Murmur3" or "ChunkedMurmur3".
+std::string GetArraySampleHashTypeName( ArraySampleHashType iHashType );
+
+//! The hash type of the array sample keys of an archive, given its metadata.
+ArraySampleHashType
+GetArraySampleHashType( const MetaData &iArchiveMetaData );
+
 //-*****************************************************************************
 //! The ArraySample class is a reference to a block of memory corresponding
 //! to an array of instances of DataTypes. The array may be multi-rank, with
@@ -99,7 +129,7 @@ public:
 
     //! Compute the Key.
     //! This is a calculation.
-    Key getKey() const;
+    Key getKey( ArraySampleHashType iHashType = kMurmur3Hash ) const;
 
     //! Return if it is valid.
     //! An empty ArraySample is valid.
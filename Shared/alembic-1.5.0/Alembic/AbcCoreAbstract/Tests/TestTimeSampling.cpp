@@ -40,6 +40,7 @@
 
 #include <float.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include <ImathMath.h>
 #include <ImathRandom.h>
@@ -54,6 +55,27 @@ using AbcA::index_t;
 
 typedef std::vector<chrono_t> TimeVector;
 
+//-*****************************************************************************
+// getFloorAndCeilIndex must give the same answers as the separate calls
+void testFloorAndCeil( const AbcA::TimeSampling &timeSampling,
+                       chrono_t iTime, index_t numSamples )
+{
+    std::pair<index_t, chrono_t> floorPair;
+    std::pair<index_t, chrono_t> ceilPair;
+    timeSampling.getFloorAndCeilIndex( iTime, numSamples, floorPair,
+                                       ceilPair );
+
+    std::stringstream msg;
+    msg << "getFloorAndCeilIndex( " << iTime << " ) is ( " <<
+        floorPair.first << ", " << ceilPair.first << " ). It should be ( " <<
+        timeSampling.getFloorIndex( iTime, numSamples ).first << ", " <<
+        timeSampling.getCeilIndex( iTime, numSamples ).first << " )";
+    TESTING_MESSAGE_ASSERT(
+        floorPair == timeSampling.getFloorIndex( iTime, numSamples ) &&
+        ceilPair == timeSampling.getCeilIndex( iTime, numSamples ),
+        msg.str() );
+}
+
 //-*****************************************************************************
 void validateTimeSampling( const AbcA::TimeSampling &timeSampling,
                            const AbcA::TimeSamplingType &timeSamplingType,
@@ -183,6 +205,8 @@ void testTimeSampling( const AbcA::TimeSampling &timeSampling,
             ". It should be " << i;
         TESTING_MESSAGE_ASSERT( nearIndex == i, nearMsg.str() );
 
+        testFloorAndCeil( timeSampling, timeI, numSamples );
+
         if ( i > 0 )
         {
             chrono_t timeIm1 = timeSampling.getSampleTime( i - 1 );
@@ -197,6 +221,9 @@ void testTimeSampling( const AbcA::TimeSampling &timeSampling,
                 chrono_t smidgeOverTimeI = timeI + smidgeOver;
                 chrono_t smidgeUnderTimeI = timeI - smidgeUnder;
 
+                testFloorAndCeil( timeSampling, smidgeOverTimeI, numSamples );
+                testFloorAndCeil( timeSampling, smidgeUnderTimeI, numSamples );
+
                 // floor index
                 TESTING_MESSAGE_ASSERT(
                     timeSampling.getFloorIndex( smidgeOverTimeI,
@@ -547,6 +574,120 @@ void testAcyclicTime3()
     testTimeSampling( tSamp, tSampTyp, numSamps );
 }
 
+//-*****************************************************************************
+// the lookup getFloorIndex did before it used a binary search
+index_t linearFloorIndex( const TimeVector &tvec, chrono_t iTime )
+{
+    index_t idx = 0;
+    while ( idx + 1 < ( index_t )tvec.size() && tvec[idx + 1] <= iTime )
+    {
+        ++idx;
+    }
+    return idx;
+}
+
+//-*****************************************************************************
+void testLargeAcyclicTime()
+{
+    TimeVector tvec;
+
+    // a sub frame cache, 100k samples with random spacing
+    const size_t numSamps = 100000;
+
+    chrono_t ranTime = 0.0;
+    Imath::srand48( numSamps );
+
+    for ( size_t i = 0 ; i < numSamps ; ++i )
+    {
+        ranTime += 0.001 + Imath::drand48() * 0.01;
+        tvec.push_back( ranTime );
+    }
+
+    const AbcA::TimeSamplingType tSampTyp( AbcA::TimeSamplingType::kAcyclic );
+    const AbcA::TimeSampling tSamp( tSampTyp, tvec );
+
+    std::cout << "Testing large acyclic time" << std::endl;
+
+    // the samples themselves and a random time in between each of them
+    TimeVector queries;
+    for ( size_t i = 0 ; i < numSamps ; ++i )
+    {
+        queries.push_back( tvec[i] );
+        if ( i + 1 < numSamps )
+        {
+            queries.push_back( tvec[i] +
+                ( tvec[i + 1] - tvec[i] ) * ( 0.1 + Imath::drand48() * 0.8 ) );
+        }
+    }
+
+    for ( size_t i = 0 ; i < queries.size() ; ++i )
+    {
+        const index_t expected = linearFloorIndex( tvec, queries[i] );
+        std::pair<index_t, chrono_t> floorPair;
+        std::pair<index_t, chrono_t> ceilPair;
+        tSamp.getFloorAndCeilIndex( queries[i], numSamps, floorPair,
+                                    ceilPair );
+
+        TESTING_MESSAGE_ASSERT( floorPair.first == ( index_t )( i / 2 ) &&
+            ( i % 2 == 1 || ceilPair.first == ( index_t )( i / 2 ) ) &&
+            ( i % 2 == 0 || ceilPair.first == ( index_t )( i / 2 + 1 ) ),
+            "Wrong floor or ceiling index in large acyclic sampling." );
+
+        if ( i % 1000 == 0 )
+        {
+            TESTING_MESSAGE_ASSERT( floorPair.first == expected,
+                "Binary search differs from the linear search." );
+            testFloorAndCeil( tSamp, queries[i], numSamps );
+        }
+    }
+
+    // microbenchmark, the linear search only runs on a subset of the
+    // queries, it takes seconds otherwise
+    const size_t numLinear = 1000;
+    index_t checksum = 0;
+    clock_t start = clock();
+    for ( size_t i = 0 ; i < numLinear ; ++i )
+    {
+        const chrono_t t = queries[( i * 7919 ) % queries.size()];
+        const index_t floorIndex = linearFloorIndex( tvec, t );
+        checksum += floorIndex + std::min( floorIndex + 1,
+                                           ( index_t )numSamps - 1 );
+    }
+    const double linearTime =
+        ( double )( clock() - start ) / CLOCKS_PER_SEC / numLinear;
+
+    start = clock();
+    for ( size_t i = 0 ; i < queries.size() ; ++i )
+    {
+        checksum += tSamp.getFloorIndex( queries[i], numSamps ).first +
+            tSamp.getCeilIndex( queries[i], numSamps ).first;
+    }
+    const double separateTime =
+        ( double )( clock() - start ) / CLOCKS_PER_SEC / queries.size();
+
+    start = clock();
+    for ( size_t i = 0 ; i < queries.size() ; ++i )
+    {
+        std::pair<index_t, chrono_t> floorPair;
+        std::pair<index_t, chrono_t> ceilPair;
+        tSamp.getFloorAndCeilIndex( queries[i], numSamps, floorPair,
+                                    ceilPair );
+        checksum += floorPair.first + ceilPair.first;
+    }
+    const double fusedTime =
+        ( double )( clock() - start ) / CLOCKS_PER_SEC / queries.size();
+
+    std::cout << "Lookups over " << numSamps << " acyclic samples, "
+              << "in nanoseconds per query:" << std::endl
+              << "  linear floor and ceiling: " << linearTime * 1e9
+              << std::endl
+              << "  getFloorIndex + getCeilIndex: " << separateTime * 1e9
+              << std::endl
+              << "  getFloorAndCeilIndex: " << fusedTime * 1e9
+              << std::endl
+              << "  (checksum " << checksum << ")" << std::endl << std::endl;
+}
+
 //-*****************************************************************************
 void testBadTypes()
 {
@@ -602,6 +743,7 @@ int main( int, char** )
     testAcyclicTime1();
     testAcyclicTime2();
     testAcyclicTime3();
+    testLargeAcyclicTime();
 
     // make sure these bad types throw
     testBadTypes();
@@ -178,36 +178,24 @@ TimeSampling::getFloorIndex( chrono_t iTime, index_t iNumSamples ) const
 
     if ( m_timeSamplingType.isAcyclic() )
     {
-        // For now, just loop since we need the index and time
-        // Later, use binary search of sorted array.
-
+        // The sample times are sorted, so binary search for the first
+        // time greater than us, the one before it is less than or
+        // equal to us.
         assert( iTime >= minTime );
-        chrono_t prevTime = minTime;
-        index_t numSamples = m_sampleTimes.size();
+        const size_t numSamples = std::min( ( size_t )iNumSamples,
+                                             m_sampleTimes.size() );
+        std::vector<chrono_t>::const_iterator it = std::upper_bound(
+            m_sampleTimes.begin(), m_sampleTimes.begin() + numSamples, iTime );
 
-        for ( index_t idx = 1; idx < numSamples; ++idx )
+        // We should have picked up the end on maxTime.
+        if ( it == m_sampleTimes.begin() + numSamples )
         {
-            chrono_t thisTime = m_sampleTimes[idx];
-            assert( iTime >= prevTime );
-            if ( iTime < thisTime )
-            {
-                // Okay, tIdx is greater than us.
-                // iIdx-1 is less than or equal to us.
-                // Yes, inefficient here too, will optimize later.
-                return std::pair<index_t, chrono_t>( idx-1,
-                                                     prevTime );
-            }
-
-            prevTime = thisTime;
+            ABCA_THROW( "Corrupt acyclic time samples, iTime = "
+                        << iTime << ", maxTime = " << maxTime );
         }
 
-        // Dang, we got all the way to the end, and no thing was ever
-        // greater than us.
-        // This is troublesome, because we should have picked it up
-        // on maxTime.
-        ABCA_THROW( "Corrupt acyclic time samples, iTime = "
-                    << iTime << ", maxTime = " << maxTime );
-        return std::pair<index_t, chrono_t>( m_sampleTimes.size()-1, maxTime );
+        const index_t idx = ( it - m_sampleTimes.begin() ) - 1;
+        return std::pair<index_t, chrono_t>( idx, m_sampleTimes[idx] );
     }
     else if ( m_timeSamplingType.isUniform() )
     {
@@ -267,20 +255,11 @@ TimeSampling::getFloorIndex( chrono_t iTime, index_t iNumSamples ) const
         assert( rem < period + minTime );
         const size_t cycleBlockIndex = N * numCycles;
 
-        index_t sampIdx = 0;
-
-        for ( index_t i = 0 ; i < ( index_t )N ; ++i )
-        {
-            chrono_t sampleTime = m_sampleTimes[i];
-
-            if ( sampleTime > rem )
-            {
-                sampIdx = i - 1;
-                break;
-            }
-
-            sampIdx = i;
-        }
+        // The last sample of the cycle that is <= rem.
+        index_t sampIdx = ( std::upper_bound( m_sampleTimes.begin(),
+                                              m_sampleTimes.begin() + N,
+                                              rem ) -
+                            m_sampleTimes.begin() ) - 1;
 
         if ( sampIdx < 0 ) { sampIdx = 0; }
 
@@ -343,6 +322,63 @@ TimeSampling::getCeilIndex( chrono_t iTime, index_t iNumSamples ) const
                                maxIndex );
 }
 
+//-*****************************************************************************
+void TimeSampling::getFloorAndCeilIndex( chrono_t iTime, index_t iNumSamples,
+                                         std::pair<index_t, chrono_t> & oFloor,
+                                         std::pair<index_t, chrono_t> & oCeil )
+    const
+{
+    oFloor = this->getFloorIndex( iTime, iNumSamples );
+
+    // The rest mirrors getCeilIndex.
+    if ( iNumSamples < 1 )
+    {
+        oCeil = std::pair<index_t, chrono_t>( 0, 0.0 );
+        return;
+    }
+
+    iTime -= kCHRONO_EPSILON;
+
+    const index_t _maxind = iNumSamples - 1;
+    const size_t maxIndex = _maxind > -1 ? _maxind : 0;
+
+    const chrono_t minTime = this->getSampleTime( 0 );
+    if ( iTime <= minTime )
+    {
+        oCeil = std::pair<index_t, chrono_t>( 0, minTime );
+        return;
+    }
+
+    const chrono_t maxTime = this->getSampleTime( maxIndex );
+    if ( iTime >= maxTime )
+    {
+        oCeil = std::pair<index_t, chrono_t>( maxIndex, maxTime );
+        return;
+    }
+
+    std::pair<index_t, chrono_t> floorPair;
+    if ( m_timeSamplingType.isAcyclic() )
+    {
+        // getCeilIndex looks for the floor of a time a couple of epsilons
+        // before ours, it is at most a few samples before oFloor, so walk
+        // back instead of searching again.
+        const chrono_t floorTime = iTime + kCHRONO_EPSILON;
+        index_t idx = oFloor.first;
+        while ( idx > 0 && m_sampleTimes[idx] > floorTime )
+        {
+            --idx;
+        }
+        floorPair = std::pair<index_t, chrono_t>( idx, m_sampleTimes[idx] );
+    }
+    else
+    {
+        floorPair = this->getFloorIndex( iTime, iNumSamples );
+    }
+
+    oCeil = getCeilIndexHelper( this, iTime, floorPair.first,
+                                floorPair.second, maxIndex );
+}
+
 //-*****************************************************************************
 std::pair<index_t, chrono_t>
 TimeSampling::getNearIndex( chrono_t iTime, index_t iNumSamples ) const
@@ -368,10 +404,9 @@ TimeSampling::getNearIndex( chrono_t iTime, index_t iNumSamples ) const
         return std::pair<index_t, chrono_t>( maxIndex, maxTime );
     }
 
-    std::pair<index_t, chrono_t> floorPair =
-        this->getFloorIndex( iTime, iNumSamples );
-    std::pair<index_t, chrono_t> ceilPair =
-        this->getCeilIndex( iTime, iNumSamples );
+    std::pair<index_t, chrono_t> floorPair;
+    std::pair<index_t, chrono_t> ceilPair;
+    this->getFloorAndCeilIndex( iTime, iNumSamples, floorPair, ceilPair );
 
     assert( ( floorPair.second <= iTime ||
               Imath::equalWithAbsError( iTime, floorPair.second,
@@ -116,6 +116,12 @@ public:
     std::pair<index_t, chrono_t> getCeilIndex( chrono_t iTime, 
         index_t iNumSamples ) const;
 
+    //! Same results as getFloorIndex and getCeilIndex, but only searches
+    //! the sample times once. Invalid to call this with zero samples.
+    void getFloorAndCeilIndex( chrono_t iTime, index_t iNumSamples,
+                               std::pair<index_t, chrono_t> & oFloor,
+                               std::pair<index_t, chrono_t> & oCeil ) const;
+
     //! Find the valid index with the closest time to the given
     //! time. Invalid to call this with zero samples.
     std::pair<index_t, chrono_t> getNearIndex( chrono_t iTime,
@@ -46,6 +46,7 @@ IFactory::IFactory()
 {
     m_cacheHierarchy = true;
     m_numStreams = 1;
+    m_readStrategy = kFileStreams;
     m_policy = Alembic::Abc::ErrorHandler::kThrowPolicy;
 }
 
@@ -58,7 +59,8 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
 {
 
     // try Ogawa first, use kQuietNoop at first in case we fail
-    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams );
+    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams,
+        m_readStrategy == kMemoryMappedFiles );
     Alembic::Abc::IArchive archive( ogawa, iFileName,
         Alembic::Abc::ErrorHandler::kQuietNoopPolicy, m_cachePtr );
 
@@ -58,6 +58,18 @@ public:
         kUnknown
     };
 
+    //! How an Ogawa file is read
+    enum OgawaReadStrategy
+    {
+        //! Open the file getOgawaNumStreams() times as ifstreams, each read
+        //! locks the stream it uses
+        kFileStreams,
+
+        //! Memory map the file, reads are lock free copies out of the
+        //! mapping and suitably aligned array samples point directly into it
+        kMemoryMappedFiles
+    };
+
     //! Try to open a file and set oType to the one that yields a successful
     //! oType, or kUnknown if the IArchive isn't valid
     Alembic::Abc::IArchive getArchive( const std::string & iFileName,
@@ -83,7 +95,9 @@ public:
     //! Gets whether an HDF5 file will use the cached hierarchy
     bool getHDF5CacheHierarchy() const { return m_cacheHierarchy; }
 
-    //! Set the array sample cache, the HDF5 implementation optionally uses this
+    //! Set the array sample cache, both implementations use it to share array
+    //! samples, AbcCoreOgawa::CreateCache makes a thread safe one with a
+    //! byte budget
     void setSampleCache(
         Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCachePtr )
     {
@@ -107,6 +121,15 @@ public:
         m_numStreams = iNumStreams;
     }
 
+    //! Gets how Ogawa files will be read
+    OgawaReadStrategy getOgawaReadStrategy() const { return m_readStrategy; }
+
+    //! Sets how Ogawa files will be read, the default is kFileStreams
+    void setOgawaReadStrategy( OgawaReadStrategy iStrategy )
+    {
+        m_readStrategy = iStrategy;
+    }
+
     //! Gets the error handler policy
     Alembic::Abc::ErrorHandler::Policy getPolicy() { return m_policy; }
 
@@ -119,6 +142,7 @@ public:
 private:
     bool m_cacheHierarchy;
     size_t m_numStreams;
+    OgawaReadStrategy m_readStrategy;
     Alembic::AbcCoreAbstract::ReadArraySampleCachePtr m_cachePtr;
     Alembic::Abc::ErrorHandler::Policy m_policy;
 
@@ -111,7 +111,50 @@ void AprImpl::getSample( index_t iSampleIndex, AbcA::ArraySamplePtr &oSample )
     Ogawa::IDataPtr dims = m_group->getData(index + 1, id);
     Ogawa::IDataPtr data = m_group->getData(index, id);
 
-    ReadArraySample( dims, data, id, m_header->header.getDataType(), oSample );
+    const AbcA::DataType & dataType = m_header->header.getDataType();
+    AbcA::ReadArraySampleCachePtr cache =
+        getObject()->getArchive()->getReadArraySampleCachePtr();
+
+    // empty samples have no key, and aren't worth caching anyway
+    if ( !cache || !data || data->getSize() <= 16 )
+    {
+        ReadArraySample( dims, data, id, dataType, oSample );
+        return;
+    }
+
+    AbcA::ArraySampleKey key;
+    key.readPOD = dataType.getPod();
+    key.origPOD = key.readPOD;
+    key.numBytes = data->getSize() - 16;
+    data->read( 16, key.digest.d, 0, id );
+
+    // the key doesn't know about the extent or the dimensions, so make sure
+    // a sample stored by another property really has the same shape
+    AbcA::ReadArraySampleID found = cache->find( key );
+    if ( found )
+    {
+        Util::Dimensions foundDims;
+        ReadDimensions( dims, data, id, dataType, foundDims );
+        if ( found.getSample()->getDataType() == dataType &&
+             found.getSample()->getDimensions() == foundDims )
+        {
+            oSample = found.getSample();
+            return;
+        }
+    }
+
+    ReadArraySample( dims, data, id, dataType, oSample );
+
+    // share what another thread may have stored in the meantime
+    if ( !found )
+    {
+        AbcA::ArraySamplePtr stored = cache->store( key, oSample ).getSample();
+        if ( stored->getDataType() == dataType &&
+             stored->getDimensions() == oSample->getDimensions() )
+        {
+            oSample = stored;
+        }
+    }
 }
 
 //-*****************************************************************************
@@ -45,11 +45,13 @@ namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 ArImpl::ArImpl( const std::string &iFileName,
-                std::size_t iNumStreams )
+                std::size_t iNumStreams,
+                bool iUseMMap )
   : m_fileName( iFileName )
-  , m_archive( iFileName, iNumStreams )
+  , m_archive( iFileName, iNumStreams, iUseMMap )
   , m_header( new AbcA::ObjectHeader() )
-  , m_manager( iNumStreams )
+  // reads from a mapped file don't need a stream of their own
+  , m_manager( m_archive.isMapped() ? 1 : iNumStreams )
 {
     ABCA_ASSERT( m_archive.isValid(),
                  "Could not open as Ogawa file: " << m_fileName );
@@ -155,6 +157,8 @@ const AbcA::MetaData &ArImpl::getMetaData() const
 //-*****************************************************************************
 AbcA::ObjectReaderPtr ArImpl::getTop()
 {
+    Alembic::Util::scoped_lock l( m_orphanedTopMutex );
+
     AbcA::ObjectReaderPtr ret = m_top.lock();
     if ( ! ret )
     {
@@ -199,6 +203,12 @@ StreamIDPtr ArImpl::getStreamID()
     return m_manager.get();
 }
 
+//-*****************************************************************************
+void ArImpl::getStreamStats( StreamStats & oStats ) const
+{
+    m_manager.getStats( oStats );
+}
+
 //-*****************************************************************************
 ArImpl::~ArImpl()
 {
@@ -56,7 +56,7 @@ private:
     friend struct ReadArchive;
 
     ArImpl( const std::string &iFileName,
-            size_t iNumStreams=1 );
+            size_t iNumStreams=1, bool iUseMMap=false );
 
     ArImpl( const std::vector< std::istream * > & iStreams );
 
@@ -79,12 +79,13 @@ public:
 
     virtual AbcA::ReadArraySampleCachePtr getReadArraySampleCachePtr()
     {
-        return AbcA::ReadArraySampleCachePtr();
+        return m_cachePtr;
     }
 
     virtual void
     setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr )
     {
+        m_cachePtr = iPtr;
     }
 
     virtual AbcA::index_t getMaxNumSamplesForTimeSamplingIndex(
@@ -102,6 +103,8 @@ public:
 
     StreamIDPtr getStreamID();
 
+    void getStreamStats( StreamStats & oStats ) const;
+
     const std::vector< AbcA::MetaData > & getIndexedMetaData();
 
 private:
@@ -112,6 +115,7 @@ private:
 
     Ogawa::IArchive m_archive;
 
+    Alembic::Util::mutex m_orphanedTopMutex;
     Alembic::Util::weak_ptr< AbcA::ObjectReader > m_top;
     Alembic::Util::shared_ptr < OrData > m_data;
 
@@ -124,6 +128,8 @@ private:
 
     StreamManager m_manager;
 
+    AbcA::ReadArraySampleCachePtr m_cachePtr;
+
     std::vector< AbcA::MetaData > m_indexMetaData;
 };
 
@@ -45,11 +45,14 @@ namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 AwImpl::AwImpl( const std::string &iFileName,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                size_t iAsyncBufferSize,
+                AbcA::ArraySampleHashType iHashType )
   : m_fileName( iFileName )
   , m_metaData( iMetaData )
-  , m_archive( iFileName )
+  , m_archive( iFileName, iAsyncBufferSize )
   , m_metaDataMap( new MetaDataMap() )
+  , m_hashType( iHashType )
 {
 
     // add default time sampling
@@ -67,10 +70,12 @@ AwImpl::AwImpl( const std::string &iFileName,
 
 //-*****************************************************************************
 AwImpl::AwImpl( std::ostream * iStream,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                AbcA::ArraySampleHashType iHashType )
   : m_metaData( iMetaData )
   , m_archive( iStream )
   , m_metaDataMap( new MetaDataMap() )
+  , m_hashType( iHashType )
 {
     // add default time sampling
     AbcA::TimeSamplingPtr ts( new AbcA::TimeSampling() );
@@ -102,6 +107,15 @@ void AwImpl::init()
 
     m_metaData.set("_ai_AlembicVersion", AbcA::GetLibraryVersion());
 
+    // readers need the hash type to compare the keys of the array samples,
+    // metadata copied from another archive may name a different one
+    if ( m_hashType != AbcA::kMurmur3Hash ||
+         !m_metaData.get( AbcA::kArraySampleHashTypeKey ).empty() )
+    {
+        m_metaData.set( AbcA::kArraySampleHashTypeKey,
+                        AbcA::GetArraySampleHashTypeName( m_hashType ) );
+    }
+
     m_data.reset( new OwData( m_archive.getGroup()->addGroup() ) );
 
     // seed with the common empty keys
@@ -218,36 +232,50 @@ AwImpl::~AwImpl()
     // empty out the map so any dataset IDs will be freed up
     m_writtenSampleMap.clear();
 
-    // write out our child headers
-    if ( m_data )
+    // a destructor can't throw, so a failed write is reported here instead
+    // of leaving a silently truncated file behind
+    try
     {
-        Util::SpookyHash hash;
-        m_data->writeHeaders( m_metaDataMap, hash );
-    }
+        // write out our child headers
+        if ( m_data )
+        {
+            Util::SpookyHash hash;
+            m_data->writeHeaders( m_metaDataMap, hash );
+        }
 
-    // let go of our reference to the data for the top object
-    m_data.reset();
+        // let go of our reference to the data for the top object
+        m_data.reset();
 
-    // encode and write the time samplings and max samples into data
-    if ( m_archive.isValid() )
-    {
-        // encode and write the Metadata for the archive, since the top level
-        // meta data can be kinda big and is very specialized don't worry
-        // about putting it into the meta data map
-        std::string metaData = m_metaData.serialize();
-        m_archive.getGroup()->addData( metaData.size(), metaData.c_str() );
-
-        std::vector< Util::uint8_t > data;
-        Util::uint32_t numSamplings = getNumTimeSamplings();
-        for ( Util::uint32_t i = 0; i < numSamplings; ++i )
+        // encode and write the time samplings and max samples into data
+        if ( m_archive.isValid() )
         {
-            Util::uint32_t maxSample = m_maxSamples[i];
-            AbcA::TimeSamplingPtr timePtr = getTimeSampling( i );
-            WriteTimeSampling( data, maxSample, *timePtr );
+            // encode and write the Metadata for the archive, since the top
+            // level meta data can be kinda big and is very specialized don't
+            // worry about putting it into the meta data map
+            std::string metaData = m_metaData.serialize();
+            m_archive.getGroup()->addData( metaData.size(),
+                                           metaData.c_str() );
+
+            std::vector< Util::uint8_t > data;
+            Util::uint32_t numSamplings = getNumTimeSamplings();
+            for ( Util::uint32_t i = 0; i < numSamplings; ++i )
+            {
+                Util::uint32_t maxSample = m_maxSamples[i];
+                AbcA::TimeSamplingPtr timePtr = getTimeSampling( i );
+                WriteTimeSampling( data, maxSample, *timePtr );
+            }
+
+            m_archive.getGroup()->addData( data.size(), &( data.front() ) );
+            m_metaDataMap->write( m_archive.getGroup() );
+
+            // wait for the pending writes and mark the file as complete
+            m_archive.close();
         }
-
-        m_archive.getGroup()->addData( data.size(), &( data.front() ) );
-        m_metaDataMap->write( m_archive.getGroup() );
+    }
+    catch ( std::exception & e )
+    {
+        std::cerr << "Alembic: could not finish writing " << m_fileName
+                  << ": " << e.what() << std::endl;
     }
 
 }
@@ -57,10 +57,13 @@ private:
     friend struct WriteArchive;
 
     AwImpl( const std::string &iFileName,
-            const AbcA::MetaData &iMetaData );
+            const AbcA::MetaData &iMetaData,
+            size_t iAsyncBufferSize = 0,
+            AbcA::ArraySampleHashType iHashType = AbcA::kMurmur3Hash );
 
     AwImpl( std::ostream * iStream,
-            const AbcA::MetaData & iMetaData );
+            const AbcA::MetaData & iMetaData,
+            AbcA::ArraySampleHashType iHashType = AbcA::kMurmur3Hash );
 
 public:
     virtual ~AwImpl();
@@ -89,6 +92,11 @@ public:
         return m_metaDataMap;
     }
 
+    AbcA::ArraySampleHashType getArraySampleHashType() const
+    {
+        return m_hashType;
+    }
+
     virtual Util::uint32_t addTimeSampling( const AbcA::TimeSampling & iTs );
 
     virtual AbcA::TimeSamplingPtr getTimeSampling( Util::uint32_t iIndex );
@@ -117,6 +125,7 @@ private:
 
     WrittenSampleMap m_writtenSampleMap;
     MetaDataMapPtr m_metaDataMap;
+    AbcA::ArraySampleHashType m_hashType;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -0,0 +1,170 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+#include <Alembic/AbcCoreOgawa/CacheImpl.h>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+CacheImpl::CacheImpl( std::size_t iMaxBytes, std::size_t iNumShards )
+{
+    if ( iNumShards == 0 )
+    {
+        iNumShards = 1;
+    }
+
+    m_maxBytes = iMaxBytes;
+    m_shardBytes = iMaxBytes / iNumShards;
+
+    m_shards.resize( iNumShards );
+    for ( std::size_t i = 0; i < iNumShards; ++i )
+    {
+        m_shards[i] = new Shard();
+    }
+}
+
+//-*****************************************************************************
+CacheImpl::~CacheImpl()
+{
+    for ( std::size_t i = 0; i < m_shards.size(); ++i )
+    {
+        delete m_shards[i];
+    }
+}
+
+//-*****************************************************************************
+CacheImpl::Shard & CacheImpl::getShard( const AbcA::ArraySample::Key &iKey )
+{
+    // the maps hash on the first 64 bits of the digest, so pick the shard
+    // from the last ones
+    return *m_shards[ iKey.digest.words[1] % m_shards.size() ];
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+CacheImpl::find( const AbcA::ArraySample::Key &iKey )
+{
+    Shard & shard = getShard( iKey );
+    Alembic::Util::scoped_lock l( shard.lock );
+
+    Map::iterator found = shard.map.find( iKey );
+    if ( found == shard.map.end() )
+    {
+        shard.misses++;
+        return AbcA::ReadArraySampleID();
+    }
+
+    shard.hits++;
+
+    // move it to the front of the list
+    shard.entries.splice( shard.entries.begin(), shard.entries,
+                          found->second );
+
+    return AbcA::ReadArraySampleID( iKey, found->second->sample );
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+CacheImpl::store( const AbcA::ArraySample::Key &iKey,
+                  AbcA::ArraySamplePtr iSamp )
+{
+    ABCA_ASSERT( iSamp, "Cannot store a null sample" );
+
+    Shard & shard = getShard( iKey );
+    Alembic::Util::scoped_lock l( shard.lock );
+
+    // somebody else already stored the same data, share theirs
+    Map::iterator found = shard.map.find( iKey );
+    if ( found != shard.map.end() )
+    {
+        shard.entries.splice( shard.entries.begin(), shard.entries,
+                              found->second );
+        return AbcA::ReadArraySampleID( iKey, found->second->sample );
+    }
+
+    Entry entry;
+    entry.key = iKey;
+    entry.sample = iSamp;
+    entry.numBytes = iKey.numBytes;
+
+    // bigger than the whole shard, don't evict everything else for it
+    if ( entry.numBytes > m_shardBytes )
+    {
+        return AbcA::ReadArraySampleID( iKey, iSamp );
+    }
+
+    shard.entries.push_front( entry );
+    shard.map[iKey] = shard.entries.begin();
+    shard.numBytes += entry.numBytes;
+
+    while ( shard.numBytes > m_shardBytes )
+    {
+        Entry & oldest = shard.entries.back();
+        shard.numBytes -= oldest.numBytes;
+        shard.map.erase( oldest.key );
+        shard.entries.pop_back();
+        shard.evictions++;
+    }
+
+    return AbcA::ReadArraySampleID( iKey, iSamp );
+}
+
+//-*****************************************************************************
+void CacheImpl::getStats( CacheStats & oStats )
+{
+    oStats.maxBytes = m_maxBytes;
+    oStats.numBytes = 0;
+    oStats.numSamples = 0;
+    oStats.hits = 0;
+    oStats.misses = 0;
+    oStats.evictions = 0;
+
+    for ( std::size_t i = 0; i < m_shards.size(); ++i )
+    {
+        Shard & shard = *m_shards[i];
+        Alembic::Util::scoped_lock l( shard.lock );
+        oStats.numBytes += shard.numBytes;
+        oStats.numSamples += shard.map.size();
+        oStats.hits += shard.hits;
+        oStats.misses += shard.misses;
+        oStats.evictions += shard.evictions;
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
@@ -0,0 +1,113 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+#ifndef _Alembic_AbcCoreOgawa_CacheImpl_h_
+#define _Alembic_AbcCoreOgawa_CacheImpl_h_
+
+#include <Alembic/AbcCoreOgawa/Foundation.h>
+#include <Alembic/AbcCoreOgawa/ReadWrite.h>
+
+#include <list>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A thread safe array sample cache with a byte budget.
+//! Samples are keyed by their digest, so identical samples read from
+//! different properties, or different archives sharing the cache, are
+//! stored once.  The keys are spread over shards, each with its own lock and
+//! least recently used list, and each shard evicts its oldest samples once
+//! it holds more than its share of the budget.  Evicted samples stay alive
+//! for as long as somebody else still holds them.
+class CacheImpl : public AbcA::ReadArraySampleCache
+{
+public:
+    CacheImpl( std::size_t iMaxBytes, std::size_t iNumShards );
+
+    virtual ~CacheImpl();
+
+    virtual AbcA::ReadArraySampleID
+    find( const AbcA::ArraySample::Key &iKey );
+
+    virtual AbcA::ReadArraySampleID
+    store( const AbcA::ArraySample::Key &iKey,
+           AbcA::ArraySamplePtr iSamp );
+
+    void getStats( CacheStats & oStats );
+
+private:
+    struct Entry
+    {
+        AbcA::ArraySample::Key key;
+        AbcA::ArraySamplePtr sample;
+        Alembic::Util::uint64_t numBytes;
+    };
+
+    typedef std::list< Entry > EntryList;
+    typedef AbcA::UnorderedMapUtil< EntryList::iterator >::umap_type Map;
+
+    struct Shard
+    {
+        Shard() : numBytes( 0 ), hits( 0 ), misses( 0 ), evictions( 0 ) {}
+
+        Alembic::Util::mutex lock;
+
+        // most recently used first
+        EntryList entries;
+        Map map;
+
+        Alembic::Util::uint64_t numBytes;
+        Alembic::Util::uint64_t hits;
+        Alembic::Util::uint64_t misses;
+        Alembic::Util::uint64_t evictions;
+    };
+
+    Shard & getShard( const AbcA::ArraySample::Key &iKey );
+
+    std::size_t m_maxBytes;
+    std::size_t m_shardBytes;
+    std::vector< Shard * > m_shards;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
+
+#endif
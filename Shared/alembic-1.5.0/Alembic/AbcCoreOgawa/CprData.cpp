@@ -51,6 +51,7 @@ CprData::CprData( Ogawa::IGroupPtr iGroup,
                   std::size_t iThreadId,
                   AbcA::ArchiveReader & iArchive,
                   const std::vector< AbcA::MetaData > & iIndexedMetaData )
+    : m_subPropertyMutexes( NULL )
 {
     ABCA_ASSERT( iGroup, "invalid compound data group" );
 
@@ -65,6 +66,7 @@ CprData::CprData( Ogawa::IGroupPtr iGroup,
                              iArchive, iIndexedMetaData, headers );
 
         m_propertyHeaders.resize( headers.size() );
+        m_subPropertyMutexes = new Alembic::Util::mutex[ headers.size() ];
         for ( std::size_t i = 0; i < headers.size(); ++i )
         {
             m_subProperties[headers[i]->header.getName()] = i;
@@ -76,6 +78,7 @@ CprData::CprData( Ogawa::IGroupPtr iGroup,
 //-*****************************************************************************
 CprData::~CprData()
 {
+    delete[] m_subPropertyMutexes;
 }
 
 //-*****************************************************************************
@@ -135,6 +138,8 @@ CprData::getScalarProperty( AbcA::CompoundPropertyReaderPtr iParent,
                     << sub.header->header.getPropertyType() );
     }
 
+    Alembic::Util::scoped_lock l( m_subPropertyMutexes[fiter->second] );
+
     AbcA::BasePropertyReaderPtr bptr = sub.made.lock();
     if ( ! bptr )
     {
@@ -180,6 +185,8 @@ CprData::getArrayProperty( AbcA::CompoundPropertyReaderPtr iParent,
                     << sub.header->header.getPropertyType() );
     }
 
+    Alembic::Util::scoped_lock l( m_subPropertyMutexes[fiter->second] );
+
     AbcA::BasePropertyReaderPtr bptr = sub.made.lock();
     if ( ! bptr )
     {
@@ -226,6 +233,8 @@ CprData::getCompoundProperty( AbcA::CompoundPropertyReaderPtr iParent,
                     << sub.header->header.getPropertyType() );
     }
 
+    Alembic::Util::scoped_lock l( m_subPropertyMutexes[fiter->second] );
+
     AbcA::BasePropertyReaderPtr bptr = sub.made.lock();
     if ( ! bptr )
     {
@@ -92,6 +92,9 @@ private:
 
     SubPropertyVec m_propertyHeaders;
     SubPropertiesMap m_subProperties;
+
+    // Allocated mutexes, one per SubProperty
+    Alembic::Util::mutex * m_subPropertyMutexes;
 };
 
 typedef Alembic::Util::shared_ptr<CprData> CprDataPtr;
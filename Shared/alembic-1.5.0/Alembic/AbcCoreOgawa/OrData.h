@@ -84,6 +84,10 @@ private:
 
     Ogawa::IGroupPtr m_group;
 
+    // Guards the lazily made children and top property, the headers are
+    // filled by the ctor and are multithread safe.
+    Alembic::Util::mutex m_childObjectsMutex;
+
     struct Child
     {
         ObjectHeaderPtr header;
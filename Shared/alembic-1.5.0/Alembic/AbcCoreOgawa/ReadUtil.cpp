@@ -1410,6 +1410,21 @@ ReadData( void * iIntoLocation,
 
 }
 
+//-*****************************************************************************
+// Deletes an ArraySample which aliases mapped memory, holding on to the IData
+// keeps the mapping alive for as long as the sample is.
+struct MappedArraySampleDeleter
+{
+    MappedArraySampleDeleter( Ogawa::IDataPtr iData ) : data( iData ) {}
+
+    void operator()( AbcA::ArraySample * iSample )
+    {
+        delete iSample;
+    }
+
+    Ogawa::IDataPtr data;
+};
+
 //-*****************************************************************************
 void
 ReadArraySample( Ogawa::IDataPtr iDims,
@@ -1422,6 +1437,23 @@ ReadArraySample( Ogawa::IDataPtr iDims,
     Util::Dimensions dims;
     ReadDimensions( iDims, iData, iThreadId, iDataType, dims );
 
+    // when the archive is memory mapped and the data is suitably aligned the
+    // sample can point straight into the mapping instead of being copied
+    Util::PlainOldDataType pod = iDataType.getPod();
+    if ( pod != Util::kStringPOD && pod != Util::kWstringPOD &&
+         dims.numPoints() > 0 &&
+         iData->getSize() == 16 + dims.numPoints() * iDataType.getNumBytes() )
+    {
+        const void * mapped = iData->getMappedData( iData->getSize() - 16, 16 );
+        if ( mapped &&
+             reinterpret_cast< std::size_t >( mapped ) % PODNumBytes( pod ) == 0 )
+        {
+            oSample.reset( new AbcA::ArraySample( mapped, iDataType, dims ),
+                           MappedArraySampleDeleter( iData ) );
+            return;
+        }
+    }
+
     oSample = AbcA::AllocateArraySample( iDataType, dims );
 
     ReadData( const_cast<void*>( oSample->getData() ), iData,
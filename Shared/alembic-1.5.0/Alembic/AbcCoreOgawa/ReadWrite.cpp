@@ -38,6 +38,7 @@
 #include <Alembic/AbcCoreOgawa/Foundation.h>
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
 #include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/CacheImpl.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -46,6 +47,16 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 WriteArchive::WriteArchive()
 {
+    m_asyncBufferSize = 0;
+    m_hashType = AbcA::kMurmur3Hash;
+}
+
+//-*****************************************************************************
+WriteArchive::WriteArchive( size_t iAsyncBufferSize,
+                            AbcA::ArraySampleHashType iHashType )
+{
+    m_asyncBufferSize = iAsyncBufferSize;
+    m_hashType = iHashType;
 }
 
 //-*****************************************************************************
@@ -53,7 +64,9 @@ AbcA::ArchiveWriterPtr
 WriteArchive::operator()( const std::string &iFileName,
                           const AbcA::MetaData &iMetaData ) const
 {
-    AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iFileName, iMetaData ) );
+    AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iFileName, iMetaData,
+                                                     m_asyncBufferSize,
+                                                     m_hashType ) );
     return archivePtr;
 }
 
@@ -62,25 +75,37 @@ AbcA::ArchiveWriterPtr
 WriteArchive::operator()( std::ostream * iStream,
                           const AbcA::MetaData &iMetaData ) const
 {
-    AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iStream, iMetaData ) );
+    AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iStream, iMetaData,
+                                                     m_hashType ) );
     return archivePtr;
 }
 
+//-*****************************************************************************
+AbcA::ReadArraySampleCachePtr
+CreateCache( size_t iMaxBytes, size_t iNumShards )
+{
+    AbcA::ReadArraySampleCachePtr cachePtr(
+        new CacheImpl( iMaxBytes, iNumShards ) );
+    return cachePtr;
+}
+
 //-*****************************************************************************
 ReadArchive::ReadArchive()
 {
     m_numStreams = 1;
+    m_useMMap = false;
 }
 
 //-*****************************************************************************
-ReadArchive::ReadArchive( size_t iNumStreams )
+ReadArchive::ReadArchive( size_t iNumStreams, bool iUseMMap )
 {
     m_numStreams = iNumStreams;
+    m_useMMap = iUseMMap;
 }
 
 //-*****************************************************************************
 ReadArchive::ReadArchive( const std::vector< std::istream * > & iStreams )
-    : m_numStreams( 1 ), m_streams( iStreams )
+    : m_numStreams( 1 ), m_useMMap( false ), m_streams( iStreams )
 {
 }
 
@@ -93,7 +118,8 @@ ReadArchive::operator()( const std::string &iFileName ) const
     if ( m_streams.empty() )
     {
         archivePtr =
-            AbcA::ArchiveReaderPtr( new ArImpl( iFileName, m_numStreams ) );
+            AbcA::ArchiveReaderPtr( new ArImpl( iFileName, m_numStreams,
+                                                m_useMMap ) );
     }
     else
     {
@@ -104,7 +130,6 @@ ReadArchive::operator()( const std::string &iFileName ) const
 }
 
 //-*****************************************************************************
-// The given cache is ignored.
 AbcA::ArchiveReaderPtr
 ReadArchive::operator()( const std::string &iFileName,
             AbcA::ReadArraySampleCachePtr iCache ) const
@@ -114,16 +139,52 @@ ReadArchive::operator()( const std::string &iFileName,
     if ( m_streams.empty() )
     {
         archivePtr =
-            AbcA::ArchiveReaderPtr( new ArImpl( iFileName, m_numStreams ) );
+            AbcA::ArchiveReaderPtr( new ArImpl( iFileName, m_numStreams,
+                                                m_useMMap ) );
     }
     else
     {
         archivePtr =
             AbcA::ArchiveReaderPtr( new ArImpl( m_streams ) );
     }
+
+    archivePtr->setReadArraySampleCachePtr( iCache );
     return archivePtr;
 }
 
+//-*****************************************************************************
+bool GetStreamStats( AbcA::ArchiveReaderPtr iArchive, StreamStats & oStats )
+{
+    Alembic::Util::shared_ptr< ArImpl > archive =
+        Alembic::Util::dynamic_pointer_cast< ArImpl, AbcA::ArchiveReader >(
+            iArchive );
+
+    if ( !archive )
+    {
+        return false;
+    }
+
+    archive->getStreamStats( oStats );
+    return true;
+}
+
+//-*****************************************************************************
+bool GetCacheStats( AbcA::ReadArraySampleCachePtr iCache,
+                    CacheStats & oStats )
+{
+    Alembic::Util::shared_ptr< CacheImpl > cache =
+        Alembic::Util::dynamic_pointer_cast< CacheImpl,
+            AbcA::ReadArraySampleCache >( iCache );
+
+    if ( !cache )
+    {
+        return false;
+    }
+
+    cache->getStats( oStats );
+    return true;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreOgawa
 } // End namespace Alembic
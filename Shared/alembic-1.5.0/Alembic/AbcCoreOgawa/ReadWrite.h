@@ -50,6 +50,16 @@ class WriteArchive
 public:
     WriteArchive();
 
+    //! iAsyncBufferSize, when not 0, is the size of the two buffers archives
+    //! written to a file are collected in while a background thread writes
+    //! them out. The resulting file is the same as with a 0 size.
+    //! iHashType is how array samples are hashed to find the ones which
+    //! were already written.  Archives not using kMurmur3Hash record it in
+    //! their metadata, see AbcCoreAbstract::kArraySampleHashTypeKey.
+    explicit WriteArchive( size_t iAsyncBufferSize,
+        ::Alembic::AbcCoreAbstract::ArraySampleHashType iHashType =
+            ::Alembic::AbcCoreAbstract::kMurmur3Hash );
+
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( const std::string &iFileName,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData ) const;
@@ -57,18 +67,35 @@ public:
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( std::ostream * iStream,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData ) const;
+
+private:
+    size_t m_asyncBufferSize;
+    ::Alembic::AbcCoreAbstract::ArraySampleHashType m_hashType;
 };
 
+//-*****************************************************************************
+//! AbcCoreOgawa provides a thread safe array sample cache which holds at most
+//! iMaxBytes of samples, split over iNumShards independently locked shards,
+//! and drops the least recently used samples first.  Samples are keyed by
+//! their digest, so identical data is only kept once, unless it is larger
+//! than 1 MB and comes from archives with different array sample hash types.
+//! Ogawa archives only cache array samples when given a cache, it can be
+//! shared by several archives.
+::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr
+CreateCache( size_t iMaxBytes = 256 * 1024 * 1024, size_t iNumShards = 16 );
+
 //-*****************************************************************************
 //! Will return a shared pointer to the archive reader
-//! This version creates a cache associated with the archive.
+//! Array samples are only cached if a cache is passed in.
 class ReadArchive
 {
 public:
     ReadArchive();
 
-    // Open the file iNumStreams times and manage them internally
-    ReadArchive( size_t iNumStreams );
+    // Open the file iNumStreams times and manage them internally, or if
+    // iUseMMap is true memory map the file once and let any number of
+    // threads read from the mapping without locking
+    ReadArchive( size_t iNumStreams, bool iUseMMap=false );
 
     // Read from the provided streams, we do not own these, expect them
     // to remain open and all have the same data in them, and do not try to
@@ -79,7 +106,7 @@ public:
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName ) const;
 
-    // The given cache is ignored.
+    // open the file, array samples are looked up in and stored to iCache
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName,
                 ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache
@@ -87,9 +114,64 @@ public:
 
 private:
     size_t m_numStreams;
+    bool m_useMMap;
     std::vector< std::istream * > m_streams;
 };
 
+//-*****************************************************************************
+//! How the streams of an Ogawa archive reader have been handed out to the
+//! reading threads
+struct StreamStats
+{
+    //! number of streams the archive was opened with
+    size_t numStreams;
+
+    //! number of times a stream was leased to a thread
+    Alembic::Util::uint64_t numLeases;
+
+    //! number of times a thread already holding a stream used it again
+    //! instead of leasing another one
+    Alembic::Util::uint64_t numReused;
+
+    //! number of times every stream was busy and a thread had to wait
+    Alembic::Util::uint64_t numWaits;
+
+    //! total time in seconds threads spent waiting for a stream
+    double waitTime;
+};
+
+//! Fills in oStats for an archive opened with ReadArchive, returns false if
+//! iArchive isn't an Ogawa archive.  Archives opened with a single stream,
+//! or memory mapped, don't lease streams and report zero for everything
+//! but numStreams.
+bool GetStreamStats( ::Alembic::AbcCoreAbstract::ArchiveReaderPtr iArchive,
+                     StreamStats & oStats );
+
+//-*****************************************************************************
+//! How well a cache made by CreateCache is doing
+struct CacheStats
+{
+    //! the byte budget the cache was created with
+    Alembic::Util::uint64_t maxBytes;
+
+    //! bytes of sample data currently held by the cache
+    Alembic::Util::uint64_t numBytes;
+
+    //! number of samples currently held by the cache
+    Alembic::Util::uint64_t numSamples;
+
+    //! number of lookups which found their sample, and which didn't
+    Alembic::Util::uint64_t hits;
+    Alembic::Util::uint64_t misses;
+
+    //! number of samples dropped to stay within the budget
+    Alembic::Util::uint64_t evictions;
+};
+
+//! Fills in oStats, returns false if iCache wasn't made by CreateCache
+bool GetCacheStats( ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache,
+                    CacheStats & oStats );
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
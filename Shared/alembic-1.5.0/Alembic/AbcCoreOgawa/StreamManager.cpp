@@ -36,150 +36,284 @@
 
 #include <Alembic/AbcCoreOgawa/StreamManager.h>
 
+#ifndef _MSC_VER
+#include <sys/time.h>
+#endif
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
-StreamManager::StreamManager( std::size_t iNumStreams )
+namespace {
+
+//-*****************************************************************************
+#ifdef _MSC_VER
+
+#define ALEMBIC_THREAD_LOCAL __declspec( thread )
+
+bool compareAndSwap( volatile Alembic::Util::uint64_t * iPtr,
+                     Alembic::Util::uint64_t iOld,
+                     Alembic::Util::uint64_t iNew )
+{
+    return InterlockedCompareExchange64( ( volatile LONGLONG * ) iPtr,
+        ( LONGLONG ) iNew, ( LONGLONG ) iOld ) == ( LONGLONG ) iOld;
+}
+
+Alembic::Util::int64_t atomicAdd( volatile Alembic::Util::int64_t * iPtr,
+                                  Alembic::Util::int64_t iVal )
+{
+    return InterlockedExchangeAdd64( ( volatile LONGLONG * ) iPtr, iVal );
+}
+
+std::size_t lowestBit( Alembic::Util::uint64_t iVal )
+{
+    std::size_t bit = 0;
+    while ( ( iVal & 1 ) == 0 )
+    {
+        iVal >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+// microseconds from an arbitrary start
+Alembic::Util::int64_t now()
+{
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &count );
+    return ( Alembic::Util::int64_t )
+        ( double( count.QuadPart ) * 1e6 / double( freq.QuadPart ) );
+}
+
+#else
+
+#define ALEMBIC_THREAD_LOCAL __thread
+
+bool compareAndSwap( volatile Alembic::Util::uint64_t * iPtr,
+                     Alembic::Util::uint64_t iOld,
+                     Alembic::Util::uint64_t iNew )
+{
+    return __sync_bool_compare_and_swap( iPtr, iOld, iNew );
+}
+
+Alembic::Util::int64_t atomicAdd( volatile Alembic::Util::int64_t * iPtr,
+                                  Alembic::Util::int64_t iVal )
+{
+    return __sync_fetch_and_add( iPtr, iVal );
+}
+
+std::size_t lowestBit( Alembic::Util::uint64_t iVal )
+{
+    return __builtin_ctzll( iVal );
+}
+
+// microseconds from an arbitrary start
+Alembic::Util::int64_t now()
+{
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return Alembic::Util::int64_t( tv.tv_sec ) * 1000000 + tv.tv_usec;
+}
+
+#endif
+
+//-*****************************************************************************
+// the stream the current thread holds, and the one it used last
+struct ThreadLease
 {
+    const StreamManager * manager;
+    std::size_t streamID;
+    std::size_t lastStreamID;
+};
 
-    m_streams = 0;
-    m_curStream = 0;
+ALEMBIC_THREAD_LOCAL ThreadLease gLease = { NULL, 0, 0 };
+
+}
+
+//-*****************************************************************************
+StreamManager::StreamManager( std::size_t iNumStreams )
+{
     m_numStreams = iNumStreams;
+    m_waiters = 0;
+    m_numLeases = 0;
+    m_numReused = 0;
+    m_numWaits = 0;
+    m_waitTime = 0;
 
     // only do this if we have more than 1 stream
     // otherwise we can just return default
-    if ( iNumStreams > 1 )
+    if ( m_numStreams > 1 )
     {
-        m_streamIDs.resize( m_numStreams );
-        for ( std::size_t i = 0; i < m_numStreams; ++i )
+        m_free.resize( ( m_numStreams + 63 ) / 64,
+                       ~Alembic::Util::uint64_t( 0 ) );
+        if ( m_numStreams % 64 != 0 )
         {
-            m_streamIDs[i] = i;
-            if ( m_numStreams < sizeof(m_streams) * 8 )
-            {
-                m_streams |= 1 << i;
-            }
+            m_free.back() =
+                ( Alembic::Util::uint64_t( 1 ) << ( m_numStreams % 64 ) ) - 1;
         }
     }
 
+#ifdef _MSC_VER
+    m_available = CreateSemaphore( NULL, 0, LONG_MAX, NULL );
+#else
+    pthread_mutex_init( &m_waitLock, NULL );
+    pthread_cond_init( &m_available, NULL );
+#endif
+
     m_default = StreamIDPtr( new StreamID( NULL, 0 ) );
 }
 
+//-*****************************************************************************
 StreamManager::~StreamManager()
 {
+#ifdef _MSC_VER
+    CloseHandle( m_available );
+#else
+    pthread_cond_destroy( &m_available );
+    pthread_mutex_destroy( &m_waitLock );
+#endif
 }
 
-#if !defined(__APPLE__) && defined(__GNUC__) && __GNUC__ > 3
+//-*****************************************************************************
+bool StreamManager::tryGet( std::size_t iHint, std::size_t & oStreamID )
+{
+    std::size_t numWords = m_free.size();
+    std::size_t start = iHint / 64;
+    for ( std::size_t i = 0; i < numWords; ++i )
+    {
+        std::size_t word = ( start + i ) % numWords;
+        volatile Alembic::Util::uint64_t * ptr = &m_free[word];
 
+        Alembic::Util::uint64_t oldVal = *ptr;
+        while ( oldVal != 0 )
+        {
+            // prefer the hinted stream, then the lowest free one
+            Alembic::Util::uint64_t hintBit =
+                Alembic::Util::uint64_t( 1 ) << ( iHint % 64 );
+            std::size_t bit = ( i == 0 && ( oldVal & hintBit ) ) ?
+                iHint % 64 : lowestBit( oldVal );
+
+            Alembic::Util::uint64_t newVal =
+                oldVal & ~( Alembic::Util::uint64_t( 1 ) << bit );
+            if ( compareAndSwap( ptr, oldVal, newVal ) )
+            {
+                oStreamID = word * 64 + bit;
+                return true;
+            }
+            oldVal = *ptr;
+        }
+    }
+    return false;
+}
+
+//-*****************************************************************************
 StreamIDPtr StreamManager::get()
 {
-
     if ( m_numStreams < 2 )
     {
         return m_default;
     }
 
-    // we've got too many streams so use the locking version
-    if ( m_numStreams > sizeof(m_streams) * 8 )
+    // this thread is already reading from one of our streams further up the
+    // stack, keep using it, waiting for a second one could deadlock
+    if ( gLease.manager == this )
     {
-        Alembic::Util::scoped_lock l( m_lock );
+        atomicAdd( &m_numReused, 1 );
+        return StreamIDPtr( new StreamID( NULL, gLease.streamID ) );
+    }
+
+    std::size_t hint = gLease.lastStreamID % m_numStreams;
+    std::size_t id = 0;
+    if ( !tryGet( hint, id ) )
+    {
+        // every stream is busy, wait for one to come back
+        Alembic::Util::int64_t start = now();
+        atomicAdd( &m_numWaits, 1 );
 
-        // we've used up more than we have, just return the default
-        if ( m_curStream >= m_numStreams )
+#ifdef _MSC_VER
+        atomicAdd( &m_waiters, 1 );
+        while ( !tryGet( hint, id ) )
         {
-            return m_default;
+            WaitForSingleObject( m_available, INFINITE );
         }
+        atomicAdd( &m_waiters, -1 );
+#else
+        pthread_mutex_lock( &m_waitLock );
+        atomicAdd( &m_waiters, 1 );
+        while ( !tryGet( hint, id ) )
+        {
+            pthread_cond_wait( &m_available, &m_waitLock );
+        }
+        atomicAdd( &m_waiters, -1 );
+        pthread_mutex_unlock( &m_waitLock );
+#endif
 
-        return StreamIDPtr( new StreamID( this,
-            m_streamIDs[ m_curStream ++ ] ) );
+        atomicAdd( &m_waitTime, now() - start );
     }
 
-    // CAS (compare and swap) non locking version
-    Alembic::Util::int64_t val = 0;
-    Alembic::Util::int64_t oldVal = 0;
-    Alembic::Util::int64_t newVal = 0;
+    atomicAdd( &m_numLeases, 1 );
 
-    do
+    // only remember the lease if we aren't holding one from another archive
+    if ( gLease.manager == NULL )
     {
-        oldVal = m_streams;
-        val = ffsll( oldVal );
-
-        if ( val == 0 )
-        {
-            return m_default;
-        }
-
-        newVal = oldVal & ~( 1 << (val - 1) );
+        gLease.manager = this;
+        gLease.streamID = id;
     }
-    while ( !__sync_bool_compare_and_swap( &m_streams, oldVal, newVal ) );
+    gLease.lastStreamID = id;
 
-    return StreamIDPtr( new StreamID( this, ( std::size_t ) val - 1 ) );
+    return StreamIDPtr( new StreamID( this, id ) );
 }
 
+//-*****************************************************************************
 void StreamManager::put( std::size_t iStreamID )
 {
-
-    // we've got too many streams so use the locking version
-    if ( m_numStreams > sizeof(m_streams) * 8 )
+    if ( gLease.manager == this && gLease.streamID == iStreamID )
     {
-        // shouldn't ever hit this case, it's why we have m_default
-        assert( iStreamID < m_numStreams && m_curStream > 0 );
-
-        Alembic::Util::scoped_lock l( m_lock );
-        m_streamIDs[ --m_curStream ] = iStreamID;
-        return;
+        gLease.manager = NULL;
     }
 
-    // CAS (compare and swap) non locking version
-    Alembic::Util::int64_t oldVal = 0;
-    Alembic::Util::int64_t newVal = 0;
-
+    volatile Alembic::Util::uint64_t * ptr = &m_free[ iStreamID / 64 ];
+    Alembic::Util::uint64_t bit =
+        Alembic::Util::uint64_t( 1 ) << ( iStreamID % 64 );
+    Alembic::Util::uint64_t oldVal = 0;
     do
     {
-        oldVal = m_streams;
-        newVal = oldVal | ( 1 << iStreamID );
-
+        oldVal = *ptr;
     }
-    while ( !__sync_bool_compare_and_swap( &m_streams, oldVal, newVal ) );
-}
-
-#else
+    while ( !compareAndSwap( ptr, oldVal, oldVal | bit ) );
 
-StreamIDPtr StreamManager::get()
-{
-    // no need to lock
-    if ( m_streamIDs.empty() )
+    // the swap above is a full barrier, so a waiter which missed this stream
+    // has already registered itself
+    if ( atomicAdd( &m_waiters, 0 ) > 0 )
     {
-        return m_default;
-    }
-
-    Alembic::Util::scoped_lock l( m_lock );
-
-    // we've used up more than we have, just return the default
-    if ( m_curStream >= m_numStreams )
-    {
-        return m_default;
+#ifdef _MSC_VER
+        ReleaseSemaphore( m_available, 1, NULL );
+#else
+        pthread_mutex_lock( &m_waitLock );
+        pthread_cond_signal( &m_available );
+        pthread_mutex_unlock( &m_waitLock );
+#endif
     }
-
-    return StreamIDPtr( new StreamID( this, m_streamIDs[ m_curStream ++ ] ) );
 }
 
-void StreamManager::put( std::size_t iStreamID )
+//-*****************************************************************************
+void StreamManager::getStats( StreamStats & oStats ) const
 {
-    // shouldn't ever hit this case, it's why we have m_default
-    assert( iStreamID < m_numStreams && m_curStream > 0 );
-
-    Alembic::Util::scoped_lock l( m_lock );
-    m_streamIDs[ --m_curStream ] = iStreamID;
+    oStats.numStreams = m_numStreams;
+    oStats.numLeases = atomicAdd( &m_numLeases, 0 );
+    oStats.numReused = atomicAdd( &m_numReused, 0 );
+    oStats.numWaits = atomicAdd( &m_numWaits, 0 );
+    oStats.waitTime = double( atomicAdd( &m_waitTime, 0 ) ) * 1e-6;
 }
 
-#endif
-
+//-*****************************************************************************
 StreamID::StreamID( StreamManager * iManager, std::size_t iStreamID ) :
     m_manager( iManager ), m_streamID( iStreamID )
 {
 }
 
+//-*****************************************************************************
 StreamID::~StreamID()
 {
     // if our manager is valid, give back our ID
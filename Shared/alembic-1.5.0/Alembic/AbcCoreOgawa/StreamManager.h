@@ -38,8 +38,13 @@
 #define _Alembic_AbcCoreOgawa_StreamManager_h_
 
 #include <Alembic/AbcCoreOgawa/Foundation.h>
+#include <Alembic/AbcCoreOgawa/ReadWrite.h>
 #include <Alembic/Util/Foundation.h>
 
+#ifndef _MSC_VER
+#include <pthread.h>
+#endif
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
@@ -48,25 +53,45 @@ class StreamID;
 typedef Alembic::Util::shared_ptr< StreamID > StreamIDPtr;
 
 //-*****************************************************************************
+// Leases the stream ids of an archive to the reading threads.
+// Free streams are kept in a bitmap of 64 bit words that is updated with
+// compare and swap, so any number of streams can be leased without locking.
+// A thread first tries the stream it used last, and a thread which already
+// holds a stream gets the same one back instead of leasing a second.
+// When every stream is busy the thread waits for one to be returned.
 class StreamManager : Alembic::Util::noncopyable
 {
 public:
     StreamManager( std::size_t iNumStreams );
     ~StreamManager();
     StreamIDPtr get();
+    void getStats( StreamStats & oStats ) const;
 private:
     friend class StreamID;
     void put( std::size_t iStreamID );
 
+    // takes a free stream, returns false if there isn't one
+    bool tryGet( std::size_t iHint, std::size_t & oStreamID );
+
     std::size_t m_numStreams;
 
-    // for the locked implementation
-    std::vector< std::size_t > m_streamIDs;
-    std::size_t m_curStream;
-    Alembic::Util::mutex m_lock;
+    // one bit per stream, set while the stream is free
+    std::vector< Alembic::Util::uint64_t > m_free;
+
+    // threads waiting for a stream to be returned
+    volatile Alembic::Util::int64_t m_waiters;
+#ifdef _MSC_VER
+    HANDLE m_available;
+#else
+    pthread_mutex_t m_waitLock;
+    pthread_cond_t m_available;
+#endif
 
-    // for the CAS impl
-    Alembic::Util::int64_t m_streams;
+    // counters, in microseconds for the wait time
+    mutable volatile Alembic::Util::int64_t m_numLeases;
+    mutable volatile Alembic::Util::int64_t m_numReused;
+    mutable volatile Alembic::Util::int64_t m_numWaits;
+    mutable volatile Alembic::Util::int64_t m_waitTime;
 
     StreamIDPtr m_default;
 };
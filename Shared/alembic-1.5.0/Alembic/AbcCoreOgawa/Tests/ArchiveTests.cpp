@@ -40,7 +40,9 @@
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <vector>
 
@@ -383,6 +385,80 @@ void readVeryEmptyArchive( const std::string & iName )
     TESTING_ASSERT(a->getTop()->getNumChildren() == 0);
 }
 
+//-*****************************************************************************
+void writeSamplesArchive( const std::string & iName, size_t iAsyncBufferSize )
+{
+    AO::WriteArchive w( iAsyncBufferSize );
+    ABCA::ArchiveWriterPtr a = w( iName, ABCA::MetaData() );
+    ABCA::ObjectWriterPtr top = a->getTop();
+
+    ABCA::DataType i32d( Alembic::Util::kInt32POD, 1 );
+    std::vector< Alembic::Util::int32_t > vals( 1000 );
+
+    for ( size_t i = 0; i < 10; ++i )
+    {
+        std::ostringstream strm;
+        strm << "obj" << i;
+        ABCA::ObjectWriterPtr obj = top->createChild(
+            ABCA::ObjectHeader( strm.str(), ABCA::MetaData() ) );
+
+        ABCA::ArrayPropertyWriterPtr awp =
+            obj->getProperties()->createArrayProperty( "a", ABCA::MetaData(),
+                                                       i32d, 0 );
+
+        for ( size_t j = 0; j < 20; ++j )
+        {
+            // every few samples repeat so some data gets shared
+            for ( size_t k = 0; k < vals.size(); ++k )
+            {
+                vals[k] = ( Alembic::Util::int32_t )( i * 100 + j % 7 + k );
+            }
+
+            Alembic::Util::Dimensions dims( vals.size() - j );
+            awp->setSample( ABCA::ArraySample( &vals.front(), i32d, dims ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+std::string readFile( const std::string & iName )
+{
+    std::ifstream strm( iName.c_str(), std::ios_base::binary );
+    return std::string( std::istreambuf_iterator< char >( strm ),
+                        std::istreambuf_iterator< char >() );
+}
+
+//-*****************************************************************************
+void testAsyncWrite()
+{
+    writeSamplesArchive( "syncWrite.abc", 0 );
+    std::string syncData = readFile( "syncWrite.abc" );
+    TESTING_ASSERT( !syncData.empty() );
+
+    // big enough to hold everything, and small enough that the buffers get
+    // handed off all the time and headers are patched after being written
+    size_t bufferSizes[] = { 64 * 1024 * 1024, 4096, 64 };
+    for ( size_t i = 0; i < 3; ++i )
+    {
+        writeSamplesArchive( "asyncWrite.abc", bufferSizes[i] );
+        TESTING_ASSERT( readFile( "asyncWrite.abc" ) == syncData );
+    }
+
+    Alembic::AbcCoreOgawa::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r( "asyncWrite.abc" );
+    TESTING_ASSERT( a->getTop()->getNumChildren() == 10 );
+
+    ABCA::ArrayPropertyReaderPtr ap =
+        a->getTop()->getChild( 9 )->getProperties()->getArrayProperty( "a" );
+    TESTING_ASSERT( ap->getNumSamples() == 20 );
+
+    ABCA::ArraySamplePtr samp;
+    ap->getSample( 19, samp );
+    TESTING_ASSERT( samp->getDimensions().numPoints() == 981 );
+    TESTING_ASSERT( ( ( const Alembic::Util::int32_t * )
+                      samp->getData() )[1] == 900 + 19 % 7 + 1 );
+}
+
 int main ( int argc, char *argv[] )
 {
     testReadWriteEmptyArchive();
@@ -401,5 +477,7 @@ int main ( int argc, char *argv[] )
 
     testReadWriteMaxNumSamplesArchive();
 
+    testAsyncWrite();
+
     return 0;
 }
@@ -1760,6 +1760,59 @@ void testArrayStringsRepeats()
     }
 }
 
+//-*****************************************************************************
+void testArrayWstringsChange()
+{
+    std::string archiveName = "wstrArrayChange.abc";
+
+    std::vector < Alembic::Util::wstring > vals(2);
+    vals[0] = L"one";
+    vals[1] = L"two";
+
+    std::vector < Alembic::Util::wstring > vals2(2);
+    vals2[0] = L"three";
+    vals2[1] = L"four";
+
+    ABCA::DataType dtype(Alembic::Util::kWstringPOD);
+
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w(archiveName, ABCA::MetaData());
+        ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+        ABCA::ArrayPropertyWriterPtr awp =
+            parent->createArrayProperty("wstr", ABCA::MetaData(), dtype, 0);
+
+        // same number of strings, so only the key tells them apart
+        awp->setSample(ABCA::ArraySample(&(vals.front()), dtype,
+            Alembic::Util::Dimensions(vals.size())));
+        awp->setSample(ABCA::ArraySample(&(vals2.front()), dtype,
+            Alembic::Util::Dimensions(vals2.size())));
+    }
+
+    {
+        AO::ReadArchive r;
+        ABCA::ArchiveReaderPtr a = r( archiveName );
+        ABCA::ArrayPropertyReaderPtr ap =
+            a->getTop()->getProperties()->getArrayProperty("wstr");
+
+        TESTING_ASSERT(!ap->isConstant());
+
+        ABCA::ArraySamplePtr val;
+        ap->getSample(0, val);
+        TESTING_ASSERT(val->getDimensions().numPoints() == 2);
+        Alembic::Util::wstring * data =
+            (Alembic::Util::wstring *)(val->getData());
+        TESTING_ASSERT(data[0] == vals[0] && data[1] == vals[1]);
+
+        ap->getSample(1, val);
+        TESTING_ASSERT(val->getDimensions().numPoints() == 2);
+        data = (Alembic::Util::wstring *)(val->getData());
+        TESTING_ASSERT(data[0] == vals2[0] && data[1] == vals2[1]);
+    }
+}
+
+//-*****************************************************************************
 void testArraySamples()
 {
     std::string archiveName = "numArraySamplesTest.abc";
@@ -1867,6 +1920,150 @@ void testArraySamples()
     }
 }
 
+void testArraySampleCache()
+{
+    std::string archiveName = "arraySampleCacheTest.abc";
+
+    ABCA::DataType f1(Alembic::Util::kFloat32POD, 1);
+    ABCA::DataType f3(Alembic::Util::kFloat32POD, 3);
+    std::vector < Alembic::Util::float32_t > vals(6);
+
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w(archiveName, ABCA::MetaData());
+        ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+        ABCA::ArrayPropertyWriterPtr awp =
+            parent->createArrayProperty("a", ABCA::MetaData(), f3, 0);
+        ABCA::ArrayPropertyWriterPtr bwp =
+            parent->createArrayProperty("b", ABCA::MetaData(), f3, 0);
+        ABCA::ArrayPropertyWriterPtr cwp =
+            parent->createArrayProperty("c", ABCA::MetaData(), f1, 0);
+
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            for (std::size_t j = 0; j < vals.size(); ++j)
+            {
+                vals[j] = i * 10.0f + j;
+            }
+            awp->setSample(ABCA::ArraySample(&(vals.front()), f3,
+                Alembic::Util::Dimensions(2)));
+            bwp->setSample(ABCA::ArraySample(&(vals.front()), f3,
+                Alembic::Util::Dimensions(2)));
+            cwp->setSample(ABCA::ArraySample(&(vals.front()), f1,
+                Alembic::Util::Dimensions(6)));
+        }
+    }
+
+    {
+        // room for about 2 samples per shard
+        ABCA::ReadArraySampleCachePtr cache = AO::CreateCache(4 * 24 * 2, 4);
+        AO::ReadArchive r;
+        ABCA::ArchiveReaderPtr a = r(archiveName, cache);
+        TESTING_ASSERT(a->getReadArraySampleCachePtr() == cache);
+
+        ABCA::CompoundPropertyReaderPtr parent = a->getTop()->getProperties();
+        ABCA::ArrayPropertyReaderPtr ap = parent->getArrayProperty("a");
+        ABCA::ArrayPropertyReaderPtr bp = parent->getArrayProperty("b");
+        ABCA::ArrayPropertyReaderPtr cp = parent->getArrayProperty("c");
+
+        ABCA::ArraySamplePtr as, bs, cs;
+        ap->getSample(3, as);
+        bp->getSample(3, bs);
+        cp->getSample(3, cs);
+
+        // the same data is shared, the same bytes with another shape aren't
+        TESTING_ASSERT(as == bs);
+        TESTING_ASSERT(as != cs);
+        TESTING_ASSERT(cs->getDataType() == f1);
+        TESTING_ASSERT(cs->getDimensions().numPoints() == 6);
+        TESTING_ASSERT(((const Alembic::Util::float32_t *)
+            cs->getData())[5] == 35.0f);
+
+        AO::CacheStats stats;
+        TESTING_ASSERT(AO::GetCacheStats(cache, stats));
+        TESTING_ASSERT(stats.hits == 2 && stats.misses == 1);
+        TESTING_ASSERT(stats.numSamples == 1 && stats.numBytes == 24);
+
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            ap->getSample(i, as);
+            TESTING_ASSERT(((const Alembic::Util::float32_t *)
+                as->getData())[1] == i * 10.0f + 1);
+        }
+
+        TESTING_ASSERT(AO::GetCacheStats(cache, stats));
+        TESTING_ASSERT(stats.numBytes <= stats.maxBytes);
+        TESTING_ASSERT(stats.evictions > 0);
+
+        // not a cache made by CreateCache
+        TESTING_ASSERT(!AO::GetCacheStats(ABCA::ReadArraySampleCachePtr(),
+                                          stats));
+    }
+}
+void testArraySampleHashType()
+{
+    std::string chunkedName = "arraySampleChunkedHashTest.abc";
+    std::string copyName = "arraySampleCopiedHashTest.abc";
+    std::string plainName = "arraySamplePlainHashTest.abc";
+
+    // several chunks of the chunked hash
+    ABCA::DataType f1(Alembic::Util::kFloat32POD, 1);
+    std::vector < Alembic::Util::float32_t > vals(1024 * 1024, 1.0f);
+    ABCA::ArraySample samp(&(vals.front()), f1,
+        Alembic::Util::Dimensions(vals.size()));
+
+    {
+        AO::WriteArchive w(0, ABCA::kChunkedMurmur3Hash);
+        ABCA::ArchiveWriterPtr a = w(chunkedName, ABCA::MetaData());
+        ABCA::ArrayPropertyWriterPtr awp =
+            a->getTop()->getProperties()->createArrayProperty("a",
+                ABCA::MetaData(), f1, 0);
+        awp->setSample(samp);
+        awp->setSample(samp);
+    }
+
+    ABCA::MetaData chunkedMetaData;
+    {
+        AO::ReadArchive r;
+        ABCA::ArchiveReaderPtr a = r(chunkedName);
+        chunkedMetaData = a->getMetaData();
+        TESTING_ASSERT(chunkedMetaData.get(ABCA::kArraySampleHashTypeKey) ==
+                       "ChunkedMurmur3");
+        TESTING_ASSERT(ABCA::GetArraySampleHashType(chunkedMetaData) ==
+                       ABCA::kChunkedMurmur3Hash);
+
+        ABCA::ArrayPropertyReaderPtr ap =
+            a->getTop()->getProperties()->getArrayProperty("a");
+        ABCA::ArraySampleKey key;
+        TESTING_ASSERT(ap->getKey(1, key));
+        TESTING_ASSERT(key == samp.getKey(ABCA::kChunkedMurmur3Hash));
+        TESTING_ASSERT(key != samp.getKey(ABCA::kMurmur3Hash));
+    }
+
+    // the metadata of another archive doesn't carry over its hash type
+    {
+        AO::WriteArchive w;
+        w(copyName, chunkedMetaData);
+        w(plainName, ABCA::MetaData());
+    }
+
+    {
+        AO::ReadArchive r;
+        ABCA::ArchiveReaderPtr a = r(copyName);
+        TESTING_ASSERT(a->getMetaData().get(ABCA::kArraySampleHashTypeKey) ==
+                       "Murmur3");
+        TESTING_ASSERT(ABCA::GetArraySampleHashType(a->getMetaData()) ==
+                       ABCA::kMurmur3Hash);
+
+        a = r(plainName);
+        TESTING_ASSERT(
+            a->getMetaData().get(ABCA::kArraySampleHashTypeKey).empty());
+        TESTING_ASSERT(ABCA::GetArraySampleHashType(a->getMetaData()) ==
+                       ABCA::kMurmur3Hash);
+    }
+}
+
 int main ( int argc, char *argv[] )
 {
     testEmptyArray();
@@ -1874,6 +2071,9 @@ int main ( int argc, char *argv[] )
     testReadWriteArrays();
     testExtentArrayStrings();
     testArrayStringsRepeats();
+    testArrayWstringsChange();
     testArraySamples();
+    testArraySampleCache();
+    testArraySampleHashType();
     return 0;
 }
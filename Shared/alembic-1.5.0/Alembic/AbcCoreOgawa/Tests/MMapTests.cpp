@@ -0,0 +1,372 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+
+//-*****************************************************************************
+namespace AO = Alembic::AbcCoreOgawa;
+
+namespace ABCA = Alembic::AbcCoreAbstract;
+
+using namespace Alembic::Util;
+
+static const std::string gArchiveName = "mmapArray.abc";
+static const size_t gNumProps = 16;
+static const size_t gNumSamples = 24;
+static const size_t gNumFloats = 3 * 8192;
+
+//-*****************************************************************************
+// wall clock time in seconds
+static double now()
+{
+#ifdef _MSC_VER
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &count );
+    return double( count.QuadPart ) / double( freq.QuadPart );
+#else
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return double( tv.tv_sec ) + double( tv.tv_usec ) * 1e-6;
+#endif
+}
+
+//-*****************************************************************************
+void writeArchive()
+{
+    AO::WriteArchive w;
+    ABCA::ArchiveWriterPtr a = w( gArchiveName, ABCA::MetaData() );
+    ABCA::ObjectWriterPtr archive = a->getTop();
+    ABCA::CompoundPropertyWriterPtr parent = archive->getProperties();
+
+    ABCA::DataType floatType( kFloat32POD, 3 );
+    ABCA::DataType byteType( kUint8POD, 1 );
+    ABCA::DataType strType( kStringPOD, 1 );
+
+    for ( size_t i = 0; i < gNumProps; ++i )
+    {
+        std::ostringstream name;
+        name << "p" << i;
+        ABCA::ArrayPropertyWriterPtr fwp = parent->createArrayProperty(
+            name.str(), ABCA::MetaData(), floatType, 0 );
+
+        std::vector< float32_t > vals( gNumFloats );
+        for ( size_t s = 0; s < gNumSamples; ++s )
+        {
+            for ( size_t j = 0; j < gNumFloats; ++j )
+            {
+                vals[j] = float32_t( i * 1000 + s ) + float32_t( j ) * 0.5f;
+            }
+            fwp->setSample( ABCA::ArraySample( &vals.front(), floatType,
+                Dimensions( gNumFloats / 3 ) ) );
+        }
+    }
+
+    // odd sized bytes and strings shift everything written after them, so
+    // the later samples can't all be aliased and have to be copied
+    ABCA::ArrayPropertyWriterPtr bwp = parent->createArrayProperty(
+        "bytes", ABCA::MetaData(), byteType, 0 );
+    ABCA::ArrayPropertyWriterPtr swp = parent->createArrayProperty(
+        "strings", ABCA::MetaData(), strType, 0 );
+    ABCA::ArrayPropertyWriterPtr gwp = parent->createArrayProperty(
+        "shifted", ABCA::MetaData(), floatType, 0 );
+
+    for ( size_t s = 0; s < gNumSamples; ++s )
+    {
+        std::vector< uint8_t > bytes( 7 + s, uint8_t( s ) );
+        bwp->setSample( ABCA::ArraySample( &bytes.front(), byteType,
+            Dimensions( bytes.size() ) ) );
+
+        std::vector< std::string > strs( 3 );
+        strs[0] = "a";
+        strs[1] = std::string( s + 1, 'b' );
+        strs[2] = "ccc";
+        swp->setSample( ABCA::ArraySample( &strs.front(), strType,
+            Dimensions( strs.size() ) ) );
+
+        std::vector< float32_t > vals( 3 * ( s + 1 ), float32_t( s ) );
+        gwp->setSample( ABCA::ArraySample( &vals.front(), floatType,
+            Dimensions( s + 1 ) ) );
+    }
+}
+
+//-*****************************************************************************
+void testMappedMatchesStreams()
+{
+    AO::ReadArchive streamReader( 1 );
+    AO::ReadArchive mappedReader( 1, true );
+    ABCA::ArchiveReaderPtr sa = streamReader( gArchiveName );
+    ABCA::ArchiveReaderPtr ma = mappedReader( gArchiveName );
+
+    ABCA::CompoundPropertyReaderPtr sp = sa->getTop()->getProperties();
+    ABCA::CompoundPropertyReaderPtr mp = ma->getTop()->getProperties();
+    TESTING_ASSERT( sp->getNumProperties() == mp->getNumProperties() );
+
+    size_t aliased = 0;
+    size_t copied = 0;
+    for ( size_t i = 0; i < sp->getNumProperties(); ++i )
+    {
+        ABCA::ArrayPropertyReaderPtr sap = sp->getArrayProperty( i );
+        ABCA::ArrayPropertyReaderPtr map = mp->getArrayProperty( i );
+        TESTING_ASSERT( sap->getNumSamples() == gNumSamples );
+        TESTING_ASSERT( map->getNumSamples() == gNumSamples );
+
+        for ( size_t s = 0; s < gNumSamples; ++s )
+        {
+            ABCA::ArraySamplePtr ss, ms, ms2;
+            sap->getSample( s, ss );
+            map->getSample( s, ms );
+            TESTING_ASSERT( ss->getDimensions() == ms->getDimensions() );
+            TESTING_ASSERT( ss->getKey() == ms->getKey() );
+
+            if ( ss->getDataType().getPod() == kStringPOD )
+            {
+                const std::string * a =
+                    static_cast< const std::string * >( ss->getData() );
+                const std::string * b =
+                    static_cast< const std::string * >( ms->getData() );
+                for ( size_t j = 0; j < ss->size(); ++j )
+                {
+                    TESTING_ASSERT( a[j] == b[j] );
+                }
+                continue;
+            }
+
+            size_t numBytes = ss->size() * ss->getDataType().getNumBytes();
+            TESTING_ASSERT( memcmp( ss->getData(), ms->getData(),
+                                    numBytes ) == 0 );
+
+            // an aliased sample points at the same mapped bytes every time
+            map->getSample( s, ms2 );
+            if ( ms2->getData() == ms->getData() )
+            {
+                aliased++;
+            }
+            else
+            {
+                copied++;
+            }
+        }
+    }
+
+    std::cout << "mapped samples aliased: " << aliased << " copied: "
+              << copied << std::endl;
+    TESTING_ASSERT( aliased > 0 );
+
+    // aliased samples keep the mapping alive after the archive goes away
+    ABCA::ArraySamplePtr kept;
+    mp->getArrayProperty( 0 )->getSample( 0, kept );
+    mp.reset();
+    ma.reset();
+    TESTING_ASSERT( static_cast< const float32_t * >( kept->getData() )[1]
+                    == 0.5f );
+}
+
+//-*****************************************************************************
+struct ReadJob
+{
+    std::vector< ABCA::ArrayPropertyReaderPtr > * props;
+    size_t thread;
+    size_t numThreads;
+    double sum;
+};
+
+// every thread reads its share of the float samples and touches every value
+#ifdef _MSC_VER
+static unsigned __stdcall readSamples( void * iJob )
+#else
+static void * readSamples( void * iJob )
+#endif
+{
+    ReadJob * job = static_cast< ReadJob * >( iJob );
+    size_t total = job->props->size() * gNumSamples;
+    for ( size_t k = job->thread; k < total; k += job->numThreads )
+    {
+        ABCA::ArraySamplePtr samp;
+        ( *job->props )[ k / gNumSamples ]->getSample( k % gNumSamples, samp );
+        const float32_t * vals =
+            static_cast< const float32_t * >( samp->getData() );
+        for ( size_t j = 0; j < gNumFloats; ++j )
+        {
+            job->sum += vals[j];
+        }
+    }
+    return 0;
+}
+
+double timeReads( bool iUseMMap, size_t iNumStreams, size_t iNumThreads,
+                  double & oSum, AO::StreamStats * oStats = NULL )
+{
+    AO::ReadArchive reader( iNumStreams, iUseMMap );
+    ABCA::ArchiveReaderPtr a = reader( gArchiveName );
+    ABCA::CompoundPropertyReaderPtr parent = a->getTop()->getProperties();
+
+    std::vector< ABCA::ArrayPropertyReaderPtr > props;
+    for ( size_t i = 0; i < gNumProps; ++i )
+    {
+        props.push_back( parent->getArrayProperty( i ) );
+    }
+
+    std::vector< ReadJob > jobs( iNumThreads );
+    for ( size_t t = 0; t < iNumThreads; ++t )
+    {
+        jobs[t].props = &props;
+        jobs[t].thread = t;
+        jobs[t].numThreads = iNumThreads;
+        jobs[t].sum = 0.0;
+    }
+
+    double start = now();
+
+#ifdef _MSC_VER
+    std::vector< HANDLE > threads( iNumThreads );
+    for ( size_t t = 0; t < iNumThreads; ++t )
+    {
+        threads[t] = (HANDLE) _beginthreadex( NULL, 0, readSamples, &jobs[t],
+                                              0, NULL );
+    }
+    for ( size_t t = 0; t < iNumThreads; ++t )
+    {
+        WaitForSingleObject( threads[t], INFINITE );
+        CloseHandle( threads[t] );
+    }
+#else
+    std::vector< pthread_t > threads( iNumThreads );
+    for ( size_t t = 0; t < iNumThreads; ++t )
+    {
+        pthread_create( &threads[t], NULL, readSamples, &jobs[t] );
+    }
+    for ( size_t t = 0; t < iNumThreads; ++t )
+    {
+        pthread_join( threads[t], NULL );
+    }
+#endif
+
+    double elapsed = now() - start;
+
+    oSum = 0.0;
+    for ( size_t t = 0; t < iNumThreads; ++t )
+    {
+        oSum += jobs[t].sum;
+    }
+
+    if ( oStats )
+    {
+        TESTING_ASSERT( AO::GetStreamStats( a, *oStats ) );
+    }
+    return elapsed;
+}
+
+//-*****************************************************************************
+void testStreamLeasing()
+{
+    size_t numReads = gNumProps * gNumSamples;
+
+    double expected = 0.0;
+    timeReads( false, 1, 1, expected );
+
+    // more threads than streams, some have to wait for a stream
+    double sum = 0.0;
+    AO::StreamStats stats;
+    timeReads( false, 4, 32, sum, &stats );
+    TESTING_ASSERT( sum == expected );
+    TESTING_ASSERT( stats.numStreams == 4 );
+    TESTING_ASSERT( stats.numLeases >= numReads );
+    std::cout << "4 streams, 32 threads: " << stats.numLeases << " leases, "
+              << stats.numReused << " reused, " << stats.numWaits
+              << " waits, " << stats.waitTime << "s waiting" << std::endl;
+
+    // more than 64 streams spans several words of the free stream bitmap
+    timeReads( false, 100, 128, sum, &stats );
+    TESTING_ASSERT( sum == expected );
+    TESTING_ASSERT( stats.numStreams == 100 );
+    TESTING_ASSERT( stats.numLeases >= numReads );
+
+    // a mapped archive doesn't lease streams at all
+    timeReads( true, 32, 32, sum, &stats );
+    TESTING_ASSERT( sum == expected );
+    TESTING_ASSERT( stats.numLeases == 0 && stats.numWaits == 0 );
+}
+
+//-*****************************************************************************
+void benchmarkReads()
+{
+    double megabytes = double( gNumProps * gNumSamples * gNumFloats *
+                               sizeof( float32_t ) ) / ( 1024.0 * 1024.0 );
+
+    size_t threadCounts[3] = { 1, 8, 32 };
+    for ( size_t i = 0; i < 3; ++i )
+    {
+        double streamSum = 0.0;
+        double mappedSum = 0.0;
+
+        // warm up the page cache so both backends see the same file state
+        size_t n = threadCounts[i];
+        timeReads( false, n, n, streamSum );
+        double streamTime = timeReads( false, n, n, streamSum );
+        double mappedTime = timeReads( true, n, n, mappedSum );
+        TESTING_ASSERT( streamSum == mappedSum );
+
+        std::cout << threadCounts[i] << " threads: ifstream "
+                  << megabytes / streamTime << " MB/s, mmap "
+                  << megabytes / mappedTime << " MB/s" << std::endl;
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    writeArchive();
+    testMappedMatchesStreams();
+    testStreamLeasing();
+    benchmarkReads();
+    return 0;
+}
@@ -156,6 +156,15 @@ GetWrittenSampleMap( AbcA::ArchiveWriterPtr iVal )
     return ptr->getWrittenSampleMap();
 }
 
+//-*****************************************************************************
+AbcA::ArraySampleHashType
+GetArraySampleHashType( AbcA::ArchiveWriterPtr iVal )
+{
+    AwImpl *ptr = dynamic_cast<AwImpl*>( iVal.get() );
+    ABCA_ASSERT( ptr, "NULL Impl Ptr" );
+    return ptr->getArraySampleHashType();
+}
+
 //-*****************************************************************************
 void WriteDimensions( Ogawa::OGroupPtr iGroup,
                       const AbcA::Dimensions & iDims,
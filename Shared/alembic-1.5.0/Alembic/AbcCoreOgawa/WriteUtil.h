@@ -59,6 +59,10 @@ void HashDimensions( const AbcA::Dimensions & iDims,
 WrittenSampleMap& GetWrittenSampleMap(
     AbcA::ArchiveWriterPtr iArchive );
 
+//-*****************************************************************************
+AbcA::ArraySampleHashType GetArraySampleHashType(
+    AbcA::ArchiveWriterPtr iArchive );
+
 //-*****************************************************************************
 void
 WriteDimensions( Ogawa::OGroupPtr iGroup,
@@ -39,8 +39,9 @@ namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
-IArchive::IArchive(const std::string & iFileName, std::size_t iNumStreams) :
-    mStreams(new IStreams(iFileName, iNumStreams))
+IArchive::IArchive(const std::string & iFileName, std::size_t iNumStreams,
+                   bool iUseMMap) :
+    mStreams(new IStreams(iFileName, iNumStreams, iUseMMap))
 {
     init();
 }
@@ -80,6 +81,11 @@ Alembic::Util::uint16_t IArchive::getVersion() const
     return mStreams->getVersion();
 }
 
+bool IArchive::isMapped() const
+{
+    return mStreams->isMapped();
+}
+
 IGroupPtr IArchive::getGroup() const
 {
     return mGroup;
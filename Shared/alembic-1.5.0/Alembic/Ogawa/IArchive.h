@@ -49,7 +49,8 @@ namespace ALEMBIC_VERSION_NS {
 class IArchive
 {
 public:
-    IArchive(const std::string & iFileName, std::size_t iNumStreams=1);
+    IArchive(const std::string & iFileName, std::size_t iNumStreams=1,
+             bool iUseMMap=false);
     IArchive(const std::vector< std::istream * > & iStreams);
     ~IArchive();
 
@@ -59,6 +60,9 @@ public:
 
     Alembic::Util::uint16_t getVersion() const;
 
+    // true if the file was memory mapped instead of opened as streams
+    bool isMapped() const;
+
     IGroupPtr getGroup() const;
 
 private:
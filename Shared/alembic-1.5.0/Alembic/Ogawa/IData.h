@@ -54,6 +54,13 @@ public:
 
     Alembic::Util::uint64_t getSize() const;
 
+    // when the archive is memory mapped returns a pointer to iSize bytes of
+    // this data starting at iOffset, without copying anything.
+    // Returns NULL if the archive isn't mapped or the range is out of bounds.
+    // The memory stays valid for as long as this IData is alive.
+    const void * getMappedData(Alembic::Util::uint64_t iSize,
+                               Alembic::Util::uint64_t iOffset) const;
+
     // not really necessary for most workflows, it could be used by some
     // Ogawa utilities to detect when this IData is shared
     Alembic::Util::uint64_t getPos() const;
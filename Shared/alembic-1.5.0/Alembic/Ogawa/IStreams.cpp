@@ -36,6 +36,14 @@
 #include <Alembic/Ogawa/IStreams.h>
 #include <fstream>
 #include <stdexcept>
+#include <algorithm>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Alembic {
 namespace Ogawa {
@@ -47,6 +55,8 @@ public:
     PrivateData()
     {
         locks = NULL;
+        mapped = NULL;
+        mappedSize = 0;
         valid = false;
         frozen = false;
         version = 0;
@@ -59,6 +69,8 @@ public:
             delete [] locks;
         }
 
+        unmap();
+
         // only cleanup if we were the ones who opened it
         if (!fileName.empty())
         {
@@ -75,18 +87,49 @@ public:
         }
     }
 
+    void unmap()
+    {
+        if (mapped)
+        {
+#ifdef _MSC_VER
+            UnmapViewOfFile(mapped);
+#else
+            munmap((void *) mapped, (std::size_t) mappedSize);
+#endif
+            mapped = NULL;
+            mappedSize = 0;
+        }
+    }
+
     std::vector<std::istream *> streams;
     std::vector<Alembic::Util::uint64_t> offsets;
     Alembic::Util::mutex * locks;
+
+    // the whole file when it is memory mapped, never written to
+    const char * mapped;
+    Alembic::Util::uint64_t mappedSize;
+
     std::string fileName;
     bool valid;
     bool frozen;
     Alembic::Util::uint16_t version;
 };
 
-IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams) :
+IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams,
+                   bool iUseMMap) :
     mData(new IStreams::PrivateData())
 {
+    if (iUseMMap && map(iFileName))
+    {
+        mData->fileName = iFileName;
+        init();
+        if (!mData->valid || mData->version != 1)
+        {
+            mData->valid = false;
+            mData->unmap();
+        }
+        return;
+    }
 
     std::ifstream * filestream = new std::ifstream;
     filestream->open(iFileName.c_str(), std::ios::binary);
@@ -137,6 +180,92 @@ IStreams::IStreams(const std::vector< std::istream * > & iStreams) :
     mData->locks = new Alembic::Util::mutex[mData->streams.size()];
 }
 
+// pulls the frozen flag, version and root group position out of the 16 byte
+// header, returns false if it isn't an Ogawa header
+static bool parseHeader(const char * iHeader, bool & oFrozen,
+                        Alembic::Util::uint16_t & oVersion,
+                        Alembic::Util::uint64_t & oGroupPos)
+{
+    std::string magicStr(iHeader, 5);
+    if (magicStr != "Ogawa")
+    {
+        return false;
+    }
+
+    oFrozen = (iHeader[5] == char(0xff));
+    oVersion = (iHeader[6] << 8) | iHeader[7];
+    memcpy(&oGroupPos, &(iHeader[8]), 8);
+    return true;
+}
+
+bool IStreams::map(const std::string & iFileName)
+{
+#ifdef _MSC_VER
+    HANDLE file = CreateFileA(iFileName.c_str(), GENERIC_READ,
+        FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < 16 ||
+        (Alembic::Util::uint64_t) fileSize.QuadPart >
+        (Alembic::Util::uint64_t) (std::numeric_limits<SIZE_T>::max)())
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // the view keeps the mapping and the file open, so both handles can go
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        return false;
+    }
+
+    void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    mData->mapped = (const char *) data;
+    mData->mappedSize = fileSize.QuadPart;
+#else
+    int fd = open(iFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 16 ||
+        (Alembic::Util::uint64_t) st.st_size >
+        (Alembic::Util::uint64_t) (std::numeric_limits<std::size_t>::max)())
+    {
+        close(fd);
+        return false;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void * data = mmap(NULL, (std::size_t) st.st_size, PROT_READ, MAP_SHARED,
+                       fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData->mapped = (const char *) data;
+    mData->mappedSize = st.st_size;
+#endif
+
+    return true;
+}
+
 void IStreams::init()
 {
     // simple temporary endian check
@@ -153,6 +282,19 @@ void IStreams::init()
             "Ogawa currently only supports little-endian reading.");
     }
 
+    if (mData->mapped)
+    {
+        Alembic::Util::uint64_t groupPos = 0;
+        mData->valid = parseHeader(mData->mapped, mData->frozen,
+                                   mData->version, groupPos);
+        if (!mData->valid)
+        {
+            mData->frozen = false;
+            mData->version = 0;
+        }
+        return;
+    }
+
     if (mData->streams.empty())
     {
         return;
@@ -165,18 +307,16 @@ void IStreams::init()
         char header[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
         mData->offsets.push_back(mData->streams[i]->tellg());
         mData->streams[i]->read(header, 16);
-        std::string magicStr(header, 5);
-        if (magicStr != "Ogawa")
+        bool frozen = false;
+        Alembic::Util::uint16_t version = 0;
+        Alembic::Util::uint64_t groupPos = 0;
+        if (!parseHeader(header, frozen, version, groupPos))
         {
             mData->frozen = false;
             mData->valid = false;
             mData->version = 0;
             return;
         }
-        bool frozen = (header[5] == char(0xff));
-        Alembic::Util::uint16_t version = (header[6] << 8) | header[7];
-        Alembic::Util::uint64_t groupPos =
-            *((Alembic::Util::uint64_t *)(&(header[8])));
 
         if (i == 0)
         {
@@ -224,6 +364,19 @@ void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
         return;
     }
 
+    // the mapping is read only, so any number of threads can copy out of it
+    // without locking
+    if (mData->mapped)
+    {
+        if (iPos < mData->mappedSize)
+        {
+            Alembic::Util::uint64_t size =
+                std::min(iSize, mData->mappedSize - iPos);
+            memcpy(oBuf, mData->mapped + iPos, (std::size_t) size);
+        }
+        return;
+    }
+
     std::size_t threadId = 0;
     if (iThreadId < mData->streams.size())
     {
@@ -237,6 +390,23 @@ void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
     }
 }
 
+bool IStreams::isMapped()
+{
+    return mData->mapped != NULL;
+}
+
+const void * IStreams::getMappedData(Alembic::Util::uint64_t iPos,
+                                     Alembic::Util::uint64_t iSize)
+{
+    if (!isValid() || mData->mapped == NULL || iPos > mData->mappedSize ||
+        iSize > mData->mappedSize - iPos)
+    {
+        return NULL;
+    }
+
+    return mData->mapped + iPos;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Ogawa
 } // End namespace Alembic
@@ -47,7 +47,11 @@ namespace ALEMBIC_VERSION_NS {
 class IStreams
 {
 public:
-    IStreams(const std::string & iFileName, std::size_t iNumStreams=1);
+    // when iUseMMap is true the file is mapped into memory instead of being
+    // opened as iNumStreams ifstreams, reads then become lock free copies out
+    // of the mapping; if the file can't be mapped the ifstreams are used
+    IStreams(const std::string & iFileName, std::size_t iNumStreams=1,
+             bool iUseMMap=false);
     IStreams(const std::vector< std::istream * > & iStreams);
     ~IStreams();
 
@@ -59,12 +63,22 @@ public:
     void read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
               Alembic::Util::uint64_t iSize, void * oBuf);
 
+    // true if the file is memory mapped
+    bool isMapped();
+
+    // returns a pointer to iSize bytes at iPos inside the mapped file, or NULL
+    // if the file isn't mapped or the range is outside of it.
+    // The pointer is only valid for the lifetime of this IStreams.
+    const void * getMappedData(Alembic::Util::uint64_t iPos,
+                               Alembic::Util::uint64_t iSize);
+
 private:
     // noncopyable
     IStreams(const IStreams &);
     const IStreams & operator=(const IStreams &);
 
     void init();
+    bool map(const std::string & iFileName);
 
     class PrivateData;
     Alembic::Util::auto_ptr< PrivateData > mData;
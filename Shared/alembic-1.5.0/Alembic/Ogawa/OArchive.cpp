@@ -41,8 +41,9 @@ namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
-OArchive::OArchive(const std::string & iFileName) :
-    mStream(new OStream(iFileName))
+OArchive::OArchive(const std::string & iFileName,
+                   Alembic::Util::uint64_t iAsyncBufferSize) :
+    mStream(new OStream(iFileName, iAsyncBufferSize))
 {
     mGroup.reset(new OGroup(mStream));
 }
@@ -61,6 +62,12 @@ bool OArchive::isValid()
     return mStream->isValid();
 }
 
+void OArchive::close()
+{
+    mGroup->freeze();
+    mStream->close();
+}
+
 OGroupPtr OArchive::getGroup()
 {
     return mGroup;
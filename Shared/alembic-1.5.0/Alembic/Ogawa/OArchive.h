@@ -47,7 +47,9 @@ namespace ALEMBIC_VERSION_NS {
 class OArchive
 {
 public:
-    OArchive(const std::string & iFileName);
+    // see OStream for what iAsyncBufferSize does
+    OArchive(const std::string & iFileName,
+             Alembic::Util::uint64_t iAsyncBufferSize=0);
     OArchive(std::ostream * iStream);
     ~OArchive();
 
@@ -55,6 +57,10 @@ public:
 
     bool isValid();
 
+    // freezes the top group and closes the stream, throws if the archive
+    // could not be written completely. See OStream::close
+    void close();
+
 private:
     OStreamPtr mStream;
     OGroupPtr mGroup;
@@ -34,9 +34,20 @@
 //-*****************************************************************************
 
 #include <Alembic/Ogawa/OStream.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <iostream>
 #include <stdexcept>
 #include <sstream>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
 
 //#define ESS_LOG_ERROR(a) do { std::stringstream __s; __s << "Alembic: " << a << std::endl; OutputDebugString( __s.str().c_str() ); } while(0)
 
@@ -46,7 +57,315 @@ namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
- 
+namespace {
+
+//-*****************************************************************************
+// Writes the data handed to it on a background thread, in the order it was
+// handed over.  The tail of the file is appended into a buffer, full buffers
+// are swapped with a spare one and queued.  Writes to earlier positions
+// patch the buffer if it still holds them, otherwise they are queued too.
+class AsyncWriter
+{
+public:
+    AsyncWriter(std::ostream * iStream, Alembic::Util::uint64_t iBufferSize,
+                Alembic::Util::uint64_t iEndPos) :
+        mStream(iStream), mBufferSize(iBufferSize), mFillStart(iEndPos),
+        mFillUsed(0), mErrorThrown(false), mSpareReady(true),
+        mStopping(false)
+    {
+        mFill.resize(mBufferSize);
+        mSpare.resize(mBufferSize);
+
+#ifdef _MSC_VER
+        InitializeCriticalSection(&mLock);
+        InitializeConditionVariable(&mQueued);
+        InitializeConditionVariable(&mWritten);
+        mThread = (HANDLE) _beginthreadex(NULL, 0, run, this, 0, NULL);
+#else
+        pthread_mutex_init(&mLock, NULL);
+        pthread_cond_init(&mQueued, NULL);
+        pthread_cond_init(&mWritten, NULL);
+        pthread_create(&mThread, NULL, run, this);
+#endif
+    }
+
+    ~AsyncWriter()
+    {
+        finish();
+
+#ifdef _MSC_VER
+        DeleteCriticalSection(&mLock);
+#else
+        pthread_cond_destroy(&mWritten);
+        pthread_cond_destroy(&mQueued);
+        pthread_mutex_destroy(&mLock);
+#endif
+    }
+
+    Alembic::Util::uint64_t getEndPos() const
+    {
+        return mFillStart + mFillUsed;
+    }
+
+    void append(const char * iBuf, Alembic::Util::uint64_t iSize)
+    {
+        while (iSize > 0)
+        {
+            if (mFillUsed == mBufferSize)
+            {
+                queueFill();
+            }
+
+            Alembic::Util::uint64_t size =
+                std::min(iSize, mBufferSize - mFillUsed);
+            memcpy(&mFill[mFillUsed], iBuf, size);
+            mFillUsed += size;
+            iBuf += size;
+            iSize -= size;
+        }
+    }
+
+    // iPos + iSize must not go past getEndPos()
+    void patch(Alembic::Util::uint64_t iPos, const char * iBuf,
+               Alembic::Util::uint64_t iSize)
+    {
+        // the part that was already handed to the writer thread
+        if (iPos < mFillStart)
+        {
+            Alembic::Util::uint64_t size = std::min(iSize, mFillStart - iPos);
+            Job job;
+            job.pos = iPos;
+            job.size = size;
+            job.isBuffer = false;
+            job.bytes.assign(iBuf, iBuf + size);
+            queue(job);
+
+            iPos += size;
+            iBuf += size;
+            iSize -= size;
+        }
+
+        // and the part still in the buffer
+        if (iSize > 0)
+        {
+            memcpy(&mFill[iPos - mFillStart], iBuf, iSize);
+        }
+    }
+
+    // writes out everything and stops the thread, after which the stream
+    // can be used directly again
+    void finish()
+    {
+        if (mStopping)
+        {
+            return;
+        }
+
+        // any error is picked up by the caller via getError
+        if (mFillUsed > 0)
+        {
+            submitFill();
+        }
+
+        lock();
+        mStopping = true;
+        signal(mQueued);
+        unlock();
+
+#ifdef _MSC_VER
+        WaitForSingleObject(mThread, INFINITE);
+        CloseHandle(mThread);
+#else
+        pthread_join(mThread, NULL);
+#endif
+    }
+
+    // the first error the writer thread ran into, if any
+    std::string getError()
+    {
+        lock();
+        std::string error = mError;
+        unlock();
+        return error;
+    }
+
+private:
+    struct Job
+    {
+        Alembic::Util::uint64_t pos;
+        Alembic::Util::uint64_t size;
+        bool isBuffer;
+        std::vector<char> bytes;
+    };
+
+    void queueFill()
+    {
+        submitFill();
+        checkError();
+    }
+
+    void submitFill()
+    {
+        lock();
+
+        // wait for the writer thread to give back the other buffer
+        while (!mSpareReady)
+        {
+            wait(mWritten);
+        }
+        mSpareReady = false;
+
+        mJobs.push_back(Job());
+        Job & job = mJobs.back();
+        job.pos = mFillStart;
+        job.size = mFillUsed;
+        job.isBuffer = true;
+        job.bytes.swap(mFill);
+        mFill.swap(mSpare);
+
+        signal(mQueued);
+        unlock();
+
+        mFillStart += mFillUsed;
+        mFillUsed = 0;
+    }
+
+    void queue(Job & iJob)
+    {
+        lock();
+        mJobs.push_back(Job());
+        Job & job = mJobs.back();
+        job.pos = iJob.pos;
+        job.size = iJob.size;
+        job.isBuffer = iJob.isBuffer;
+        job.bytes.swap(iJob.bytes);
+        signal(mQueued);
+        unlock();
+        checkError();
+    }
+
+    // throws the first error once, the writes made while unwinding, by
+    // the destructors freezing their groups, are then dropped quietly
+    void checkError()
+    {
+        if (mErrorThrown)
+        {
+            return;
+        }
+
+        std::string error = getError();
+        if (!error.empty())
+        {
+            mErrorThrown = true;
+            throw std::runtime_error(error);
+        }
+    }
+
+#ifdef _MSC_VER
+    static unsigned __stdcall run(void * iWriter)
+#else
+    static void * run(void * iWriter)
+#endif
+    {
+        static_cast<AsyncWriter *>(iWriter)->writeJobs();
+        return 0;
+    }
+
+    void writeJobs()
+    {
+        lock();
+        for (;;)
+        {
+            while (mJobs.empty() && !mStopping)
+            {
+                wait(mQueued);
+            }
+
+            if (mJobs.empty())
+            {
+                break;
+            }
+
+            Job job;
+            job.pos = mJobs.front().pos;
+            job.size = mJobs.front().size;
+            job.isBuffer = mJobs.front().isBuffer;
+            job.bytes.swap(mJobs.front().bytes);
+            mJobs.pop_front();
+            bool failed = !mError.empty();
+            unlock();
+
+            // once something failed the file is garbage, don't bother
+            if (!failed)
+            {
+                try
+                {
+                    mStream->seekp(job.pos);
+                    mStream->write(&job.bytes.front(), job.size);
+                }
+                catch (std::exception & e)
+                {
+                    lock();
+                    mError = e.what();
+                    unlock();
+                }
+            }
+
+            lock();
+            if (job.isBuffer)
+            {
+                mSpare.swap(job.bytes);
+                mSpareReady = true;
+                signal(mWritten);
+            }
+        }
+        unlock();
+    }
+
+#ifdef _MSC_VER
+    void lock() { EnterCriticalSection(&mLock); }
+    void unlock() { LeaveCriticalSection(&mLock); }
+    void wait(CONDITION_VARIABLE & iCond)
+    {
+        SleepConditionVariableCS(&iCond, &mLock, INFINITE);
+    }
+    void signal(CONDITION_VARIABLE & iCond) { WakeConditionVariable(&iCond); }
+
+    CRITICAL_SECTION mLock;
+    CONDITION_VARIABLE mQueued;
+    CONDITION_VARIABLE mWritten;
+    HANDLE mThread;
+#else
+    void lock() { pthread_mutex_lock(&mLock); }
+    void unlock() { pthread_mutex_unlock(&mLock); }
+    void wait(pthread_cond_t & iCond) { pthread_cond_wait(&iCond, &mLock); }
+    void signal(pthread_cond_t & iCond) { pthread_cond_signal(&iCond); }
+
+    pthread_mutex_t mLock;
+    pthread_cond_t mQueued;
+    pthread_cond_t mWritten;
+    pthread_t mThread;
+#endif
+
+    std::ostream * mStream;
+    Alembic::Util::uint64_t mBufferSize;
+
+    // only touched by the thread doing the writes
+    std::vector<char> mFill;
+    Alembic::Util::uint64_t mFillStart;
+    Alembic::Util::uint64_t mFillUsed;
+    bool mErrorThrown;
+
+    // shared with the writer thread, under mLock
+    std::vector<char> mSpare;
+    bool mSpareReady;
+    std::deque<Job> mJobs;
+    bool mStopping;
+    std::string mError;
+};
+
+}
+
 class OStream::PrivateData
 {
 private:
@@ -54,7 +373,8 @@ private:
 
 public:
     PrivateData(const std::string & iFileName) :
-        stream(NULL), fileName(iFileName), startPos(0)
+        stream(NULL), fileName(iFileName), startPos(0), curPos(0),
+        closed(false)
     {
         std::ofstream * filestream = new std::ofstream(fileName.c_str(),
             std::ios_base::trunc | std::ios_base::binary);
@@ -72,7 +392,8 @@ public:
         }
     }
 
-    PrivateData(std::ostream * iStream) : stream(iStream), startPos(0)
+    PrivateData(std::ostream * iStream) : stream(iStream), startPos(0),
+        curPos(0), closed(false)
     {
         if (stream)
         {
@@ -89,12 +410,17 @@ public:
 
     ~PrivateData()
     {
+        // the writer thread has to be done with the stream before it goes
+        writer.reset();
+
         // if this was done via file, try to clean it up
         if (!fileName.empty() && stream)
         {
             std::ofstream * filestream = dynamic_cast<std::ofstream *>(stream);
             if (filestream)
             {
+                // a failed flush must not throw out of the destructor
+                filestream->exceptions(std::ios_base::goodbit);
                 filestream->close();
                 delete filestream;
             }
@@ -105,12 +431,28 @@ public:
     std::string fileName;
     Alembic::Util::uint64_t startPos;
     Alembic::Util::mutex lock;
+
+    // only used when writing asynchronously, where we keep track of
+    // our position instead of the stream
+    Alembic::Util::auto_ptr< AsyncWriter > writer;
+    Alembic::Util::uint64_t curPos;
+
+    // set once close was called, whether it succeeded or not
+    bool closed;
 };
 
-OStream::OStream(const std::string & iFileName) :
+OStream::OStream(const std::string & iFileName,
+                 Alembic::Util::uint64_t iAsyncBufferSize) :
     mData(new PrivateData(iFileName))
 {
     init();
+
+    if (isValid() && iAsyncBufferSize > 0)
+    {
+        mData->curPos = 16;
+        mData->writer.reset(new AsyncWriter(mData->stream, iAsyncBufferSize,
+                                            mData->curPos));
+    }
 }
 
 // we'll be writing from this already open stream which we don't own
@@ -121,12 +463,43 @@ OStream::OStream(std::ostream * iStream) : mData(new PrivateData(iStream))
 
 OStream::~OStream()
 {
-    // write our "frozen" byte (totally done writing)
-    if (isValid())
+    // destructors can't report errors, so they are only printed here, call
+    // close beforehand to get them as exceptions
+    try
+    {
+        close();
+    }
+    catch (std::exception & e)
+    {
+        std::cerr << "Ogawa: " << mData->fileName << " is incomplete, "
+                  << e.what() << std::endl;
+    }
+}
+
+void OStream::close()
+{
+    if (!isValid() || mData->closed)
     {
-        char frozen = 0xff;
-        mData->stream->seekp(mData->startPos + 5).write(&frozen, 1).flush();
+        return;
     }
+    mData->closed = true;
+
+    if (mData->writer.get())
+    {
+        mData->writer->finish();
+
+        // a failed write already left the file unusable, don't mark it
+        // as complete
+        std::string error = mData->writer->getError();
+        if (!error.empty())
+        {
+            throw std::runtime_error(error);
+        }
+    }
+
+    // write our "frozen" byte (totally done writing)
+    char frozen = 0xff;
+    mData->stream->seekp(mData->startPos + 5).write(&frozen, 1).flush();
 }
 
 bool OStream::isValid()
@@ -166,6 +539,13 @@ Alembic::Util::uint64_t OStream::getAndSeekEndPos()
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
+
+        if (mData->writer.get())
+        {
+            mData->curPos = mData->writer->getEndPos();
+            return mData->curPos;
+        }
+
         Alembic::Util::uint64_t lastp =
             mData->stream->seekp(0, std::ios_base::end).tellp();
 
@@ -186,6 +566,13 @@ void OStream::seek(Alembic::Util::uint64_t iPos)
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
+
+        if (mData->writer.get())
+        {
+            mData->curPos = iPos;
+            return;
+        }
+
         mData->stream->seekp(iPos + mData->startPos);
     }
 }
@@ -195,6 +582,32 @@ void OStream::write(const void * iBuf, Alembic::Util::uint64_t iSize)
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
+
+        if (mData->writer.get())
+        {
+            // overwrite what is already there, and append the rest
+            const char * buf = (const char *)iBuf;
+            Alembic::Util::uint64_t endPos = mData->writer->getEndPos();
+            if (mData->curPos < endPos)
+            {
+                Alembic::Util::uint64_t size =
+                    std::min(iSize, endPos - mData->curPos);
+                mData->writer->patch(mData->curPos, buf, size);
+                mData->curPos += size;
+                buf += size;
+                iSize -= size;
+            }
+
+            if (iSize > 0)
+            {
+                // writes past the end would leave a gap, which the sync
+                // writer can't do either, so this is always an append
+                mData->writer->append(buf, iSize);
+                mData->curPos += iSize;
+            }
+            return;
+        }
+
         mData->stream->write((const char *)iBuf, iSize).flush();
     }
 }
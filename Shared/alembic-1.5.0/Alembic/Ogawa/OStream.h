@@ -47,12 +47,23 @@ namespace ALEMBIC_VERSION_NS {
 class OStream
 {
 public:
-    OStream(const std::string & iFileName);
+    // when iAsyncBufferSize isn't 0 the data is appended to a buffer of that
+    // size, full buffers are written by a background thread while the next
+    // one is filled (two buffers are allocated). Positions are tracked here,
+    // so the caller never waits on the disk unless both buffers are full.
+    OStream(const std::string & iFileName,
+            Alembic::Util::uint64_t iAsyncBufferSize=0);
     OStream(std::ostream * iStream);
     ~OStream();
 
     bool isValid();
 
+    // waits for the pending writes and marks the file as complete, throws
+    // if a write failed, in which case the file is left incomplete. Nothing
+    // can be written afterwards. The destructor calls it and prints the
+    // error instead of throwing.
+    void close();
+
     Alembic::Util::uint64_t getAndSeekEndPos();
     void write(const void * iBuf, Alembic::Util::uint64_t iSize);
     void seek(Alembic::Util::uint64_t iPos);
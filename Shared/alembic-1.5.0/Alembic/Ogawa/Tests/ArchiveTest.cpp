@@ -37,6 +37,11 @@
 #include <Alembic/Ogawa/All.h>
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
 
+#ifndef _MSC_VER
+#include <signal.h>
+#include <sys/resource.h>
+#endif
+
 void test()
 {
     {
@@ -77,9 +82,61 @@ void stringStreamTest()
     TESTING_ASSERT(ia.getGroup()->getNumChildren() == 0);
 }
 
+void closeTest()
+{
+    {
+        Alembic::Ogawa::OArchive oa("archiveClose.ogawa", 64);
+        TESTING_ASSERT(oa.isValid());
+        oa.getGroup()->addData(5, "hello");
+        oa.close();
+
+        // done writing, readable before the archive goes away
+        Alembic::Ogawa::IArchive ia("archiveClose.ogawa");
+        TESTING_ASSERT(ia.isFrozen());
+        TESTING_ASSERT(ia.getGroup()->getNumChildren() == 1);
+
+        // closing twice does nothing
+        oa.close();
+    }
+
+#ifndef _MSC_VER
+    // writes past 1 KB fail, the asynchronous writer only finds out on its
+    // thread, the next buffer handed over or close have to report it
+    signal(SIGXFSZ, SIG_IGN);
+    struct rlimit oldLimit, limit;
+    getrlimit(RLIMIT_FSIZE, &oldLimit);
+    limit = oldLimit;
+    limit.rlim_cur = 1024;
+    setrlimit(RLIMIT_FSIZE, &limit);
+
+    bool threw = false;
+    {
+        Alembic::Ogawa::OArchive oa("archiveCloseFailed.ogawa", 64);
+        TESTING_ASSERT(oa.isValid());
+        std::vector<char> data(4096, 'x');
+        try
+        {
+            oa.getGroup()->addData(data.size(), &data.front());
+            oa.close();
+        }
+        catch (std::exception &)
+        {
+            threw = true;
+        }
+    }
+
+    // the file is left without its frozen byte
+    Alembic::Ogawa::IArchive ia("archiveCloseFailed.ogawa");
+    TESTING_ASSERT(!ia.isFrozen());
+    setrlimit(RLIMIT_FSIZE, &oldLimit);
+    TESTING_ASSERT(threw);
+#endif
+}
+
 int main ( int argc, char *argv[] )
 {
     test();
     stringStreamTest();
+    closeTest();
     return 0;
 }
\ No newline at end of file
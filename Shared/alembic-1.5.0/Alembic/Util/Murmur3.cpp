@@ -39,12 +39,21 @@
 #include <Alembic/Util/Murmur3.h>
 #include <Alembic/Util/PlainOldDataType.h>
 
+#include <algorithm>
+
 #ifdef __APPLE__
 #include <machine/endian.h>
 #elif !defined(_MSC_VER)
 #include <endian.h>
 #endif
 
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 namespace Alembic {
 namespace Util {
 namespace ALEMBIC_VERSION_NS {
@@ -262,6 +271,136 @@ void MurmurHash3_x64_128 ( const void * key, const size_t len,
     ((uint64_t*)out)[1] = h2;
 }
 
+//-*****************************************************************************
+namespace {
+
+struct ChunkRange
+{
+    const uint8_t * data;
+    size_t len;
+    size_t podSize;
+    size_t firstChunk;
+    size_t lastChunk;
+    uint64_t * digests;
+};
+
+void HashChunks( ChunkRange & iRange )
+{
+    for ( size_t i = iRange.firstChunk; i < iRange.lastChunk; ++i )
+    {
+        size_t start = i * MURMUR3_CHUNK_SIZE;
+        size_t size = std::min( MURMUR3_CHUNK_SIZE, iRange.len - start );
+        MurmurHash3_x64_128( iRange.data + start, size, iRange.podSize,
+                             &iRange.digests[i * 2] );
+    }
+}
+
+#ifdef _MSC_VER
+unsigned __stdcall HashChunksThread( void * iRange )
+#else
+void * HashChunksThread( void * iRange )
+#endif
+{
+    HashChunks( *static_cast< ChunkRange * >( iRange ) );
+    return 0;
+}
+
+size_t GetNumProcessors()
+{
+#ifdef _MSC_VER
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    long numProcs = info.dwNumberOfProcessors;
+#else
+    long numProcs = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+    return numProcs > 1 ? ( size_t ) numProcs : 1;
+}
+
+}
+
+//-*****************************************************************************
+void ChunkedMurmurHash3_x64_128 ( const void * key, const size_t len,
+                                  const size_t podSize, void * out )
+{
+    if ( len <= MURMUR3_CHUNK_SIZE )
+    {
+        MurmurHash3_x64_128( key, len, podSize, out );
+        return;
+    }
+
+    size_t numChunks = ( len + MURMUR3_CHUNK_SIZE - 1 ) / MURMUR3_CHUNK_SIZE;
+    std::vector< uint64_t > digests( numChunks * 2 );
+
+    // only worth a thread if it has a few chunks to get through
+    static const size_t numProcs = GetNumProcessors();
+    size_t numThreads = std::min( numProcs, numChunks / 4 );
+    numThreads = std::max( numThreads, ( size_t ) 1 );
+
+    std::vector< ChunkRange > ranges( numThreads );
+    for ( size_t i = 0; i < numThreads; ++i )
+    {
+        ranges[i].data = ( const uint8_t * ) key;
+        ranges[i].len = len;
+        ranges[i].podSize = podSize;
+        ranges[i].firstChunk = ( numChunks * i ) / numThreads;
+        ranges[i].lastChunk = ( numChunks * ( i + 1 ) ) / numThreads;
+        ranges[i].digests = &digests.front();
+    }
+
+    // this thread does the first range while the others do the rest
+#ifdef _MSC_VER
+    std::vector< HANDLE > threads;
+    for ( size_t i = 1; i < numThreads; ++i )
+    {
+        HANDLE thread = ( HANDLE ) _beginthreadex( NULL, 0, HashChunksThread,
+                                                   &ranges[i], 0, NULL );
+        if ( thread )
+        {
+            threads.push_back( thread );
+        }
+        else
+        {
+            HashChunks( ranges[i] );
+        }
+    }
+
+    HashChunks( ranges[0] );
+
+    for ( size_t i = 0; i < threads.size(); ++i )
+    {
+        WaitForSingleObject( threads[i], INFINITE );
+        CloseHandle( threads[i] );
+    }
+#else
+    std::vector< pthread_t > threads;
+    for ( size_t i = 1; i < numThreads; ++i )
+    {
+        pthread_t thread;
+        if ( pthread_create( &thread, NULL, HashChunksThread,
+                             &ranges[i] ) == 0 )
+        {
+            threads.push_back( thread );
+        }
+        else
+        {
+            HashChunks( ranges[i] );
+        }
+    }
+
+    HashChunks( ranges[0] );
+
+    for ( size_t i = 0; i < threads.size(); ++i )
+    {
+        pthread_join( threads[i], NULL );
+    }
+#endif
+
+    // the digests are native 64 bit words, so they get swapped like them
+    MurmurHash3_x64_128( &digests.front(), digests.size() * sizeof( uint64_t ),
+                         sizeof( uint64_t ), out );
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Util
 } // End namespace Alembic
@@ -47,6 +47,17 @@ namespace ALEMBIC_VERSION_NS {
 void MurmurHash3_x64_128 ( const void * key, const size_t len,
     const size_t podSize, void * out );
 
+//-*****************************************************************************
+// Buffers up to MURMUR3_CHUNK_SIZE bytes get the same hash as
+// MurmurHash3_x64_128. Larger ones are split into chunks of that size which
+// are hashed on as many threads as there are processors, and the chunk
+// hashes are then hashed together.  Since the results end up in archives
+// the chunk size can't change.
+static const size_t MURMUR3_CHUNK_SIZE = 1024 * 1024;
+
+void ChunkedMurmurHash3_x64_128 ( const void * key, const size_t len,
+    const size_t podSize, void * out );
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
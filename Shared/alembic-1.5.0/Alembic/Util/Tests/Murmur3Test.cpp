@@ -0,0 +1,155 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/Murmur3.h>
+#include <Alembic/Util/PlainOldDataType.h>
+#include <Alembic/Util/Foundation.h>
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <iostream>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+using namespace Alembic::Util;
+
+//-*****************************************************************************
+double now()
+{
+#ifdef _MSC_VER
+    return GetTickCount() * 0.001;
+#else
+    timeval tv;
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + tv.tv_usec * 0.000001;
+#endif
+}
+
+//-*****************************************************************************
+bool sameHash( const uint64_t * iA, const uint64_t * iB )
+{
+    return iA[0] == iB[0] && iA[1] == iB[1];
+}
+
+//-*****************************************************************************
+void testChunkedHash()
+{
+    std::vector< uint8_t > data( MURMUR3_CHUNK_SIZE * 5 + 7 );
+    for ( size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = ( uint8_t )( i * 31 + ( i >> 11 ) );
+    }
+
+    uint64_t a[2];
+    uint64_t b[2];
+
+    // up to one chunk both are the same
+    size_t sizes[] = { 0, 1, 15, 16, 1000, MURMUR3_CHUNK_SIZE };
+    for ( size_t i = 0; i < 6; ++i )
+    {
+        MurmurHash3_x64_128( &data.front(), sizes[i], 4, a );
+        ChunkedMurmurHash3_x64_128( &data.front(), sizes[i], 4, b );
+        TESTING_ASSERT( sameHash( a, b ) );
+    }
+
+    // past that they differ, but are still stable
+    MurmurHash3_x64_128( &data.front(), data.size(), 1, a );
+    ChunkedMurmurHash3_x64_128( &data.front(), data.size(), 1, b );
+    TESTING_ASSERT( !sameHash( a, b ) );
+
+    ChunkedMurmurHash3_x64_128( &data.front(), data.size(), 1, a );
+    TESTING_ASSERT( sameHash( a, b ) );
+
+    // and a byte changing in any chunk changes the hash
+    for ( size_t i = 0; i < data.size(); i += MURMUR3_CHUNK_SIZE )
+    {
+        data[i] ^= 1;
+        ChunkedMurmurHash3_x64_128( &data.front(), data.size(), 1, a );
+        TESTING_ASSERT( !sameHash( a, b ) );
+        data[i] ^= 1;
+    }
+
+    data.back() ^= 1;
+    ChunkedMurmurHash3_x64_128( &data.front(), data.size(), 1, a );
+    TESTING_ASSERT( !sameHash( a, b ) );
+}
+
+//-*****************************************************************************
+// reports how fast a large buffer, like the points of a dense mesh, hashes
+void benchmarkHash()
+{
+    std::vector< float32_t > data( 16 * 1024 * 1024 );
+    for ( size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = ( float32_t ) i;
+    }
+
+    size_t numBytes = data.size() * sizeof( float32_t );
+    size_t numReps = 4;
+    uint64_t hash[2];
+
+    double start = now();
+    for ( size_t i = 0; i < numReps; ++i )
+    {
+        MurmurHash3_x64_128( &data.front(), numBytes, 4, hash );
+    }
+    double plainTime = now() - start;
+
+    start = now();
+    for ( size_t i = 0; i < numReps; ++i )
+    {
+        ChunkedMurmurHash3_x64_128( &data.front(), numBytes, 4, hash );
+    }
+    double chunkedTime = now() - start;
+
+    double gigs = ( double ) numBytes * numReps / ( 1024.0 * 1024.0 * 1024.0 );
+    std::cout << "MurmurHash3_x64_128: " << gigs / plainTime << " GB/s"
+              << std::endl;
+    std::cout << "ChunkedMurmurHash3_x64_128: " << gigs / chunkedTime
+              << " GB/s" << std::endl;
+}
+
+//-*****************************************************************************
+int main( int argc, char* argv[] )
+{
+    testChunkedHash();
+    benchmarkHash();
+    return 0;
+}
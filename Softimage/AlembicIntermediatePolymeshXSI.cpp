@@ -119,9 +119,9 @@ void IntermediatePolyMeshXSI::Save(SceneNodePtr eNode,
       normalVec[i] *= transform44f_I_T;
     }
 
-    createIndexedArray<Abc::N3f, SortableV3f>(mFaceIndicesVec, normalVec,
-                                              mIndexedNormals.values,
-                                              mIndexedNormals.indices);
+    createIndexedArray<Abc::N3f>(mFaceIndicesVec, normalVec,
+                                 mIndexedNormals.values,
+                                 mIndexedNormals.indices);
   }
 
   ICEAttribute velocitiesAttr = mesh.GetICEAttributeFromName("PointVelocity");
@@ -199,9 +199,9 @@ void IntermediatePolyMeshXSI::Save(SceneNodePtr eNode,
         if (bEnableLogging) {
           ESS_LOG_WARNING("Extracting UV Data " << uvI);
         }
-        createIndexedArray<Abc::V2f, SortableV2f>(mFaceIndicesVec, uvVec,
-                                                  mIndexedUVSet[uvI].values,
-                                                  mIndexedUVSet[uvI].indices);
+        createIndexedArray<Abc::V2f>(mFaceIndicesVec, uvVec,
+                                     mIndexedUVSet[uvI].values,
+                                     mIndexedUVSet[uvI].indices);
       }
 
       // create the uv options